@@ -251,6 +251,54 @@ def add(cx, cy):
 		raise RuntimeError("add")
 	return out
 
+def _toArray(CT, cs):
+	for c in cs:
+		if not isinstance(c, CT):
+			raise RuntimeError("bad type", c)
+	return (CT * len(cs))(*cs)
+
+# return [add(xs[0], ys[0]), ..., add(xs[n-1], ys[n-1])] computed by cpuN threads (0 means all cores)
+def addVec(xs, ys, cpuN=0):
+	n = len(xs)
+	if n != len(ys):
+		raise RuntimeError("addVec:bad size", n, len(ys))
+	if n == 0:
+		return []
+	CT = type(xs[0])
+	if CT == CipherTextG1:
+		f = lib.sheAddG1VecMT
+	elif CT == CipherTextG2:
+		f = lib.sheAddG2VecMT
+	elif CT == CipherTextGT:
+		f = lib.sheAddGTVecMT
+	else:
+		raise RuntimeError("addVec:bad type", CT)
+	out = (CT * n)()
+	ret = f(out, _toArray(CT, xs), _toArray(CT, ys), c_size_t(n), c_size_t(cpuN))
+	if ret != 0:
+		raise RuntimeError("addVec")
+	return list(out)
+
+# return xs[0] + ... + xs[n-1] computed by cpuN threads (0 means all cores)
+def sumVec(xs, cpuN=0):
+	n = len(xs)
+	if n == 0:
+		raise RuntimeError("sumVec:empty")
+	CT = type(xs[0])
+	if CT == CipherTextG1:
+		f = lib.sheSumG1VecMT
+	elif CT == CipherTextG2:
+		f = lib.sheSumG2VecMT
+	elif CT == CipherTextGT:
+		f = lib.sheSumGTVecMT
+	else:
+		raise RuntimeError("sumVec:bad type", CT)
+	out = CT()
+	ret = f(byref(out.v), _toArray(CT, xs), c_size_t(n), c_size_t(cpuN))
+	if ret != 0:
+		raise RuntimeError("sumVec")
+	return out
+
 def sub(cx, cy):
 	ret = -1
 	if isinstance(cx, CipherTextG1) and isinstance(cy, CipherTextG1):
@@ -389,6 +437,13 @@ if __name__ == '__main__':
 	# mul G1 and G2
 	if sec.dec(mul(c11, c21)) != m11 * m21: print("err8")
 
+	# addVec/sumVec
+	ms = [i * 3 - 7 for i in range(10)]
+	for enc in [pub.encG1, pub.encG2, pub.encGT]:
+		cs = [enc(m) for m in ms]
+		if [sec.dec(c) for c in addVec(cs, cs)] != [m * 2 for m in ms]: print("err-addVec")
+		if sec.dec(sumVec(cs)) != sum(ms): print("err-sumVec")
+
 	if not sec.isZero(pub.encG1(0)): print("err-zero11")
 	if sec.isZero(pub.encG1(3)): print("err-zero12")
 	if not sec.isZero(pub.encG2(0)): print("err-zero21")
@@ -47,7 +47,8 @@ typedef void (*void_ppp)(Unit*, const Unit*, const Unit*);
 typedef void (*void_pp)(Unit*, const Unit*);
 enum CpuType {
 	tAVX_BMI2_ADX = 1<<0,
-	tAVX512_IFMA = 1<<1
+	tAVX512_IFMA = 1<<1,
+	tAVX512F = 1<<2
 };
 extern const uint32_t g_cpuType;
 extern uint32_t initBint();
@@ -426,6 +426,8 @@ MCL_DLL_API int mclBnG1_isValidOrder(const mclBnG1 *x);
 MCL_DLL_API int mclBnG1_hashAndMapTo(mclBnG1 *x, const void *buf, mclSize bufSize);
 // user-defined dst
 MCL_DLL_API int mclBnG1_hashAndMapToWithDst(mclBnG1 *x, const void *buf, mclSize bufSize, const char *dst, mclSize dstSize);
+// x[i] = hashAndMapTo(bufVec[i], bufSizeVec[i]) for i < n (normalized)
+MCL_DLL_API int mclBnG1_hashAndMapToVec(mclBnG1 *x, const void *const *bufVec, const mclSize *bufSizeVec, mclSize n);
 // set default dst
 MCL_DLL_API int mclBnG1_setDst(const char *dst, mclSize dstSize);
 
@@ -439,6 +441,7 @@ MCL_DLL_API void mclBnG1_mul(mclBnG1 *z, const mclBnG1 *x, const mclBnFr *y);
 
 /*
 	constant time mul
+	use a precomputed table if x is the base point of a G1-only curve
 */
 MCL_DLL_API void mclBnG1_mulCT(mclBnG1 *z, const mclBnG1 *x, const mclBnFr *y);
 
@@ -456,6 +459,8 @@ MCL_DLL_API int mclBnG2_isValidOrder(const mclBnG2 *x);
 MCL_DLL_API int mclBnG2_hashAndMapTo(mclBnG2 *x, const void *buf, mclSize bufSize);
 // user-defined dst
 MCL_DLL_API int mclBnG2_hashAndMapToWithDst(mclBnG2 *x, const void *buf, mclSize bufSize, const char *dst, mclSize dstSize);
+// x[i] = hashAndMapTo(bufVec[i], bufSizeVec[i]) for i < n (normalized)
+MCL_DLL_API int mclBnG2_hashAndMapToVec(mclBnG2 *x, const void *const *bufVec, const mclSize *bufSizeVec, mclSize n);
 // set default dst
 MCL_DLL_API int mclBnG2_setDst(const char *dst, mclSize dstSize);
 
@@ -521,6 +526,18 @@ MCL_DLL_API void mclBnG1_mulEach(mclBnG1 *x, const mclBnFr *y, mclSize n);
 MCL_DLL_API mclSize mclBnFr_invVec(mclBnFr *y, const mclBnFr *x, mclSize n);
 MCL_DLL_API mclSize mclBnFp_invVec(mclBnFp *y, const mclBnFp *x, mclSize n);
 
+// element-wise operations for i < n (AVX-512 is used if available)
+// z[i] = x[i] + y[i]
+MCL_DLL_API void mclBnFr_addVec(mclBnFr *z, const mclBnFr *x, const mclBnFr *y, mclSize n);
+// z[i] = x[i] - y[i]
+MCL_DLL_API void mclBnFr_subVec(mclBnFr *z, const mclBnFr *x, const mclBnFr *y, mclSize n);
+// z[i] = x[i] * y[i]
+MCL_DLL_API void mclBnFr_mulVec(mclBnFr *z, const mclBnFr *x, const mclBnFr *y, mclSize n);
+// z[i] = x[i] * y
+MCL_DLL_API void mclBnFr_mulScalarVec(mclBnFr *z, const mclBnFr *x, const mclBnFr *y, mclSize n);
+// z[i] = x[i] * y[i] + w[i]
+MCL_DLL_API void mclBnFr_fmaVec(mclBnFr *z, const mclBnFr *x, const mclBnFr *y, const mclBnFr *w, mclSize n);
+
 // y[i] = normalize(x[i]) : [X:Y:Z] -> [x:y:1] or 0 where (x, y) is Affine coordinate
 MCL_DLL_API void mclBnG1_normalizeVec(mclBnG1 *y, const mclBnG1 *x, mclSize n);
 MCL_DLL_API void mclBnG2_normalizeVec(mclBnG2 *y, const mclBnG2 *x, mclSize n);
@@ -76,6 +76,16 @@ MCL_DLL_API void hashAndMapToG1(G1& P, const void *buf, size_t bufSize);
 MCL_DLL_API void hashAndMapToG2(G2& P, const void *buf, size_t bufSize);
 MCL_DLL_API void hashAndMapToG1(G1& P, const void *buf, size_t bufSize, const char *dst, size_t dstSize);
 MCL_DLL_API void hashAndMapToG2(G2& P, const void *buf, size_t bufSize, const char *dst, size_t dstSize);
+/*
+	P[i] = hashAndMapToG1(msgVec[i], msgSizeVec[i]) for i < n and normalize P
+	the square roots and the inversions are computed at once in MCL_MAP_TO_MODE_HASH_TO_CURVE
+*/
+MCL_DLL_API void hashAndMapToG1Vec(G1 *P, const void *const *msgVec, const size_t *msgSizeVec, size_t n);
+MCL_DLL_API void hashAndMapToG2Vec(G2 *P, const void *const *msgVec, const size_t *msgSizeVec, size_t n);
+// multi thread version of hashAndMapToG1Vec/hashAndMapToG2Vec
+// the num of thread is automatically detected if cpuN = 0
+MCL_DLL_API void hashAndMapToG1VecMT(G1 *P, const void *const *msgVec, const size_t *msgSizeVec, size_t n, size_t cpuN = 0);
+MCL_DLL_API void hashAndMapToG2VecMT(G2 *P, const void *const *msgVec, const size_t *msgSizeVec, size_t n, size_t cpuN = 0);
 // set the default dst for G1
 // return 0 if success else -1
 MCL_DLL_API bool setDstG1(const char *dst, size_t dstSize);
@@ -108,6 +118,11 @@ MCL_DLL_API void initG1only(bool *pb, const mcl::EcParam& para);
 
 MCL_DLL_API const G1& getG1basePoint();
 
+/*
+	Q = getG1basePoint() * y in constant time with the table made by initG1only
+*/
+MCL_DLL_API void mulG1basePointCT(G1& Q, const Fr& y);
+
 /*
 	check x in Fp12 is in GT.
 	return true if x^r = 1
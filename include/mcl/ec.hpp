@@ -11,6 +11,7 @@
 #include <mcl/fr_def.hpp>
 #include <mcl/ecparam.hpp>
 #include <mcl/window_method.hpp>
+#include <cybozu/endian.hpp>
 
 #ifdef _MSC_VER
 	#pragma warning(push)
@@ -174,6 +175,35 @@ void normalizeVecT(Eout& Q, Ein& P, size_t n, size_t N = 256)
 	}
 }
 
+/*
+	non-cryptographic 64-bit checksum of buf[0, n) for the raw bulk format
+	4 independent lanes of 64-bit words are merged at the end
+*/
+inline uint64_t rawChecksum(const void *buf, size_t n)
+{
+	const uint64_t p1 = 0x9e3779b185ebca87ull;
+	const uint64_t p2 = 0xc2b2ae3d27d4eb4full;
+	const uint8_t *src = (const uint8_t*)buf;
+	uint64_t h[4] = { p1, p2, ~p1, ~p2 };
+	size_t pos = 0;
+	for (; pos + 32 <= n; pos += 32) {
+		for (size_t j = 0; j < 4; j++) {
+			uint64_t w;
+			memcpy(&w, src + pos + j * 8, 8);
+			h[j] += w * p2;
+			h[j] = ((h[j] << 31) | (h[j] >> 33)) * p1;
+		}
+	}
+	uint64_t r = uint64_t(n);
+	for (size_t j = 0; j < 4; j++) {
+		r = ((r ^ h[j]) * p1) + p2;
+	}
+	for (; pos < n; pos++) {
+		r = (r ^ src[pos]) * p1;
+	}
+	return r ^ (r >> 29);
+}
+
 } // mcl::ec::local
 
 // [X:Y:Z] as Proj = (X/Z, Y/Z) as Affine = [XZ:YZ^2:Z] as Jacobi
@@ -567,6 +597,97 @@ void dblCTProj(E& R, const E& P)
 	F::add(R.x, R.x, R.x);
 }
 
+namespace local {
+
+// z = (mask == -1) ? x : y
+template<class T>
+void selectCT(T& z, const T& x, const T& y, Unit mask)
+{
+	const size_t N = sizeof(T) / sizeof(Unit);
+	Unit *pz = (Unit*)&z;
+	const Unit *px = (const Unit*)&x;
+	const Unit *py = (const Unit*)&y;
+	for (size_t i = 0; i < N; i++) {
+		pz[i] = (px[i] & mask) | (py[i] & ~mask);
+	}
+}
+
+// Unit(-1) if x == 0 else 0
+inline Unit isZeroMask(Unit x)
+{
+	return Unit(0) - (Unit(~x & (x - 1)) >> (sizeof(Unit) * 8 - 1));
+}
+
+} // mcl::ec::local
+
+/*
+	z = y * P with the table of SignedWindowMethod
+	tbl[i * h + j - 1] = j 2^(winSize i) P (affine) for 1 <= j <= h = 2^(winSize - 1)
+	the sequence of operations and memory accesses does not depend on y
+	- signed digits are recoded without branches
+	- each digit reads x and y of the whole row of the table with masks
+	- a zero digit reads the first entry and discards the sum, so t is never zero
+	- additions use the complete formula addCTProj
+	y must be less than 2^bitSize
+*/
+template<class E>
+void mulSignedWindowCT(E& z, const E *tbl, size_t bitSize, size_t winSize, const Unit *y, size_t n)
+{
+	typedef typename E::Fp F;
+	if (!E::a_.isZero() || E::mode_ == ec::Affine) {
+		E::mulArray(z, tbl[0], y, n, false, true);
+		return;
+	}
+	const size_t N = F::getOp().N;
+	const size_t h = size_t(1) << (winSize - 1);
+	const Unit mask = (Unit(1) << winSize) - 1;
+	const size_t tblNum = bitSize / winSize + 1;
+	E t, u;
+	// zero in projective coordinates
+	z.x.clear();
+	z.y = 1;
+	z.z.clear();
+	t.x.clear();
+	t.y.clear();
+	t.z = 1;
+	Unit *tx = (Unit*)&t.x;
+	Unit *ty = (Unit*)&t.y;
+	Unit carry = 0;
+	for (size_t i = 0; i < tblNum; i++) {
+		Unit v = (fp::getUnitAt(y, n, i * winSize) & mask) + carry;
+		// d = (v > h) ? v - 2h : v
+		const Unit negMask = Unit(0) - (Unit(h - v) >> (sizeof(Unit) * 8 - 1));
+		v ^= (v ^ Unit((h << 1) - v)) & negMask;
+		carry = negMask & 1;
+		const Unit zeroMask = local::isZeroMask(v);
+		// vs = max(v, 1) ; F::neg may branch on zero
+		const Unit vs = v | (zeroMask & 1);
+		// (t.x, t.y) = tbl[i * h + vs - 1] ; z of the table is 1
+		for (size_t k = 0; k < N; k++) {
+			tx[k] = 0;
+			ty[k] = 0;
+		}
+		const E *w = &tbl[i * h];
+		for (size_t j = 0; j < h; j++) {
+			const Unit m = local::isZeroMask(Unit(j + 1) ^ vs);
+			const Unit *wx = (const Unit*)&w[j].x;
+			const Unit *wy = (const Unit*)&w[j].y;
+			for (size_t k = 0; k < N; k++) {
+				tx[k] |= wx[k] & m;
+				ty[k] |= wy[k] & m;
+			}
+		}
+		F::neg(u.y, t.y);
+		local::selectCT(t.y, u.y, t.y, negMask);
+		addCTProj(u, z, t, true);
+		// keep z if v = 0
+		local::selectCT(z, z, u, zeroMask);
+	}
+	if (E::mode_ == ec::Jacobi) {
+		ProjToJacobi(z, z);
+	}
+}
+
 template<class E>
 void normalizeProj(E& P)
 {
@@ -853,6 +974,181 @@ void addAffine(E& R, const E& P, const E& Q)
 	R.x = x3;
 }
 
+/*
+	R[i] = P[i] + Q[i] for i = 0, ..., n-1
+	P[i] and Q[i] must be normalized (z = 1 or zero)
+	the denominators of the slopes share one inversion per N points
+	R may be equal to P or Q
+*/
+template<class E>
+void addAffineVec(E *R, const E *P, const E *Q, size_t n)
+{
+	typedef typename E::Fp F;
+	const size_t N = 256;
+	F *d = (F*)CYBOZU_ALLOCA(sizeof(F) * N);
+	while (n > 0) {
+		const size_t m = n < N ? n : N;
+		for (size_t i = 0; i < m; i++) {
+			const E& A = P[i];
+			const E& B = Q[i];
+			if (A.isZero() || B.isZero()) {
+				d[i].clear();
+				continue;
+			}
+			F::sub(d[i], B.x, A.x);
+			if (!d[i].isZero()) continue;
+			if (A.y == B.y) F::add(d[i], A.y, A.y); // dbl (zero if A.y = 0)
+		}
+		invVec(d, d, m);
+		for (size_t i = 0; i < m; i++) {
+			const E& A = P[i];
+			const E& B = Q[i];
+			if (A.isZero()) { R[i] = B; continue; }
+			if (B.isZero()) { R[i] = A; continue; }
+			if (d[i].isZero()) { R[i].clear(); continue; }
+			F t, s;
+			if (A.x == B.x) {
+				F::sqr(t, A.x);
+				F::add(s, t, t);
+				t += s;
+				t += E::a_;
+			} else {
+				F::sub(t, B.y, A.y);
+			}
+			t *= d[i];
+			F x3;
+			F::sqr(x3, t);
+			x3 -= A.x;
+			x3 -= B.x;
+			F::sub(s, A.x, x3);
+			s *= t;
+			F::sub(R[i].y, s, A.y);
+			R[i].x = x3;
+			R[i].z = 1;
+		}
+		R += m;
+		P += m;
+		Q += m;
+		n -= m;
+	}
+}
+
+/*
+	R[i] = P[i] + Q[i] and S[i] = P[i] - Q[i] for i = 0, ..., n-1
+	P[i] and Q[i] must be normalized
+	the two slopes have the same denominator Q.x - P.x (or 2P.y for dbl)
+	R, S may be equal to P or Q
+*/
+template<class E>
+void addSubAffineVec(E *R, E *S, const E *P, const E *Q, size_t n)
+{
+	typedef typename E::Fp F;
+	const size_t N = 256;
+	F *d = (F*)CYBOZU_ALLOCA(sizeof(F) * N);
+	while (n > 0) {
+		const size_t m = n < N ? n : N;
+		for (size_t i = 0; i < m; i++) {
+			const E& A = P[i];
+			const E& B = Q[i];
+			if (A.isZero() || B.isZero()) {
+				d[i].clear();
+				continue;
+			}
+			F::sub(d[i], B.x, A.x);
+			if (d[i].isZero()) F::add(d[i], A.y, A.y); // dbl (zero if A.y = 0)
+		}
+		invVec(d, d, m);
+		for (size_t i = 0; i < m; i++) {
+			const E A = P[i];
+			const E B = Q[i];
+			if (A.isZero()) {
+				R[i] = B;
+				E::neg(S[i], B);
+				continue;
+			}
+			if (B.isZero()) {
+				R[i] = A;
+				S[i] = A;
+				continue;
+			}
+			if (d[i].isZero()) {
+				R[i].clear();
+				S[i].clear();
+				continue;
+			}
+			F t, s, x3;
+			if (A.x == B.x) {
+				// one of A + B and A - B is dbl(A) and the other is zero
+				E& D = (A.y == B.y) ? R[i] : S[i];
+				E& Z = (A.y == B.y) ? S[i] : R[i];
+				F::sqr(t, A.x);
+				F::add(s, t, t);
+				t += s;
+				t += E::a_;
+				t *= d[i];
+				F::sqr(x3, t);
+				x3 -= A.x;
+				x3 -= A.x;
+				F::sub(s, A.x, x3);
+				s *= t;
+				F::sub(D.y, s, A.y);
+				D.x = x3;
+				D.z = 1;
+				Z.clear();
+				continue;
+			}
+			// A + B
+			F::sub(t, B.y, A.y);
+			t *= d[i];
+			F::sqr(x3, t);
+			x3 -= A.x;
+			x3 -= B.x;
+			F::sub(s, A.x, x3);
+			s *= t;
+			F::sub(R[i].y, s, A.y);
+			R[i].x = x3;
+			R[i].z = 1;
+			// A - B = A + (B.x, -B.y)
+			F::add(t, B.y, A.y);
+			F::neg(t, t);
+			t *= d[i];
+			F::sqr(x3, t);
+			x3 -= A.x;
+			x3 -= B.x;
+			F::sub(s, A.x, x3);
+			s *= t;
+			F::sub(S[i].y, s, A.y);
+			S[i].x = x3;
+			S[i].z = 1;
+		}
+		R += m;
+		S += m;
+		P += m;
+		Q += m;
+		n -= m;
+	}
+}
+
+/*
+	z = x[0] + ... + x[n-1] by the pairwise addition in affine coordinates
+	x[i] must be normalized and x[] is destroyed
+	each level halves n with one addAffineVec
+*/
+template<class E>
+void sumAffineVec(E& z, E *x, size_t n)
+{
+	if (n == 0) {
+		z.clear();
+		return;
+	}
+	while (n > 1) {
+		const size_t h = n / 2;
+		addAffineVec(x, x, x + (n - h), h);
+		n -= h;
+	}
+	z = x[0];
+}
+
 template<class E>
 void tryAndIncMapTo(E& P, const typename E::Fp& t)
 {
@@ -1604,6 +1900,236 @@ public:
 		}
 		return true;
 	}
+	/*
+		P[i].deserialize(buf + i * getSerializedByteSize(), ..., IoSerialize) for i < n
+		the square roots of the compressed points are computed by Fp::squareRootVec
+		return n * getSerializedByteSize() if success else 0
+	*/
+	static size_t deserializeVec(EcT *P, size_t n, const void *buf, size_t bufSize)
+	{
+		const size_t n1 = getSerializedByteSize();
+		if (bufSize < n * n1) return 0;
+		const size_t fpN = Fp::getByteSize();
+		const size_t adj = isMSBserialize() ? 0 : 1;
+		const bool isETH = Fp::BaseFp::getETHserialization();
+		const uint8_t *src = (const uint8_t*)buf;
+		const size_t blockN = 64;
+		for (size_t i = 0; i < n; i += blockN) {
+			const size_t m = fp::min_(blockN, n - i);
+			Fp y[blockN];
+			bool sign[blockN];
+			bool isInf[blockN];
+			bool ok[blockN];
+			for (size_t k = 0; k < m; k++) {
+				EcT& Q = P[i + k];
+				uint8_t t[sizeof(Fp) + 1];
+				bool b;
+				memcpy(t, src + (i + k) * n1, n1);
+				isInf[k] = false;
+				if (isETH) {
+					const uint8_t c_flag = 0x80;
+					const uint8_t b_flag = 0x40;
+					const uint8_t a_flag = 0x20;
+					if ((t[0] & c_flag) == 0) return 0;
+					if (t[0] & b_flag) {
+						if (t[0] != (c_flag | b_flag)) return 0;
+						for (size_t j = 1; j < fpN - 1; j++) {
+							if (t[j]) return 0;
+						}
+						isInf[k] = true;
+						y[k].clear();
+						continue;
+					}
+					sign[k] = (t[0] & a_flag) != 0;
+					t[0] &= ~(c_flag | b_flag | a_flag);
+					mcl::fp::local::byteSwap(t, fpN);
+					Q.x.setArray(&b, t, fpN);
+				} else {
+					if (bint::isZeroN(t, n1)) {
+						isInf[k] = true;
+						y[k].clear();
+						continue;
+					}
+					if (adj) {
+						if (t[0] != 2 && t[0] != 3) return 0;
+						sign[k] = t[0] == 3;
+					} else {
+						sign[k] = (t[fpN - 1] >> 7) != 0;
+						t[fpN - 1] &= 0x7f;
+					}
+					Q.x.setArray(&b, t + adj, fpN);
+				}
+				if (!b) return 0;
+				getWeierstrass(y[k], Q.x);
+			}
+			Fp::squareRootVec(y, y, m, ok);
+			for (size_t k = 0; k < m; k++) {
+				EcT& Q = P[i + k];
+				if (isInf[k]) {
+					Q.clear();
+					continue;
+				}
+				if (!ok[k]) return 0;
+				const bool neg = isETH ? ec::local::get_a_flag(y[k]) : y[k].isOdd();
+				if (neg ^ sign[k]) {
+					Fp::neg(Q.y, y[k]);
+				} else {
+					Q.y = y[k];
+				}
+				Q.z = 1;
+				if (verifyOrder_ && !Q.isValidOrder()) return 0;
+			}
+		}
+		return n * n1;
+	}
+	/*
+		raw bulk format of points for data generated by this library (e.g. a trusted setup)
+		header (64 bytes) | x[0] | y[0] | x[1] | y[1] | ...
+		x[i], y[i] : the affine coordinates as the native limbs of Fp (Montgomery form if used)
+		the point at infinity is (0, 0)
+		header (little endian)
+		[0, 4) "MCLR", [4, 8) version, [8, 16) n, [16, 20) sizeof(Fp), [20, 24) sizeof(Unit)
+		[24, 32) checksum of the points, [32, 64) SHA-256 of (p, a, b) in the native limbs
+	*/
+	static const size_t rawVecHeaderSize = 64;
+	static size_t getRawVecByteSize(size_t n)
+	{
+		return rawVecHeaderSize + n * sizeof(Fp) * 2;
+	}
+	/*
+		write P[0, n) to buf in the raw bulk format
+		return getRawVecByteSize(n) if success else 0
+	*/
+	static size_t serializeRawVec(void *buf, size_t maxBufSize, const EcT *P, size_t n)
+	{
+		const size_t totalSize = getRawVecByteSize(n);
+		if (maxBufSize < totalSize) return 0;
+		uint8_t *dst = (uint8_t*)buf + rawVecHeaderSize;
+		const size_t blockN = 64;
+		EcT Q[blockN];
+		for (size_t i = 0; i < n; i += blockN) {
+			const size_t m = fp::min_(blockN, n - i);
+			normalizeVec(Q, P + i, m);
+			for (size_t k = 0; k < m; k++) {
+				if (Q[k].isZero()) {
+					memset(dst, 0, sizeof(Fp) * 2);
+				} else {
+					memcpy(dst, &Q[k].x, sizeof(Fp));
+					memcpy(dst + sizeof(Fp), &Q[k].y, sizeof(Fp));
+				}
+				dst += sizeof(Fp) * 2;
+			}
+		}
+		setRawVecHeader((uint8_t*)buf, n);
+		return totalSize;
+	}
+	/*
+		get the number of points in buf of the raw bulk format
+		return 0 if the header is wrong or it is made for other parameters
+	*/
+	static size_t getRawVecN(const void *buf, size_t bufSize)
+	{
+		size_t n;
+		return readRawVecHeader(&n, buf, bufSize) ? n : 0;
+	}
+	/*
+		set P[0, n) by buf in the raw bulk format (n must be getRawVecN(buf, bufSize))
+		the points are validated (on the curve and in the subgroup) if verify
+		return getRawVecByteSize(n) if success else 0
+	*/
+	static size_t deserializeRawVec(EcT *P, size_t n, const void *buf, size_t bufSize, bool verify = false)
+	{
+		if (!checkRawVec(n, buf, bufSize)) return 0;
+		if (!loadRawVec(P, n, (const uint8_t*)buf + rawVecHeaderSize, verify)) return 0;
+		return getRawVecByteSize(n);
+	}
+	// multi thread version of deserializeRawVec
+	static size_t deserializeRawVecMT(EcT *P, size_t n, const void *buf, size_t bufSize, bool verify = false, size_t cpuN = 0)
+	{
+#ifdef MCL_USE_OMP
+		if (!checkRawVec(n, buf, bufSize)) return 0;
+		const size_t minN = 1024;
+		if (cpuN == 0) {
+			cpuN = omp_get_num_procs();
+			if (n < minN * cpuN) {
+				cpuN = (n + minN - 1) / minN;
+			}
+		}
+		if (cpuN <= 1) {
+			if (!loadRawVec(P, n, (const uint8_t*)buf + rawVecHeaderSize, verify)) return 0;
+			return getRawVecByteSize(n);
+		}
+		const uint8_t *src = (const uint8_t*)buf + rawVecHeaderSize;
+		const size_t q = n / cpuN;
+		const size_t r = n % cpuN;
+		int ok = 1;
+		#pragma omp parallel for reduction(&:ok)
+		for (size_t i = 0; i < cpuN; i++) {
+			const size_t adj = q * i + fp::min_(i, r);
+			ok &= loadRawVec(P + adj, q + (i < r), src + adj * sizeof(Fp) * 2, verify);
+		}
+		return ok ? getRawVecByteSize(n) : 0;
+#else
+		(void)cpuN;
+		return deserializeRawVec(P, n, buf, bufSize, verify);
+#endif
+	}
+private:
+	static void setRawVecHeader(uint8_t *buf, size_t n)
+	{
+		memcpy(buf, "MCLR", 4);
+		cybozu::Set32bitAsLE(buf + 4, 1); // version
+		cybozu::Set64bitAsLE(buf + 8, n);
+		cybozu::Set32bitAsLE(buf + 16, uint32_t(sizeof(Fp)));
+		cybozu::Set32bitAsLE(buf + 20, uint32_t(sizeof(Unit)));
+		cybozu::Set64bitAsLE(buf + 24, ec::local::rawChecksum(buf + rawVecHeaderSize, n * sizeof(Fp) * 2));
+		const fp::Op& op = Fp::BaseFp::getOp();
+		uint8_t param[sizeof(Unit) * maxUnitSize + sizeof(Fp) * 2];
+		const size_t pSize = sizeof(Unit) * op.N;
+		memcpy(param, op.p, pSize);
+		memcpy(param + pSize, &a_, sizeof(Fp));
+		memcpy(param + pSize + sizeof(Fp), &b_, sizeof(Fp));
+		fp::sha256(buf + 32, 32, param, uint32_t(pSize + sizeof(Fp) * 2));
+	}
+	static bool readRawVecHeader(size_t *pn, const void *buf, size_t bufSize)
+	{
+		if (bufSize < rawVecHeaderSize) return false;
+		const uint8_t *src = (const uint8_t*)buf;
+		uint8_t expect[rawVecHeaderSize];
+		setRawVecHeader(expect, 0);
+		// compare except for n and checksum
+		if (memcmp(src, expect, 8) != 0) return false;
+		if (memcmp(src + 16, expect + 16, 8) != 0) return false;
+		if (memcmp(src + 32, expect + 32, 32) != 0) return false;
+		const uint64_t n = cybozu::Get64bitAsLE(src + 8);
+		if (n > (bufSize - rawVecHeaderSize) / (sizeof(Fp) * 2)) return false;
+		*pn = size_t(n);
+		return true;
+	}
+	static bool checkRawVec(size_t n, const void *buf, size_t bufSize)
+	{
+		size_t n2;
+		if (!readRawVecHeader(&n2, buf, bufSize) || n2 != n) return false;
+		const uint8_t *src = (const uint8_t*)buf;
+		return cybozu::Get64bitAsLE(src + 24) == ec::local::rawChecksum(src + rawVecHeaderSize, n * sizeof(Fp) * 2);
+	}
+	static bool loadRawVec(EcT *P, size_t n, const uint8_t *src, bool verify)
+	{
+		for (size_t i = 0; i < n; i++) {
+			EcT& Q = P[i];
+			memcpy((void*)&Q.x, src, sizeof(Fp));
+			memcpy((void*)&Q.y, src + sizeof(Fp), sizeof(Fp));
+			src += sizeof(Fp) * 2;
+			if (Q.x.isZero() && Q.y.isZero()) {
+				Q.clear();
+				continue;
+			}
+			Q.z = 1;
+			if (verify && !(Q.isValidAffine() && Q.isValidOrder())) return false;
+		}
+		return true;
+	}
+public:
 	inline friend EcT operator+(const EcT& x, const EcT& y) { EcT z; add(z, x, y); return z; }
 	inline friend EcT operator-(const EcT& x, const EcT& y) { EcT z; sub(z, x, y); return z; }
 	template<class INT>
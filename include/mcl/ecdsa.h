@@ -95,6 +95,12 @@ ECDSA_DLL_API int ecdsaSecretKeySetByCSPRNG(ecdsaSecretKey *sec);
 ECDSA_DLL_API void ecdsaGetPublicKey(ecdsaPublicKey *pub, const ecdsaSecretKey *sec);
 
 ECDSA_DLL_API void ecdsaSign(ecdsaSignature *sig, const ecdsaSecretKey *sec, const void *m, mclSize size);
+/*
+	ecdsaSign and set the recovery id of sig to recId
+	bit 0 : y of R is odd
+	bit 1 : x of R is r + (the order)
+*/
+ECDSA_DLL_API void ecdsaSignWithRecId(ecdsaSignature *sig, uint8_t *recId, const ecdsaSecretKey *sec, const void *m, mclSize size);
 
 // normalize sig to lower S (r, s) such that s < half
 ECDSA_DLL_API void ecdsaNormalizeSignature(ecdsaSignature *sig);
@@ -103,6 +109,25 @@ ECDSA_DLL_API void ecdsaNormalizeSignature(ecdsaSignature *sig);
 // accept only lower S signature
 ECDSA_DLL_API int ecdsaVerify(const ecdsaSignature *sig, const ecdsaPublicKey *pub, const void *m, mclSize size);
 ECDSA_DLL_API int ecdsaVerifyPrecomputed(const ecdsaSignature *sig, const ecdsaPrecomputedPublicKey *pub, const void *m, mclSize size);
+/*
+	verify n signatures sigVec[i] of msgVec[i] by pubVec[i] at once
+	recIdVec[i] : recovery id of sigVec[i] given by ecdsaSignWithRecId
+	okVec[i] (if not NULL) : 1 if sigVec[i] is valid else 0
+	return 1 if all signatures are valid
+*/
+ECDSA_DLL_API int ecdsaVerifyBatch(const ecdsaSignature *sigVec, const uint8_t *recIdVec, const ecdsaPublicKey *pubVec, const void *const *msgVec, const mclSize *msgSizeVec, mclSize n, int *okVec);
+
+/*
+	recover the public key from sig of m and recId given by ecdsaSignWithRecId
+	return 0 if success
+*/
+ECDSA_DLL_API int ecdsaRecoverPublicKey(ecdsaPublicKey *pub, const ecdsaSignature *sig, uint8_t recId, const void *m, mclSize size);
+/*
+	ecdsaRecoverPublicKey for pubVec[i], sigVec[i], recIdVec[i], msgVec[i] (i < n) at once
+	okVec[i] (if not NULL) : 1 if pubVec[i] is recovered else 0
+	return 0 if all public keys are recovered
+*/
+ECDSA_DLL_API int ecdsaRecoverPublicKeyVec(ecdsaPublicKey *pubVec, const ecdsaSignature *sigVec, const uint8_t *recIdVec, const void *const *msgVec, const mclSize *msgSizeVec, mclSize n, int *okVec);
 
 // return nonzero if success
 ECDSA_DLL_API ecdsaPrecomputedPublicKey *ecdsaPrecomputedPublicKeyCreate();
@@ -23,6 +23,8 @@ namespace local {
 	#define MCLSHE_WIN_SIZE 10
 #endif
 static const size_t winSize = MCLSHE_WIN_SIZE;
+// for mulCT of secret values ; the cost of the masked scan is linear in 2^ctWinSize
+static const size_t ctWinSize = 5;
 
 } // mcl::ecdsa::local
 
@@ -34,7 +36,8 @@ namespace local {
 
 struct Param {
 	Ec P;
-	mcl::fp::WindowMethod<Ec> Pbase;
+	mcl::fp::SignedWindowMethod<Ec> Pbase;
+	mcl::fp::SignedWindowMethod<Ec> PbaseCT;
 	size_t bitSize;
 	int serializeMode;
 };
@@ -58,6 +61,52 @@ inline void FpToZn(Zn& y, const Fp& x)
 	(void)ret;
 }
 
+/*
+	y = x (n < p)
+*/
+inline void ZnToFp(Fp& y, const Zn& x)
+{
+	fp::Block b;
+	x.getBlock(b);
+	bool ret;
+	y.setArray(&ret, b.p, b.n);
+	assert(ret);
+	(void)ret;
+}
+
+/*
+	x = r + n if over else r
+	return false if r + n >= p
+*/
+inline bool getXofR(Fp& x, const Zn& r, bool over)
+{
+	if (!over) {
+		ZnToFp(x, r);
+		return true;
+	}
+	mpz_class v;
+	bool b;
+	r.getMpz(&b, v);
+	if (!b) return false;
+	v += Zn::getOp().mp;
+	if (v >= Fp::getOp().mp) return false;
+	x.setMpz(&b, v);
+	return b;
+}
+
+/*
+	R is normalized and r = x(R) mod n
+	R is replaced with -R if neg
+*/
+inline uint8_t getRecId(const Ec& R, const Zn& r, bool neg)
+{
+	Fp x;
+	ZnToFp(x, r);
+	uint8_t recId = R.y.isOdd() ^ neg;
+	if (x != R.x) recId |= 2;
+	return recId;
+}
+
 inline void setHashOf(Zn& x, const void *msg, size_t msgSize)
 {
 	const size_t mdSize = 32;
@@ -120,6 +169,9 @@ inline void init(bool *pb)
 	if (!*pb) return;
 	p.bitSize = 256;
 	p.Pbase.init(pb, p.P, p.bitSize, local::winSize);
+	if (!*pb) return;
+	p.PbaseCT.init(pb, p.P, p.bitSize, local::ctWinSize);
+	if (!*pb) return;
 	// isValid() checks the order
 	Ec::setOrder(Zn::getOp().mp);
 	Fp::setETHserialization(true);
@@ -263,7 +315,7 @@ struct PrecomputedPublicKey {
 
 inline void getPublicKey(PublicKey& pub, const SecretKey& sec)
 {
-	Ec::mul(pub, param.P, sec);
+	param.PbaseCT.mulCT(pub, sec);
 	pub.normalize();
 }
 
@@ -388,7 +440,12 @@ inline void normalizeSignature(Signature& sig)
 	}
 }
 
-inline void sign(Signature& sig, const SecretKey& sec, const void *msg, size_t msgSize)
+/*
+	recId (if not null) is set to the recovery id of sig
+	bit 0 : y of R = k P is odd
+	bit 1 : x of R is r + n
+*/
+inline void sign(Signature& sig, const SecretKey& sec, const void *msg, size_t msgSize, uint8_t *recId = 0)
 {
 	Zn& r = sig.r;
 	Zn& s = sig.s;
@@ -399,7 +456,7 @@ inline void sign(Signature& sig, const SecretKey& sec, const void *msg, size_t m
 		bool b;
 		k.setByCSPRNG(&b);
 		(void)b;
-		param.Pbase.mul(Q, k);
+		param.PbaseCT.mulCT(Q, k);
 		if (Q.isZero()) continue;
 		Q.normalize();
 		local::FpToZn(r, Q.x);
@@ -407,7 +464,11 @@ inline void sign(Signature& sig, const SecretKey& sec, const void *msg, size_t m
 		Zn::mul(s, r, sec);
 		s += z;
 		if (s.isZero()) continue;
-		s /= k;
+		Zn::invCT(k, k);
+		s *= k;
+		if (recId) {
+			*recId = local::getRecId(Q, r, s.isNegative());
+		}
 		normalizeSignature(sig);
 		return;
 	}
@@ -415,14 +476,54 @@ inline void sign(Signature& sig, const SecretKey& sec, const void *msg, size_t m
 
 namespace local {
 
-inline void mulDispatch(Ec& Q, const PublicKey& pub, const Zn& y)
+/*
+	Q = u1 P + u2 pub
+	u1 P by the fixed-base table needs no doubling,
+	so interleaving it with u2 pub (Strauss-Shamir) does not reduce the cost.
+	u2 pub uses GLV of secp256k1 in Ec::mul.
+*/
+inline void mul2(Ec& Q, const Zn& u1, const Ec& pub, const Zn& u2)
+{
+	Ec T;
+	param.Pbase.mul(Q, u1);
+	Ec::mul(T, pub, u2);
+	Q += T;
+}
+
+inline void mul2(Ec& Q, const Zn& u1, const PrecomputedPublicKey& ppub, const Zn& u2)
 {
-	Ec::mul(Q, pub, y);
+	Ec T;
+	param.Pbase.mul(Q, u1);
+	ppub.pubBase_.mul(T, u2);
+	Q += T;
 }
 
-inline void mulDispatch(Ec& Q, const PrecomputedPublicKey& ppub, const Zn& y)
+/*
+	return (x-coordinate of Q) mod n == r without normalizing Q (Q != 0)
+	x = X / Z^2 (Jacobi), X / Z (Proj)
+	x mod n == r <=> x == r or x == r + n (if r + n < p) because n < p < 2n
+*/
+inline bool isEqualX(const Ec& Q, const Zn& r)
 {
-	ppub.pubBase_.mul(Q, y);
+	Fp z;
+	switch (Ec::getMode()) {
+	case ec::Jacobi:
+		Fp::sqr(z, Q.z);
+		break;
+	case ec::Proj:
+		z = Q.z;
+		break;
+	default:
+		z = 1;
+		break;
+	}
+	Fp x, t;
+	ZnToFp(x, r);
+	Fp::mul(t, x, z);
+	if (t == Q.x) return true;
+	if (!getXofR(x, r, true)) return false;
+	Fp::mul(t, x, z);
+	return t == Q.x;
 }
 
 // accept only lower S signature
@@ -438,16 +539,10 @@ inline bool verify(const Signature& sig, const Pub& pub, const void *msg, size_t
 	Zn::inv(w, s);
 	Zn::mul(u1, z, w);
 	Zn::mul(u2, r, w);
-	Ec Q1, Q2;
-	param.Pbase.mul(Q1, u1);
-//	Ec::mul(Q2, pub, u2);
-	local::mulDispatch(Q2, pub, u2);
-	Q1 += Q2;
-	if (Q1.isZero()) return false;
-	Q1.normalize();
-	Zn x;
-	local::FpToZn(x, Q1.x);
-	return r == x;
+	Ec Q;
+	local::mul2(Q, u1, pub, u2);
+	if (Q.isZero()) return false;
+	return local::isEqualX(Q, r);
 }
 
 } // mcl::ecdsa::local
@@ -462,5 +557,260 @@ inline bool verify(const Signature& sig, const PrecomputedPublicKey& ppub, const
 	return local::verify(sig, ppub, msg, msgSize);
 }
 
+namespace local {
+
+/*
+	the i-th signature is valid if u1[i] P + u2[i] pub[i] = R[i]
+	otherwise it is checked by verify() because recId may be wrong
+	idx[i] : position in the input vector
+*/
+struct VerifyVecWork {
+	mcl::Array<Ec> R, xVec;
+	mcl::Array<PublicKey> pub;
+	mcl::Array<Zn> u1, u2, yVec;
+	mcl::Array<size_t> idx;
+	const Signature *sigVec;
+	const PublicKey *pubVec;
+	const void *const *msgVec;
+	const size_t *msgSizeVec;
+	bool resize(size_t n)
+	{
+		return R.resize(n) && pub.resize(n) && u1.resize(n) && u2.resize(n) && idx.resize(n)
+			&& xVec.resize(n * 2 + 1) && yVec.resize(n * 2 + 1);
+	}
+};
+
+/*
+	check sum_i c_i (R[i] - u1[i] P - u2[i] pub[i]) = 0 for random c_i by one mulVec
+	for i in [pos, pos + n)
+*/
+inline bool verifyVecSub(VerifyVecWork& w, size_t pos, size_t n)
+{
+	Ec *xVec = w.xVec.data();
+	Zn *yVec = w.yVec.data();
+	Zn s = 0;
+	for (size_t i = 0; i < n; i++) {
+		Zn c, t;
+		bool b;
+		c.setByCSPRNG(&b);
+		if (!b) return false;
+		xVec[i * 2] = w.R[pos + i];
+		yVec[i * 2] = c;
+		xVec[i * 2 + 1] = w.pub[pos + i];
+		Zn::mul(t, c, w.u2[pos + i]);
+		Zn::neg(yVec[i * 2 + 1], t);
+		Zn::mul(t, c, w.u1[pos + i]);
+		s += t;
+	}
+	xVec[n * 2] = param.P;
+	Zn::neg(yVec[n * 2], s);
+	Ec Q;
+	Ec::mulVec(Q, xVec, yVec, n * 2 + 1);
+	return Q.isZero();
+}
+
+/*
+	check the signatures in [pos, pos + n) by bisection
+	set okVec[idx[i]] if okVec is not null else stop at the first invalid one
+*/
+inline bool verifyVecBisect(bool *okVec, VerifyVecWork& w, size_t pos, size_t n)
+{
+	if (n == 1) {
+		Ec Q;
+		mul2(Q, w.u1[pos], w.pub[pos], w.u2[pos]);
+		const size_t i = w.idx[pos];
+		bool ok = Q == w.R[pos];
+		if (!ok) {
+			ok = verify(w.sigVec[i], w.pubVec[i], w.msgVec[i], w.msgSizeVec[i]);
+		}
+		if (okVec) okVec[i] = ok;
+		return ok;
+	}
+	if (verifyVecSub(w, pos, n)) {
+		if (okVec) {
+			for (size_t i = 0; i < n; i++) {
+				okVec[w.idx[pos + i]] = true;
+			}
+		}
+		return true;
+	}
+	const size_t h = n / 2;
+	bool b0 = verifyVecBisect(okVec, w, pos, h);
+	if (!b0 && okVec == 0) return false;
+	bool b1 = verifyVecBisect(okVec, w, pos + h, n - h);
+	return b0 && b1;
+}
+
+} // mcl::ecdsa::local
+
+/*
+	verify n signatures at once
+	sigVec[i] : signature of msgVec[i] (msgSizeVec[i] bytes) by pubVec[i]
+	recIdVec[i] : recovery id of sigVec[i] given by sign()
+	okVec[i] (if not null) : result of sigVec[i], found by bisection if the batch check fails
+	return true if all signatures are valid
+	a signature with a wrong recId is verified by verify()
+	accept only lower S signature
+*/
+inline bool verifyVec(const Signature *sigVec, const uint8_t *recIdVec, const PublicKey *pubVec, const void *const *msgVec, const size_t *msgSizeVec, size_t n, bool *okVec = 0)
+{
+	local::VerifyVecWork w;
+	if (!w.resize(n)) return false;
+	w.sigVec = sigVec;
+	w.pubVec = pubVec;
+	w.msgVec = msgVec;
+	w.msgSizeVec = msgSizeVec;
+	bool ret = true;
+	// R[m].y = y^2 at first
+	size_t m = 0;
+	for (size_t i = 0; i < n; i++) {
+		const Signature& sig = sigVec[i];
+		if (okVec) okVec[i] = false;
+		if (sig.r.isZero() || sig.s.isZero() || sig.s.isNegative()) {
+			ret = false;
+			continue;
+		}
+		Ec& R = w.R[m];
+		if (!local::getXofR(R.x, sig.r, (recIdVec[i] & 2) != 0)) {
+			bool ok = verify(sig, pubVec[i], msgVec[i], msgSizeVec[i]);
+			if (okVec) okVec[i] = ok;
+			ret &= ok;
+			continue;
+		}
+		Ec::getWeierstrass(R.y, R.x);
+		w.idx[m] = i;
+		m++;
+	}
+	// lift R[i] with squareRootVec
+	const size_t blockN = 64;
+	size_t k = 0;
+	for (size_t i = 0; i < m; i += blockN) {
+		const size_t bn = fp::min_(blockN, m - i);
+		Fp y[blockN];
+		bool isSquare[blockN];
+		for (size_t j = 0; j < bn; j++) {
+			y[j] = w.R[i + j].y;
+		}
+		Fp::squareRootVec(y, y, bn, isSquare);
+		for (size_t j = 0; j < bn; j++) {
+			const size_t pos = w.idx[i + j];
+			const Signature& sig = sigVec[pos];
+			if (!isSquare[j]) {
+				bool ok = verify(sig, pubVec[pos], msgVec[pos], msgSizeVec[pos]);
+				if (okVec) okVec[pos] = ok;
+				ret &= ok;
+				continue;
+			}
+			Ec& R = w.R[k];
+			R.x = w.R[i + j].x;
+			if (y[j].isOdd() ^ ((recIdVec[pos] & 1) != 0)) {
+				Fp::neg(R.y, y[j]);
+			} else {
+				R.y = y[j];
+			}
+			R.z = 1;
+			w.pub[k] = pubVec[pos];
+			local::setHashOf(w.u1[k], msgVec[pos], msgSizeVec[pos]);
+			w.u2[k] = sig.s;
+			w.idx[k] = pos;
+			k++;
+		}
+	}
+	m = k;
+	if (m == 0) return ret;
+	// u1 = z / s, u2 = r / s
+	mcl::invVec(w.u2.data(), w.u2.data(), m);
+	for (size_t i = 0; i < m; i++) {
+		w.u1[i] *= w.u2[i];
+		w.u2[i] *= sigVec[w.idx[i]].r;
+	}
+	if (okVec == 0 && !ret) return false;
+	// the same result with or without okVec
+	return local::verifyVecBisect(okVec, w, 0, m) && ret;
+}
+
+/*
+	recover the public key from sig of msg and recId given by sign()
+	pub = r^-1 (s R - z P)
+	return false if pub is not found
+	@note s is not restricted to lower S
+*/
+inline bool recoverPublicKey(PublicKey& pub, const Signature& sig, uint8_t recId, const void *msg, size_t msgSize)
+{
+	if (sig.r.isZero() || sig.s.isZero() || recId >= 4) return false;
+	Ec R;
+	if (!local::getXofR(R.x, sig.r, (recId & 2) != 0)) return false;
+	if (!Ec::getYfromX(R.y, R.x, (recId & 1) != 0)) return false;
+	R.z = 1;
+	Zn z, rInv, u1, u2;
+	local::setHashOf(z, msg, msgSize);
+	Zn::inv(rInv, sig.r);
+	Zn::mul(u1, z, rInv);
+	Zn::neg(u1, u1);
+	Zn::mul(u2, sig.s, rInv);
+	local::mul2(pub, u1, R, u2);
+	if (pub.isZero()) return false;
+	pub.normalize();
+	return true;
+}
+
+/*
+	pubVec[i] = recoverPublicKey(sigVec[i], recIdVec[i], msgVec[i], msgSizeVec[i]) for i < n
+	the square roots of y(R) and the inverses of r are computed at once
+	pubVec[i] is cleared and okVec[i] (if not null) is false if it is not found
+	return true if all public keys are found
+*/
+inline bool recoverPublicKeyVec(PublicKey *pubVec, const Signature *sigVec, const uint8_t *recIdVec, const void *const *msgVec, const size_t *msgSizeVec, size_t n, bool *okVec = 0)
+{
+	const size_t blockN = 64;
+	bool ret = true;
+	for (size_t i = 0; i < n; i += blockN) {
+		const size_t m = fp::min_(blockN, n - i);
+		Ec R[blockN];
+		Fp y[blockN];
+		Zn rInv[blockN];
+		bool ok[blockN], isSquare[blockN];
+		for (size_t j = 0; j < m; j++) {
+			const Signature& sig = sigVec[i + j];
+			const uint8_t recId = recIdVec[i + j];
+			ok[j] = !sig.r.isZero() && !sig.s.isZero() && recId < 4 && local::getXofR(R[j].x, sig.r, (recId & 2) != 0);
+			if (ok[j]) {
+				Ec::getWeierstrass(y[j], R[j].x);
+				rInv[j] = sig.r;
+			} else {
+				y[j].clear();
+				rInv[j] = 1;
+			}
+		}
+		Fp::squareRootVec(y, y, m, isSquare);
+		mcl::invVec(rInv, rInv, m);
+		for (size_t j = 0; j < m; j++) {
+			const Signature& sig = sigVec[i + j];
+			PublicKey& pub = pubVec[i + j];
+			ok[j] = ok[j] && isSquare[j];
+			if (ok[j]) {
+				if (y[j].isOdd() ^ ((recIdVec[i + j] & 1) != 0)) {
+					Fp::neg(R[j].y, y[j]);
+				} else {
+					R[j].y = y[j];
+				}
+				R[j].z = 1;
+				Zn z, u1, u2;
+				local::setHashOf(z, msgVec[i + j], msgSizeVec[i + j]);
+				Zn::mul(u1, z, rInv[j]);
+				Zn::neg(u1, u1);
+				Zn::mul(u2, sig.s, rInv[j]);
+				local::mul2(pub, u1, R[j], u2);
+				ok[j] = !pub.isZero();
+			}
+			if (!ok[j]) pub.clear();
+			if (okVec) okVec[i + j] = ok[j];
+			ret &= ok[j];
+		}
+		Ec::normalizeVec(pubVec + i, pubVec + i, m);
+	}
+	return ret;
+}
+
 } } // mcl::ecdsa
 
@@ -0,0 +1,180 @@
+#pragma once
+/**
+	@file
+	@brief pool of precomputed nonces for ECDSA signing
+	@author MITSUNARI Shigeo(@herumi)
+	@license modified new BSD license
+	http://opensource.org/licenses/BSD-3-Clause
+*/
+#include <mcl/ecdsa.hpp>
+#include <cybozu/atomic.hpp>
+
+namespace mcl { namespace ecdsa {
+
+/*
+	ring buffer of (k^-1, r, recId) for sign()
+	fill() makes them in batches sharing the inversions by normalizeVec and Montgomery's trick
+	then sign() needs only a hash and two multiplications in Zn
+
+	fill() may run in another thread (single producer)
+	while sign() and pop() are called from any threads (lock-free)
+	pop() zeroes the entry after taking it
+	@note the pool holds secret nonces; never copy or serialize it
+*/
+class NoncePool {
+	struct Entry {
+		Zn kInv;
+		Zn r;
+		uint8_t recId;
+		size_t busy; // 1 until pop() zeroes the entry
+	};
+	mcl::Array<Entry> buf_;
+	mutable size_t head_; // number of consumed entries
+	mutable size_t tail_; // number of produced entries
+	NoncePool(const NoncePool&);
+	void operator=(const NoncePool&);
+	static size_t load(size_t *p)
+	{
+		return cybozu::AtomicAdd(p, size_t(0));
+	}
+	/*
+		y[i] = 1 / x[i] with one invCT by Montgomery's trick
+		x[i] != 0
+	*/
+	static void invVecCT(Zn *y, const Zn *x, size_t n)
+	{
+		assert(n > 0);
+		Zn t[64];
+		assert(n <= CYBOZU_NUM_OF_ARRAY(t));
+		t[0] = x[0];
+		for (size_t i = 1; i < n; i++) {
+			Zn::mul(t[i], t[i - 1], x[i]);
+		}
+		Zn inv;
+		Zn::invCT(inv, t[n - 1]);
+		for (size_t i = n - 1; i > 0; i--) {
+			Zn u = x[i];
+			Zn::mul(y[i], inv, t[i - 1]);
+			inv *= u;
+		}
+		y[0] = inv;
+	}
+public:
+	NoncePool() : head_(0), tail_(0) {}
+	// allocate maxN entries
+	bool init(size_t maxN)
+	{
+		head_ = 0;
+		tail_ = 0;
+		if (!buf_.resize(maxN)) return false;
+		for (size_t i = 0; i < maxN; i++) {
+			buf_[i].busy = 0;
+		}
+		return true;
+	}
+	size_t capacity() const { return buf_.size(); }
+	// number of available entries
+	size_t size() const
+	{
+		size_t h = load(&head_);
+		size_t t = load(&tail_);
+		return t - h;
+	}
+	/*
+		make at most maxN entries (fill up if maxN = 0)
+		call this function from only one thread at a time
+		return the number of made entries
+	*/
+	size_t fill(size_t maxN = 0)
+	{
+		const size_t cap = buf_.size();
+		const size_t t = load(&tail_);
+		size_t n = cap - (t - load(&head_));
+		if (maxN && maxN < n) n = maxN;
+		// stop at the entry which pop() is still zeroing
+		for (size_t i = 0; i < n; i++) {
+			if (load(&buf_[(t + i) % cap].busy)) {
+				n = i;
+				break;
+			}
+		}
+		const size_t blockN = 64; // <= size of t in invVecCT
+		size_t done = 0;
+		while (done < n) {
+			const size_t m = fp::min_(blockN, n - done);
+			Zn k[blockN], kInv[blockN];
+			Ec Q[blockN];
+			for (size_t i = 0; i < m; i++) {
+				bool b;
+				k[i].setByCSPRNG(&b);
+				if (!b || k[i].isZero()) return done;
+				param.PbaseCT.mulCT(Q[i], k[i]);
+			}
+			Ec::normalizeVec(Q, Q, m);
+			invVecCT(kInv, k, m);
+			for (size_t i = 0; i < m; i++) {
+				Entry& e = buf_[(t + done + i) % cap];
+				local::FpToZn(e.r, Q[i].x);
+				// r = 0 never occurs in practice; sign() rejects it
+				e.recId = local::getRecId(Q[i], e.r, false);
+				e.kInv = kInv[i];
+				e.busy = 1;
+			}
+			done += m;
+			// publish the entries; the full barrier orders the stores above
+			cybozu::AtomicCompareExchange(&tail_, t + done, t + done - m);
+		}
+		return done;
+	}
+	/*
+		take an entry
+		return false if the pool is empty
+	*/
+	bool pop(Zn& kInv, Zn& r, uint8_t& recId)
+	{
+		const size_t cap = buf_.size();
+		size_t h;
+		for (;;) {
+			h = load(&head_);
+			if (h == load(&tail_)) return false;
+			// claim the entry; fill() does not overwrite it until busy is cleared
+			if (cybozu::AtomicCompareExchange(&head_, h + 1, h) == h) break;
+		}
+		Entry& e = buf_[h % cap];
+		kInv = e.kInv;
+		r = e.r;
+		recId = e.recId;
+		e.kInv.clear();
+		e.r.clear();
+		e.recId = 0;
+		// release the entry; the full barrier orders the stores above
+		cybozu::AtomicCompareExchange(&e.busy, size_t(0), size_t(1));
+		return true;
+	}
+	/*
+		same as ecdsa::sign() with a nonce in the pool
+		call ecdsa::sign() if the pool is empty
+	*/
+	void sign(Signature& sig, const SecretKey& sec, const void *msg, size_t msgSize, uint8_t *recId = 0)
+	{
+		Zn z, kInv;
+		uint8_t id;
+		local::setHashOf(z, msg, msgSize);
+		while (pop(kInv, sig.r, id)) {
+			if (sig.r.isZero()) continue;
+			Zn::mul(sig.s, sig.r, sec);
+			sig.s += z;
+			if (sig.s.isZero()) continue;
+			sig.s *= kInv;
+			if (sig.s.isNegative()) {
+				Zn::neg(sig.s, sig.s);
+				id ^= 1;
+			}
+			if (recId) *recId = id;
+			return;
+		}
+		ecdsa::sign(sig, sec, msg, msgSize, recId);
+	}
+};
+
+} } // mcl::ecdsa
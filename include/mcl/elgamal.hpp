@@ -183,10 +183,10 @@ struct ElgamalEc {
 		Ec g;
 		Ec h;
 		bool enableWindowMethod_;
-		fp::WindowMethod<Ec> wm_g;
-		fp::WindowMethod<Ec> wm_h;
+		fp::SignedWindowMethod<Ec> wm_g;
+		fp::SignedWindowMethod<Ec> wm_h;
 		template<class N>
-		void mulDispatch(Ec& z, const Ec& x, const N& n, const fp::WindowMethod<Ec>& pw) const
+		void mulDispatch(Ec& z, const Ec& x, const N& n, const fp::SignedWindowMethod<Ec>& pw) const
 		{
 			if (enableWindowMethod_) {
 				pw.mul(z, n);
@@ -24,6 +24,7 @@
 #include <mcl/util.hpp>
 #include <mcl/operator.hpp>
 #include <mcl/conversion.hpp>
+#include <mcl/fp_fixed.hpp>
 
 namespace mcl {
 
@@ -50,6 +51,11 @@ MCL_DLL_API uint32_t sha512(void *out, uint32_t maxOutSize, const void *msg, uin
 
 // draft-07 outSize = 128 or 256
 MCL_DLL_API void expand_message_xmd(uint8_t out[], size_t outSize, const void *msg, size_t msgSize, const void *dst, size_t dstSize);
+/*
+	out[outSize * i, outSize * (i + 1)) = expand_message_xmd(msgVec[i], msgSizeVec[i]) for i < n
+	several messages are hashed at once by AVX-512 if available
+*/
+MCL_DLL_API void expand_message_xmdVec(uint8_t *out, size_t outSize, const void *const *msgVec, const size_t *msgSizeVec, size_t n, const void *dst, size_t dstSize);
 
 namespace local {
 
@@ -106,6 +112,8 @@ private:
 #endif
 public:
 	typedef FpT<tag, maxBitSize> BaseFp;
+	// Fixed::N > 0 if the modulus is fixed at compile time (see mcl/fp_fixed.hpp)
+	typedef fp::FixedModulus<tag> Fixed;
 	// return pointer to array v_[]
 	const Unit *getUnit() const { return v_; }
 	FpT* getFp0() { return this; }
@@ -130,6 +138,12 @@ public:
 		return;
 #endif
 		if (!*pb) return;
+		if (Fixed::N) {
+			if (!op_.isMont || op_.N != Fixed::N || !bint::cmpEqN(op_.p, Fixed::getP(), Fixed::N)) {
+				*pb = false;
+				return;
+			}
+		}
 		{ // set oneRep
 			FpT& one = *reinterpret_cast<FpT*>(op_.oneRep);
 			one.clear();
@@ -193,6 +207,44 @@ public:
 	{
 		return op_.sq.get(y, x);
 	}
+	/*
+		y[i] = sqrt(x[i]) for i < n (y may be equal to x)
+		isSquare[i] is set to whether x[i] is a square if isSquare is not null
+		y[i] is undefined if x[i] is not a square
+		return true if all x[i] are squares
+	*/
+	static inline bool squareRootVec(FpT *y, const FpT *x, size_t n, bool *isSquare = 0)
+	{
+		bool ret = true;
+		const mpz_class *e = op_.sq.getPowExponent();
+		if (e == 0) {
+			for (size_t i = 0; i < n; i++) {
+				bool b = squareRoot(y[i], x[i]);
+				if (isSquare) isSquare[i] = b;
+				ret &= b;
+			}
+			return ret;
+		}
+		const size_t blockN = 64;
+		FpT c[blockN];
+		while (n > 0) {
+			const size_t m = fp::min_(n, blockN);
+			powVec(c, x, *e, m);
+			for (size_t i = 0; i < m; i++) {
+				FpT t;
+				sqr(t, c[i]);
+				bool b = t == x[i];
+				if (isSquare) isSquare[i] = b;
+				ret &= b;
+				y[i] = c[i];
+			}
+			x += m;
+			y += m;
+			if (isSquare) isSquare += m;
+			n -= m;
+		}
+		return ret;
+	}
 	FpT() {}
 	FpT(const FpT& x)
 	{
@@ -517,6 +569,10 @@ public:
 	}
 	static void add(FpT& z, const FpT& x, const FpT& y)
 	{
+		if (Fixed::N) {
+			Fixed::add(z.v_, x.v_, y.v_);
+			return;
+		}
 #ifdef MCL_XBYAK_DIRECT_CALL
 		op_.fp_addA_(z.v_, x.v_, y.v_);
 #else
@@ -525,6 +581,10 @@ public:
 	}
 	static void sub(FpT& z, const FpT& x, const FpT& y)
 	{
+		if (Fixed::N) {
+			Fixed::sub(z.v_, x.v_, y.v_);
+			return;
+		}
 #ifdef MCL_XBYAK_DIRECT_CALL
 		op_.fp_subA_(z.v_, x.v_, y.v_);
 #else
@@ -533,6 +593,10 @@ public:
 	}
 	static void neg(FpT& y, const FpT& x)
 	{
+		if (Fixed::N) {
+			Fixed::neg(y.v_, x.v_);
+			return;
+		}
 #ifdef MCL_XBYAK_DIRECT_CALL
 		op_.fp_negA_(y.v_, x.v_);
 #else
@@ -541,6 +605,10 @@ public:
 	}
 	static void mul(FpT& z, const FpT& x, const FpT& y)
 	{
+		if (Fixed::N) {
+			Fixed::mul(z.v_, x.v_, y.v_);
+			return;
+		}
 #ifdef MCL_XBYAK_DIRECT_CALL
 		op_.fp_mulA_(z.v_, x.v_, y.v_);
 #else
@@ -549,6 +617,10 @@ public:
 	}
 	static void sqr(FpT& y, const FpT& x)
 	{
+		if (Fixed::N) {
+			Fixed::sqr(y.v_, x.v_);
+			return;
+		}
 #ifdef MCL_XBYAK_DIRECT_CALL
 		op_.fp_sqrA_(y.v_, x.v_);
 #else
@@ -557,6 +629,10 @@ public:
 	}
 	static void mul2(FpT& y, const FpT& x)
 	{
+		if (Fixed::N) {
+			Fixed::add(y.v_, x.v_, x.v_);
+			return;
+		}
 #ifdef MCL_XBYAK_DIRECT_CALL
 		op_.fp_mul2A_(y.v_, x.v_);
 #else
@@ -583,6 +659,14 @@ public:
 		assert(!x.isZero());
 		op_.fp_invOp(y.v_, x.v_, op_);
 	}
+	/*
+		constant time inversion for secret values
+		y = 0 if x = 0
+	*/
+	static inline void invCT(FpT& y, const FpT& x)
+	{
+		op_.fp_invCTOp(y.v_, x.v_, op_);
+	}
 	static inline void divBy2(FpT& y, const FpT& x)
 	{
 		bool odd = (x.v_[0] & 1) != 0;
@@ -596,6 +680,72 @@ public:
 		divBy2(y, x); // QQQ : optimize later
 		divBy2(y, y);
 	}
+	/*
+		element-wise operations for i < n (z may be equal to x, y or w)
+		use SIMD if available
+	*/
+	// z[i] = x[i] + y[i]
+	static inline void addVec(FpT *z, const FpT *x, const FpT *y, size_t n)
+	{
+		if (op_.fp_addVec) {
+			op_.fp_addVec(z->v_, x->v_, y->v_, n);
+			return;
+		}
+		for (size_t i = 0; i < n; i++) add(z[i], x[i], y[i]);
+	}
+	// z[i] = x[i] - y[i]
+	static inline void subVec(FpT *z, const FpT *x, const FpT *y, size_t n)
+	{
+		if (op_.fp_subVec) {
+			op_.fp_subVec(z->v_, x->v_, y->v_, n);
+			return;
+		}
+		for (size_t i = 0; i < n; i++) sub(z[i], x[i], y[i]);
+	}
+	// z[i] = x[i] * y[i]
+	static inline void mulVec(FpT *z, const FpT *x, const FpT *y, size_t n)
+	{
+		if (op_.fp_mulVec) {
+			op_.fp_mulVec(z->v_, x->v_, y->v_, n);
+			return;
+		}
+		for (size_t i = 0; i < n; i++) mul(z[i], x[i], y[i]);
+	}
+	// z[i] = x[i] * y
+	static inline void mulScalarVec(FpT *z, const FpT *x, const FpT& y, size_t n)
+	{
+		if (op_.fp_mulScalarVec) {
+			op_.fp_mulScalarVec(z->v_, x->v_, y.v_, n);
+			return;
+		}
+		const FpT t = y; // y may be in z
+		for (size_t i = 0; i < n; i++) mul(z[i], x[i], t);
+	}
+	// z[i] = x[i] * y[i] + w[i]
+	static inline void fmaVec(FpT *z, const FpT *x, const FpT *y, const FpT *w, size_t n)
+	{
+		if (op_.fp_fmaVec) {
+			op_.fp_fmaVec(z->v_, x->v_, y->v_, w->v_, n);
+			return;
+		}
+		for (size_t i = 0; i < n; i++) {
+			FpT t;
+			mul(t, x[i], y[i]);
+			add(z[i], t, w[i]);
+		}
+	}
+	/*
+		z[i] = x[i]^e for i < n (z may be equal to x)
+		use SIMD if available
+	*/
+	static inline void powVec(FpT *z, const FpT *x, const mpz_class& e, size_t n)
+	{
+		if (op_.fp_powVec) {
+			op_.fp_powVec(z->v_, x->v_, n, gmp::getUnit(e), gmp::getUnitSize(e));
+			return;
+		}
+		for (size_t i = 0; i < n; i++) FpT::pow(z[i], x[i], e);
+	}
 	bool isZero() const { return op_.fp_isZero(v_); }
 	bool isOne() const { return bint::cmpEqN(v_, op_.oneRep, op_.N); }
 	static const inline FpT& one() { return *reinterpret_cast<const FpT*>(op_.oneRep); }
@@ -0,0 +1,364 @@
+#pragma once
+/**
+	@file
+	@brief compile-time modulus of Fp and Fr
+	@author MITSUNARI Shigeo(@herumi)
+	@license modified new BSD license
+	http://opensource.org/licenses/BSD-3-Clause
+*/
+#include <mcl/bint.hpp>
+#include <mcl/curve_type.h>
+
+/*
+	MCL_FIXED_CURVE=<curveType> (MCL_BLS12_381, MCL_BN254 or MCL_BN_SNARK1)
+	fixes the modulus of Fp (FpTag = 0) and Fr (FrTag = 1) at compile time.
+	Then FpT and FpDbl call the inline functions of FixedArith instead of
+	the function pointers of fp::Op, and FpT::init fails for the other primes.
+	The library and the application must be compiled with the same value.
+*/
+
+namespace mcl { namespace fp {
+
+/*
+	default : the modulus is given by FpT::init at runtime (N = 0)
+	the following functions are never called
+*/
+template<int tag>
+struct FixedModulus {
+	static const size_t N = 0;
+	static const Unit *getP() { return 0; }
+	static void add(Unit *, const Unit *, const Unit *) {}
+	static void sub(Unit *, const Unit *, const Unit *) {}
+	static void neg(Unit *, const Unit *) {}
+	static void mul(Unit *, const Unit *, const Unit *) {}
+	static void sqr(Unit *, const Unit *) {}
+	static void mulPre(Unit *, const Unit *, const Unit *) {}
+	static void sqrPre(Unit *, const Unit *) {}
+	static void mod(Unit *, const Unit *) {}
+	static void addDbl(Unit *, const Unit *, const Unit *) {}
+	static void subDbl(Unit *, const Unit *, const Unit *) {}
+};
+
+namespace fixed_local {
+
+// z = x + y + c and return CF
+inline Unit addc(Unit& z, Unit x, Unit y, Unit c)
+{
+	Unit t = x + c;
+	Unit CF = t < c;
+	t += y;
+	CF += t < y;
+	z = t;
+	return CF;
+}
+
+// z = x - y - c and return CF
+inline Unit subc(Unit& z, Unit x, Unit y, Unit c)
+{
+	Unit t = x - y;
+	Unit CF = x < y;
+	CF += t < c;
+	z = t - c;
+	return CF;
+}
+
+// [ret:z] = z + x * y + c
+inline Unit mulAdd(Unit& z, Unit x, Unit y, Unit c)
+{
+	Unit H;
+	Unit L = bint::mulUnit1(&H, x, y);
+	L += c;
+	H += L < c;
+	L += z;
+	H += L < z;
+	z = L;
+	return H;
+}
+
+// z = (mask == -1) ? x : y
+template<size_t N>
+inline void select(Unit *z, const Unit *x, const Unit *y, Unit mask)
+{
+	for (size_t i = 0; i < N; i++) {
+		z[i] = (x[i] & mask) | (y[i] & ~mask);
+	}
+}
+
+/*
+	z = (H:x >= p) ? (H:x) - p : x
+	assume (H:x) < 2p
+*/
+template<size_t N>
+inline void subIfGe(Unit *z, const Unit *x, Unit H, const Unit *p)
+{
+	Unit t[N];
+	Unit CF = 0;
+	for (size_t i = 0; i < N; i++) {
+		CF = subc(t[i], x[i], p[i], CF);
+	}
+	select<N>(z, x, t, Unit(0) - (CF & (H ^ 1)));
+}
+
+} // mcl::fp::fixed_local
+
+/*
+	arithmetic of Montgomery representation for P
+	P::N : the number of Unit
+	P::getP() : the modulus
+	P::getRp() : -1/p mod (1 << UnitBitSize)
+	z may be equal to x or y
+*/
+template<class P>
+struct FixedArith {
+	static const size_t N = P::N;
+	static const Unit *getP() { return P::getP(); }
+	// z = (x + y) % p
+	static inline void add(Unit *z, const Unit *x, const Unit *y)
+	{
+		Unit t[N];
+		Unit CF = 0;
+		for (size_t i = 0; i < N; i++) {
+			CF = fixed_local::addc(t[i], x[i], y[i], CF);
+		}
+		fixed_local::subIfGe<N>(z, t, CF, P::getP());
+	}
+	// z = (x - y) % p
+	static inline void sub(Unit *z, const Unit *x, const Unit *y)
+	{
+		const Unit *p = P::getP();
+		Unit t[N];
+		Unit CF = 0;
+		for (size_t i = 0; i < N; i++) {
+			CF = fixed_local::subc(t[i], x[i], y[i], CF);
+		}
+		const Unit mask = Unit(0) - CF;
+		CF = 0;
+		for (size_t i = 0; i < N; i++) {
+			CF = fixed_local::addc(z[i], t[i], p[i] & mask, CF);
+		}
+	}
+	// y = -x % p
+	static inline void neg(Unit *y, const Unit *x)
+	{
+		const Unit *p = P::getP();
+		Unit t = 0;
+		for (size_t i = 0; i < N; i++) {
+			t |= x[i];
+		}
+		const Unit mask = Unit(0) - ((t | (Unit(0) - t)) >> (UnitBitSize - 1));
+		Unit CF = 0;
+		for (size_t i = 0; i < N; i++) {
+			Unit v;
+			CF = fixed_local::subc(v, p[i], x[i], CF);
+			y[i] = v & mask;
+		}
+	}
+	// z = x * y / R % p (CIOS)
+	static inline void mul(Unit *z, const Unit *x, const Unit *y)
+	{
+		const Unit *p = P::getP();
+		const Unit rp = P::getRp();
+		Unit t[N + 2];
+		for (size_t i = 0; i < N + 1; i++) {
+			t[i] = 0;
+		}
+		for (size_t i = 0; i < N; i++) {
+			const Unit yi = y[i];
+			Unit c = 0;
+			for (size_t j = 0; j < N; j++) {
+				c = fixed_local::mulAdd(t[j], x[j], yi, c);
+			}
+			t[N + 1] = fixed_local::addc(t[N], t[N], c, 0);
+			const Unit q = t[0] * rp;
+			c = fixed_local::mulAdd(t[0], q, p[0], 0);
+			for (size_t j = 1; j < N; j++) {
+				c = fixed_local::mulAdd(t[j], q, p[j], c);
+				t[j - 1] = t[j];
+			}
+			c = fixed_local::addc(t[N - 1], t[N], c, 0);
+			t[N] = t[N + 1] + c;
+		}
+		fixed_local::subIfGe<N>(z, t, t[N], p);
+	}
+	static inline void sqr(Unit *y, const Unit *x)
+	{
+		mul(y, x, x);
+	}
+	// z[N * 2] = x[N] * y[N]
+	static inline void mulPre(Unit *z, const Unit *x, const Unit *y)
+	{
+		Unit t[N * 2];
+		for (size_t i = 0; i < N; i++) {
+			t[i] = 0;
+		}
+		for (size_t i = 0; i < N; i++) {
+			const Unit yi = y[i];
+			Unit c = 0;
+			for (size_t j = 0; j < N; j++) {
+				c = fixed_local::mulAdd(t[i + j], x[j], yi, c);
+			}
+			t[i + N] = c;
+		}
+		for (size_t i = 0; i < N * 2; i++) {
+			z[i] = t[i];
+		}
+	}
+	static inline void sqrPre(Unit *y, const Unit *x)
+	{
+		mulPre(y, x, x);
+	}
+	// z[N] = xy[N * 2] / R % p
+	static inline void mod(Unit *z, const Unit *xy)
+	{
+		const Unit *p = P::getP();
+		const Unit rp = P::getRp();
+		Unit t[N * 2];
+		for (size_t i = 0; i < N * 2; i++) {
+			t[i] = xy[i];
+		}
+		Unit CF = 0;
+		for (size_t i = 0; i < N; i++) {
+			const Unit q = t[i] * rp;
+			Unit c = 0;
+			for (size_t j = 0; j < N; j++) {
+				c = fixed_local::mulAdd(t[i + j], q, p[j], c);
+			}
+			CF = fixed_local::addc(t[i + N], t[i + N], c, CF);
+		}
+		fixed_local::subIfGe<N>(z, t + N, CF, p);
+	}
+	// z[N * 2] = (x[N * 2] + y[N * 2]) mod (p << (N * UnitBitSize))
+	static inline void addDbl(Unit *z, const Unit *x, const Unit *y)
+	{
+		Unit CF = 0;
+		for (size_t i = 0; i < N; i++) {
+			CF = fixed_local::addc(z[i], x[i], y[i], CF);
+		}
+		Unit t[N];
+		for (size_t i = 0; i < N; i++) {
+			CF = fixed_local::addc(t[i], x[N + i], y[N + i], CF);
+		}
+		fixed_local::subIfGe<N>(z + N, t, CF, P::getP());
+	}
+	// z[N * 2] = (x[N * 2] - y[N * 2]) mod (p << (N * UnitBitSize))
+	static inline void subDbl(Unit *z, const Unit *x, const Unit *y)
+	{
+		const Unit *p = P::getP();
+		Unit CF = 0;
+		for (size_t i = 0; i < N * 2; i++) {
+			CF = fixed_local::subc(z[i], x[i], y[i], CF);
+		}
+		const Unit mask = Unit(0) - CF;
+		CF = 0;
+		for (size_t i = 0; i < N; i++) {
+			CF = fixed_local::addc(z[N + i], z[N + i], p[i] & mask, CF);
+		}
+	}
+};
+
+#if MCL_SIZEOF_UNIT == 8
+	#define MCL_FIXED_U64(x) Unit(x##ull)
+#else
+	#define MCL_FIXED_U64(x) Unit(x##ull), Unit(x##ull >> 32)
+#endif
+
+/*
+	FixedCurve<curveType>::Fp and Fr for FixedArith
+*/
+template<int curveType>
+struct FixedCurve;
+
+template<>
+struct FixedCurve<MCL_BLS12_381> {
+	struct Fp {
+		static const size_t N = 6 * sizeof(uint64_t) / sizeof(Unit);
+		static const Unit *getP()
+		{
+			static const Unit p[N] = {
+				MCL_FIXED_U64(0xb9feffffffffaaab), MCL_FIXED_U64(0x1eabfffeb153ffff),
+				MCL_FIXED_U64(0x6730d2a0f6b0f624), MCL_FIXED_U64(0x64774b84f38512bf),
+				MCL_FIXED_U64(0x4b1ba7b6434bacd7), MCL_FIXED_U64(0x1a0111ea397fe69a),
+			};
+			return p;
+		}
+		static Unit getRp() { return Unit(0x89f3fffcfffcfffdull); }
+	};
+	struct Fr {
+		static const size_t N = 4 * sizeof(uint64_t) / sizeof(Unit);
+		static const Unit *getP()
+		{
+			static const Unit p[N] = {
+				MCL_FIXED_U64(0xffffffff00000001), MCL_FIXED_U64(0x53bda402fffe5bfe),
+				MCL_FIXED_U64(0x3339d80809a1d805), MCL_FIXED_U64(0x73eda753299d7d48),
+			};
+			return p;
+		}
+		static Unit getRp() { return Unit(0xfffffffeffffffffull); }
+	};
+};
+
+template<>
+struct FixedCurve<MCL_BN254> {
+	struct Fp {
+		static const size_t N = 4 * sizeof(uint64_t) / sizeof(Unit);
+		static const Unit *getP()
+		{
+			static const Unit p[N] = {
+				MCL_FIXED_U64(0xa700000000000013), MCL_FIXED_U64(0x6121000000000013),
+				MCL_FIXED_U64(0xba344d8000000008), MCL_FIXED_U64(0x2523648240000001),
+			};
+			return p;
+		}
+		static Unit getRp() { return Unit(0x08435e50d79435e5ull); }
+	};
+	struct Fr {
+		static const size_t N = 4 * sizeof(uint64_t) / sizeof(Unit);
+		static const Unit *getP()
+		{
+			static const Unit p[N] = {
+				MCL_FIXED_U64(0xa10000000000000d), MCL_FIXED_U64(0xff9f800000000010),
+				MCL_FIXED_U64(0xba344d8000000007), MCL_FIXED_U64(0x2523648240000001),
+			};
+			return p;
+		}
+		static Unit getRp() { return Unit(0xea3b13b13b13b13bull); }
+	};
+};
+
+template<>
+struct FixedCurve<MCL_BN_SNARK1> {
+	struct Fp {
+		static const size_t N = 4 * sizeof(uint64_t) / sizeof(Unit);
+		static const Unit *getP()
+		{
+			static const Unit p[N] = {
+				MCL_FIXED_U64(0x3c208c16d87cfd47), MCL_FIXED_U64(0x97816a916871ca8d),
+				MCL_FIXED_U64(0xb85045b68181585d), MCL_FIXED_U64(0x30644e72e131a029),
+			};
+			return p;
+		}
+		static Unit getRp() { return Unit(0x87d20782e4866389ull); }
+	};
+	struct Fr {
+		static const size_t N = 4 * sizeof(uint64_t) / sizeof(Unit);
+		static const Unit *getP()
+		{
+			static const Unit p[N] = {
+				MCL_FIXED_U64(0x43e1f593f0000001), MCL_FIXED_U64(0x2833e84879b97091),
+				MCL_FIXED_U64(0xb85045b68181585d), MCL_FIXED_U64(0x30644e72e131a029),
+			};
+			return p;
+		}
+		static Unit getRp() { return Unit(0xc2e1f593efffffffull); }
+	};
+};
+
+#undef MCL_FIXED_U64
+
+#ifdef MCL_FIXED_CURVE
+// FpTag = 0, FrTag = 1
+template<> struct FixedModulus<0> : FixedArith<FixedCurve<MCL_FIXED_CURVE>::Fp> {};
+template<> struct FixedModulus<1> : FixedArith<FixedCurve<MCL_FIXED_CURVE>::Fr> {};
+#endif
+
+} } // mcl::fp
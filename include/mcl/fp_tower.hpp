@@ -108,6 +108,10 @@ public:
 	}
 	static inline void add(FpDbl& z, const FpDbl& x, const FpDbl& y)
 	{
+		if (Fp::Fixed::N) {
+			Fp::Fixed::addDbl(z.v_, x.v_, y.v_);
+			return;
+		}
 #ifdef MCL_XBYAK_DIRECT_CALL
 		Fp::op_.fpDbl_addA_(z.v_, x.v_, y.v_);
 #else
@@ -116,6 +120,10 @@ public:
 	}
 	static inline void sub(FpDbl& z, const FpDbl& x, const FpDbl& y)
 	{
+		if (Fp::Fixed::N) {
+			Fp::Fixed::subDbl(z.v_, x.v_, y.v_);
+			return;
+		}
 #ifdef MCL_XBYAK_DIRECT_CALL
 		Fp::op_.fpDbl_subA_(z.v_, x.v_, y.v_);
 #else
@@ -130,6 +138,10 @@ public:
 	}
 	static inline void mod(Fp& z, const FpDbl& xy)
 	{
+		if (Fp::Fixed::N) {
+			Fp::Fixed::mod(z.v_, xy.v_);
+			return;
+		}
 #ifdef MCL_XBYAK_DIRECT_CALL
 		Fp::op_.fpDbl_modA_(z.v_, xy.v_);
 #else
@@ -146,8 +158,22 @@ public:
 	/*
 		mul(z, x, y) = mulPre(xy, x, y) + mod(z, xy)
 	*/
-	static void mulPre(FpDbl& xy, const Fp& x, const Fp& y) { Fp::op_.fpDbl_mulPre(xy.v_, x.v_, y.v_); }
-	static void sqrPre(FpDbl& xx, const Fp& x) { Fp::op_.fpDbl_sqrPre(xx.v_, x.v_); }
+	static void mulPre(FpDbl& xy, const Fp& x, const Fp& y)
+	{
+		if (Fp::Fixed::N) {
+			Fp::Fixed::mulPre(xy.v_, x.v_, y.v_);
+			return;
+		}
+		Fp::op_.fpDbl_mulPre(xy.v_, x.v_, y.v_);
+	}
+	static void sqrPre(FpDbl& xx, const Fp& x)
+	{
+		if (Fp::Fixed::N) {
+			Fp::Fixed::sqrPre(xx.v_, x.v_);
+			return;
+		}
+		Fp::op_.fpDbl_sqrPre(xx.v_, x.v_);
+	}
 	static void mulUnit(FpDbl& z, const FpDbl& x, Unit y)
 	{
 		if (mulSmallUnit(z, x, y)) return;
@@ -396,6 +422,72 @@ public:
 		Fp::mul(y.b, x.b, t2);
 		return true;
 	}
+	/*
+		y[i] = sqrt(x[i]) for i < n (y may be equal to x)
+		isSquare[i] is set to whether x[i] is a square if isSquare is not null
+		y[i] is undefined if x[i] is not a square
+		return true if all x[i] are squares
+		the square roots and the inversions in Fp are computed by Fp::squareRootVec and invVec
+	*/
+	static inline bool squareRootVec(Fp2 *y, const Fp2 *x, size_t n, bool *isSquare = 0)
+	{
+		const size_t blockN = 64;
+		bool ret = true;
+		while (n > 0) {
+			const size_t m = fp::min_(n, blockN);
+			Fp a[blockN], b[blockN], t1[blockN], t2[blockN];
+			bool ok[blockN], ok2[blockN];
+			for (size_t i = 0; i < m; i++) {
+				a[i] = x[i].a;
+				b[i] = x[i].b;
+				norm(t1[i], x[i]);
+			}
+			Fp::squareRootVec(t1, t1, m, ok);
+			for (size_t i = 0; i < m; i++) {
+				Fp::add(t2[i], a[i], t1[i]);
+				Fp::divBy2(t2[i], t2[i]);
+			}
+			Fp::squareRootVec(t2, t2, m, ok2);
+			// retry (a - t1) / 2 for the rest
+			size_t idx[blockN];
+			Fp t3[blockN];
+			size_t retryN = 0;
+			for (size_t i = 0; i < m; i++) {
+				if (ok[i] && !ok2[i] && !b[i].isZero()) {
+					Fp::sub(t3[retryN], a[i], t1[i]);
+					Fp::divBy2(t3[retryN], t3[retryN]);
+					idx[retryN++] = i;
+				}
+			}
+			Fp::squareRootVec(t3, t3, retryN, ok2);
+			for (size_t i = 0; i < retryN; i++) {
+				t2[idx[i]] = t3[i];
+				// x[i] is not a square if neither (a + t1) / 2 nor (a - t1) / 2 is
+				ok[idx[i]] = ok2[i];
+			}
+			// y.b = b / 2y.a
+			for (size_t i = 0; i < m; i++) {
+				Fp::add(t3[i], t2[i], t2[i]);
+			}
+			invVec(t3, t3, m);
+			for (size_t i = 0; i < m; i++) {
+				bool isSq = ok[i];
+				if (b[i].isZero()) {
+					isSq = squareRoot(y[i], x[i]);
+				} else if (isSq) {
+					y[i].a = t2[i];
+					Fp::mul(y[i].b, b[i], t3[i]);
+				}
+				if (isSquare) isSquare[i] = isSq;
+				ret &= isSq;
+			}
+			x += m;
+			y += m;
+			if (isSquare) isSquare += m;
+			n -= m;
+		}
+		return ret;
+	}
 	// y = a^2 + b^2 u
 	static void inline norm(Fp& y, const Fp2& x)
 	{
@@ -1113,7 +1205,9 @@ struct Fp6Dbl {
 	static void init()
 	{
 		const mcl::fp::Op& op = Fp::getOp();
-		if (op.isLtQuad) {
+		if (op.fp6Dbl_mulPreA_) {
+			mulPre = fp::func_ptr_cast<void (*)(Fp6Dbl&, const Fp6&, const Fp6&)>(op.fp6Dbl_mulPreA_);
+		} else if (op.isLtQuad) {
 			mulPre = mulPreT<true>;
 		} else {
 			mulPre = mulPreT<false>;
@@ -850,6 +850,11 @@ class SquareRoot {
 public:
 	SquareRoot() { clear(); }
 	bool isPrecomputed() const { return isPrecomputed_; }
+	/*
+		return e such that a^e is a square root of a if a is a square (p = 3 mod 4)
+		return 0 otherwise
+	*/
+	const mpz_class *getPowExponent() const { return r == 1 ? &q_add_1_div_2 : 0; }
 	void clear()
 	{
 		isPrecomputed_ = false;
@@ -1,7 +1,7 @@
 #pragma once
 /**
 	@file
-	@brief non constant time invMod by safegcd
+	@brief invMod by safegcd (non constant time and constant time)
 	@author MITSUNARI Shigeo(@herumi)
 	cf. The original code is https://github.com/bitcoin-core/secp256k1/blob/master/doc/safegcd_implementation.md
 	It is offered under the MIT license.
@@ -272,6 +272,176 @@ void exec(const InvModT<N>& im, mpz_class& y, const mpz_class& x)
 	mcl::gmp::setArray(y, uy, N);
 }
 
+/*
+	constant time version
+	f, g, d, e are two's complement integers of n = N + 1 units
+	execute divsteps a fixed number of times without any branch depending on the input
+	cf. Bernstein, Yang, "Fast constant-time gcd computation and modular inversion"
+*/
+namespace ct {
+
+// z = mask ? -x : x (mask = 0 or -1)
+template<size_t n>
+void cneg(Unit *z, const Unit *x, Unit mask)
+{
+	Unit c = mask & 1;
+	for (size_t i = 0; i < n; i++) {
+		Unit t = (x[i] ^ mask) + c;
+		c = t < c;
+		z[i] = t;
+	}
+}
+
+// -1 if x < 0 else 0
+template<size_t n>
+Unit signMask(const Unit *x)
+{
+	return Unit(0) - (x[n - 1] >> (UnitBitSize - 1));
+}
+
+// z = x + (mask & y)
+template<size_t n>
+void addMask(Unit *z, const Unit *x, const Unit *y, Unit mask)
+{
+	Unit t[n];
+	for (size_t i = 0; i < n; i++) t[i] = y[i] & mask;
+	mcl::bint::addT<n>(z, x, t);
+}
+
+// z[n + 1] = x[n] * y
+template<size_t n>
+void mulUnit(Unit *z, const Unit *x, INT y)
+{
+	const Unit xm = signMask<n>(x);
+	const Unit ym = Unit(y >> (sizeof(INT) * 8 - 1));
+	Unit ax[n];
+	cneg<n>(ax, x, xm);
+	z[n] = mcl::bint::mulUnitT<n>(z, ax, (Unit(y) ^ ym) - ym);
+	cneg<n + 1>(z, z, xm ^ ym);
+}
+
+// z[n] = (x[n] * a + y[n] * b) >> modL
+template<size_t n>
+void mulAddShr(Unit *z, const Unit *x, INT a, const Unit *y, INT b)
+{
+	Unit t1[n + 1], t2[n + 1];
+	mulUnit<n>(t1, x, a);
+	mulUnit<n>(t2, y, b);
+	mcl::bint::addT<n + 1>(t1, t1, t2);
+	for (size_t i = 0; i < n; i++) {
+		z[i] = (t1[i] >> modL) | (t1[i + 1] << (UnitBitSize - modL));
+	}
+}
+
+/*
+	modL divsteps with delta
+	return delta and t = 2^modL * (transition matrix)
+*/
+static inline INT divsteps_n_matrix(Quad& t, INT delta, Unit f, Unit g)
+{
+	Unit u = 1, v = 0, q = 0, r = 1;
+	for (int i = 0; i < modL; i++) {
+		Unit c1 = Unit(-delta >> (sizeof(INT) * 8 - 1)); // -1 if delta > 0
+		Unit c2 = Unit(0) - (g & 1); // -1 if g is odd
+		Unit x = (f ^ c1) - c1;
+		Unit y = (u ^ c1) - c1;
+		Unit z = (v ^ c1) - c1;
+		// g += c1 ? -f : f if g is odd
+		g += x & c2;
+		q += y & c2;
+		r += z & c2;
+		// swap if delta > 0 and g is odd
+		c1 &= c2;
+		delta = INT((Unit(delta) ^ c1) - c1) + 1;
+		f += g & c1;
+		u += q & c1;
+		v += r & c1;
+		g >>= 1;
+		u <<= 1;
+		v <<= 1;
+	}
+	t.u = u;
+	t.v = v;
+	t.q = q;
+	t.r = r;
+	return delta;
+}
+
+template<size_t n>
+void update_fg(Unit *f, Unit *g, const Quad& t)
+{
+	Unit f1[n];
+	mulAddShr<n>(f1, f, INT(t.u), g, INT(t.v));
+	mulAddShr<n>(g, f, INT(t.q), g, INT(t.r));
+	mcl::bint::copyT<n>(f, f1);
+}
+
+/*
+	d = (u d + v e + M md) >> modL
+	e = (q d + r e + M me) >> modL
+	keep d, e in (-2M, M)
+*/
+template<size_t n>
+void update_de(const Unit *M, Unit Mi, Unit *d, Unit *e, const Quad& t)
+{
+	const Unit sd = signMask<n>(d);
+	const Unit se = signMask<n>(e);
+	Unit md = (t.u & sd) + (t.v & se);
+	Unit me = (t.q & sd) + (t.r & se);
+	const Unit cd = t.u * d[0] + t.v * e[0];
+	const Unit ce = t.q * d[0] + t.r * e[0];
+	md -= (Mi * cd + md) & MASK;
+	me -= (Mi * ce + me) & MASK;
+	Unit d1[n + 1], e1[n + 1], t1[n + 1], t2[n + 1];
+	mulUnit<n>(d1, d, INT(t.u));
+	mulUnit<n>(t1, e, INT(t.v));
+	mulUnit<n>(t2, M, INT(md));
+	mcl::bint::addT<n + 1>(d1, d1, t1);
+	mcl::bint::addT<n + 1>(d1, d1, t2);
+	mulUnit<n>(e1, d, INT(t.q));
+	mulUnit<n>(t1, e, INT(t.r));
+	mulUnit<n>(t2, M, INT(me));
+	mcl::bint::addT<n + 1>(e1, e1, t1);
+	mcl::bint::addT<n + 1>(e1, e1, t2);
+	for (size_t i = 0; i < n; i++) {
+		d[i] = (d1[i] >> modL) | (d1[i + 1] << (UnitBitSize - modL));
+		e[i] = (e1[i] >> modL) | (e1[i + 1] << (UnitBitSize - modL));
+	}
+}
+
+} // mcl::inv::ct
+
+/*
+	constant time inversion
+	py = 1/px mod M (py = 0 if px = 0)
+	px must be less than M
+*/
+template<int N>
+void execCT(const InvModT<N>& im, Unit *py, const Unit *px)
+{
+	Unit M[N + 1], f[N + 1], g[N + 1], d[N + 1], e[N + 1];
+	mcl::bint::copyT<N>(M, im.M.v);
+	M[N] = 0;
+	mcl::bint::copyT<N + 1>(f, M);
+	mcl::bint::copyT<N>(g, px);
+	g[N] = 0;
+	mcl::bint::clearT<N + 1>(d);
+	mcl::bint::clearT<N + 1>(e);
+	e[0] = 1;
+	INT delta = 1;
+	Quad t;
+	for (int i = 0; i < im.ctN; i++) {
+		delta = ct::divsteps_n_matrix(t, delta, f[0], g[0]);
+		ct::update_de<N + 1>(M, im.Mi, d, e, t);
+		ct::update_fg<N + 1>(f, g, t);
+	}
+	// f = +-1 and d in (-2M, M)
+	ct::addMask<N + 1>(d, d, M, ct::signMask<N + 1>(d));
+	ct::cneg<N + 1>(d, d, ct::signMask<N + 1>(f));
+	ct::addMask<N + 1>(d, d, M, ct::signMask<N + 1>(d));
+	mcl::bint::copyT<N>(py, d);
+}
+
 template<int N>
 void init(InvModT<N>& invMod, const mpz_class& mM)
 {
@@ -281,6 +451,13 @@ void init(InvModT<N>& invMod, const mpz_class& mM)
 	mpz_class mod = mpz_class(1) << modL;
 	mcl::gmp::invMod(inv, mM, mod);
 	invMod.Mi = mcl::gmp::getUnit(inv)[0] & MASK;
+	/*
+		g = 0 after iterN divsteps for d-bit M
+		cf. Theorem 11.2 of Bernstein-Yang
+	*/
+	const int d = int(mcl::gmp::getBitSize(mM));
+	const int iterN = d < 46 ? (49 * d + 80) / 17 : (49 * d + 57) / 17;
+	invMod.ctN = (iterN + modL - 1) / modL;
 }
 
 } // mcl::inv
@@ -34,6 +34,7 @@ struct InvModT {
 	Unit lowM;
 	Unit Mi;
 	SintT<N> M;
+	int ctN; // number of modL-divstep rounds for constant-time inversion
 };
 
 } } // mcl::inv
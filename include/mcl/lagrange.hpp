@@ -6,27 +6,115 @@
 	@license modified new BSD license
 	http://opensource.org/licenses/BSD-3-Clause
 */
+#include <mcl/poly.hpp>
+#include <mcl/window_method.hpp>
+
 namespace mcl {
 
+namespace local {
+
+// use PolyT if k >= lagrangeTreeN and Ntt supports F
+static const size_t lagrangeTreeN = 300;
+
 /*
-	recover out = f(0) by { (x, y) | x = S[i], y = f(x) = vec[i] }
-	@retval 0 if succeed else -1
+	d[i] = S[i] prod_{j != i} (S[j] - S[i]) by the product tree and the multipoint evaluation
+*/
+template<class F>
+bool LagrangeDenominatorsTree(F *d, const F *S, size_t k)
+{
+	size_t maxN = 2;
+	while (maxN < k * 2) maxN *= 2;
+	PolyT<F> poly;
+	if (!poly.init(maxN)) return false;
+	if (!poly.getDenominators(d, S, k)) return false;
+	// prod_{j != i} (S[j] - S[i]) = (-1)^(k-1) prod_{j != i} (S[i] - S[j])
+	F::mulVec(d, d, S, k);
+	if ((k & 1) == 0) {
+		for (size_t i = 0; i < k; i++) {
+			F::neg(d[i], d[i]);
+		}
+	}
+	return true;
+}
+
+template<class F>
+void LagrangeDenominators(F *d, const F *S, size_t k)
+{
+	if (k >= lagrangeTreeN && LagrangeDenominatorsTree(d, S, k)) return;
+	for (size_t i = 0; i < k; i++) {
+		d[i] = S[i];
+	}
+	for (size_t i = 0; i < k; i++) {
+		for (size_t j = 0; j < k; j++) {
+			if (j != i) {
+				F v;
+				F::sub(v, S[j], S[i]);
+				d[i] *= v;
+			}
+		}
+	}
+}
+
+/*
+	out = sum_i c[i] vec[i]
+	G::mulVec may normalize the points, so vec is copied
 */
 template<class G, class F>
-void LagrangeInterpolation(bool *pb, G& out, const F *S, const G *vec, size_t k)
+struct LagrangeSum {
+	static void f(G& out, const F *c, const G *vec, size_t k)
+	{
+		G *t = (G*)malloc(sizeof(G) * k);
+		if (t) {
+			for (size_t i = 0; i < k; i++) {
+				t[i] = vec[i];
+			}
+			G::mulVec(out, t, c, k);
+			free(t);
+			return;
+		}
+		G r;
+		G::mul(r, vec[0], c[0]);
+		for (size_t i = 1; i < k; i++) {
+			G t;
+			G::mul(t, vec[i], c[i]);
+			r += t;
+		}
+		out = r;
+	}
+};
+
+template<class F>
+struct LagrangeSum<F, F> {
+	static void f(F& out, const F *c, const F *vec, size_t k)
+	{
+		F r;
+		F::mul(r, vec[0], c[0]);
+		for (size_t i = 1; i < k; i++) {
+			F t;
+			F::mul(t, vec[i], c[i]);
+			r += t;
+		}
+		out = r;
+	}
+};
+
+} // mcl::local
+
+/*
+	c[i] = delta_{i,S}(0) = prod_{j != i} S[j] / (S[j] - S[i]) for i < k
+	then f(0) = sum_i c[i] f(S[i]) for f of degree < k
+	O(k log^2 k) for large k if F is Fr of BLS12-381 else O(k^2)
+*/
+template<class F>
+void LagrangeCoeff(bool *pb, F *c, const F *S, size_t k)
 {
 	if (k == 0) {
 		*pb = false;
 		return;
 	}
-	if (k == 1) {
-		out = vec[0];
-		*pb = true;
-		return;
-	}
 	/*
-		delta_{i,S}(0) = prod_{j != i} S[j] / (S[j] - S[i]) = a / b
-		where a = prod S[j], b = S[i] * prod_{j != i} (S[j] - S[i])
+		delta_{i,S}(0) = a / d[i]
+		where a = prod S[j], d[i] = S[i] * prod_{j != i} (S[j] - S[i])
 	*/
 	F a = S[0];
 	for (size_t i = 1; i < k; i++) {
@@ -36,63 +124,43 @@ void LagrangeInterpolation(bool *pb, G& out, const F *S, const G *vec, size_t k)
 		*pb = false;
 		return;
 	}
-	/*
-		f(0) = sum_i f(S[i]) delta_{i,S}(0)
-	*/
-#if 1
-	// reduce # of inv
-	// d[i] = S[i] prod_{j!=i}(S[j] - S[i])
-	F *d = (F*)CYBOZU_ALLOCA(sizeof(F) * k);
+	local::LagrangeDenominators(c, S, k);
 	for (size_t i = 0; i < k; i++) {
-		d[i] = S[i];
-	}
-	for (size_t i = 0; i < k; i++) {
-		for (size_t j = 0; j < k; j++) {
-			if (j != i) {
-				F v;
-				F::sub(v, S[j], S[i]);
-				if (v.isZero()) {
-					*pb = false;
-					return;
-				}
-				d[i] *= v;
-			}
+		if (c[i].isZero()) {
+			*pb = false;
+			return;
 		}
 	}
-	mcl::invVec(d, d, k);
-	G r;
-	d[0] *= a;
-	G::mul(r, vec[0], d[0]);
-	for (size_t i = 1; i < k; i++) {
-		d[i] *= a;
-		G t;
-		G::mul(t, vec[i], d[i]);
-		r += t;
-	}
-#else
-	G r;
-	r.clear();
-	for (size_t i = 0; i < k; i++) {
-		F b = S[i];
-		for (size_t j = 0; j < k; j++) {
-			if (j != i) {
-				F v = S[j] - S[i];
-				if (v.isZero()) {
-					*pb = false;
-					return;
-				}
-				b *= v;
-			}
-		}
-		G t;
-		G::mul(t, vec[i], a / b);
-		r += t;
-	}
-#endif
-	out = r;
+	mcl::invVec(c, c, k);
+	F::mulScalarVec(c, c, a, k);
 	*pb = true;
 }
 
+/*
+	recover out = f(0) by { (x, y) | x = S[i], y = f(x) = vec[i] }
+	@retval 0 if succeed else -1
+*/
+template<class G, class F>
+void LagrangeInterpolation(bool *pb, G& out, const F *S, const G *vec, size_t k)
+{
+	if (k == 0) {
+		*pb = false;
+		return;
+	}
+	if (k == 1) {
+		out = vec[0];
+		*pb = true;
+		return;
+	}
+	F *c = (F*)CYBOZU_ALLOCA(sizeof(F) * k);
+	LagrangeCoeff(pb, c, S, k);
+	if (!*pb) return;
+	/*
+		f(0) = sum_i f(S[i]) delta_{i,S}(0)
+	*/
+	local::LagrangeSum<G, F>::f(out, c, vec, k);
+}
+
 /*
 	out = f(x) = c[0] + c[1] * x + c[2] * x^2 + ... + c[cSize - 1] * x^(cSize - 1)
 	@retval 0 if succeed else -1 (if cSize == 0)
@@ -118,6 +186,151 @@ void evaluatePolynomial(bool *pb, G& out, const G *c, size_t cSize, const T& x)
 	*pb = true;
 }
 
+namespace local {
+
+/*
+	window size of the fixed-base tables of the coefficients for n points
+	return 0 if G::mulVec for each point is faster
+*/
+inline size_t getWinSizeForEval(size_t n)
+{
+	if (n < 256) return 0;
+	return 6;
+}
+
+template<class G, class T>
+struct EvalPolyVec {
+	// out[j] = sum_i c[i] x[j]^i by G::mulVec for j in [begin, end)
+	struct MulVecF {
+		G *out;
+		const G *c;
+		size_t cSize;
+		const T *x;
+		bool *pb;
+		void operator()(size_t begin, size_t end) const
+		{
+			// G::mulVec may normalize the points, so each thread has its own copy
+			G *cc = (G*)malloc(sizeof(G) * cSize);
+			T *pw = (T*)malloc(sizeof(T) * cSize);
+			if (cc == 0 || pw == 0) {
+				free(pw);
+				free(cc);
+				*pb = false;
+				return;
+			}
+			for (size_t i = 0; i < cSize; i++) {
+				cc[i] = c[i];
+			}
+			for (size_t j = begin; j < end; j++) {
+				initPowSeq(pw, x[j], cSize);
+				G::mulVec(out[j], cc, pw, cSize);
+			}
+			free(pw);
+			free(cc);
+		}
+	};
+	// out[j] += c pw[j] by the table of c and pw[j] *= x[j] for j in [begin, end)
+	struct TblF {
+		G *out;
+		const fp::WindowMethod<G> *wm;
+		T *pw;
+		const T *x;
+		bool isFirst;
+		void operator()(size_t begin, size_t end) const
+		{
+			for (size_t j = begin; j < end; j++) {
+				if (isFirst) {
+					wm->mul(out[j], pw[j]);
+				} else {
+					G t;
+					wm->mul(t, pw[j]);
+					out[j] += t;
+				}
+				pw[j] *= x[j];
+			}
+		}
+	};
+	static void eval(bool *pb, G *out, const G *c, size_t cSize, const T *x, size_t n, size_t cpuN)
+	{
+		*pb = true;
+		const size_t winSize = getWinSizeForEval(n);
+		if (winSize == 0) {
+			MulVecF f = { out, c, cSize, x, pb };
+			fp::parallelFor(f, n, cpuN);
+			return;
+		}
+		// the table of c[i] is made once and shared by all the points
+		T *pw = (T*)malloc(sizeof(T) * n);
+		if (pw == 0) {
+			*pb = false;
+			return;
+		}
+		for (size_t j = 0; j < n; j++) {
+			pw[j] = 1;
+		}
+		fp::WindowMethod<G> wm;
+		for (size_t i = 0; i < cSize; i++) {
+			wm.init(pb, c[i], T::getBitSize(), winSize);
+			if (!*pb) break;
+			TblF f = { out, &wm, pw, x, i == 0 };
+			fp::parallelFor(f, n, cpuN);
+		}
+		free(pw);
+	}
+};
+
+// Horner's method for each point
+template<class T>
+struct EvalPolyVec<T, T> {
+	static void eval(bool *pb, T *out, const T *c, size_t cSize, const T *x, size_t n, size_t)
+	{
+		for (size_t j = 0; j < n; j++) {
+			evaluatePolynomial(pb, out[j], c, cSize, x[j]);
+		}
+	}
+};
+
+template<class G, class T>
+void evaluatePolynomialVecT(bool *pb, G *out, const G *c, size_t cSize, const T *x, size_t n, size_t cpuN)
+{
+	if (cSize == 0) {
+		*pb = false;
+		return;
+	}
+	if (cSize == 1) {
+		for (size_t j = 0; j < n; j++) {
+			out[j] = c[0];
+		}
+		*pb = true;
+		return;
+	}
+#ifdef MCL_USE_OMP
+	if (cpuN == 0) cpuN = omp_get_num_procs();
+#endif
+	EvalPolyVec<G, T>::eval(pb, out, c, cSize, x, n, cpuN);
+}
+
+} // mcl::local
+
+/*
+	out[j] = f(x[j]) for j < n where f(x) = c[0] + c[1] x + ... + c[cSize - 1] x^(cSize - 1)
+	the powers of x[j] are computed in T and out[j] is computed by G::mulVec
+	the fixed-base tables of c[i] are shared by all the points if n is large
+*/
+template<class G, class T>
+void evaluatePolynomialVec(bool *pb, G *out, const G *c, size_t cSize, const T *x, size_t n)
+{
+	local::evaluatePolynomialVecT(pb, out, c, cSize, x, n, 1);
+}
+
+// multi thread version of evaluatePolynomialVec
+// the num of thread is automatically detected if cpuN = 0
+template<class G, class T>
+void evaluatePolynomialVecMT(bool *pb, G *out, const G *c, size_t cSize, const T *x, size_t n, size_t cpuN = 0)
+{
+	local::evaluatePolynomialVecT(pb, out, c, cSize, x, n, cpuN);
+}
+
 #ifndef CYBOZU_DONT_USE_EXCEPTION
 template<class G, class F>
 void LagrangeInterpolation(G& out, const F *S, const G *vec, size_t k)
@@ -127,6 +340,14 @@ void LagrangeInterpolation(G& out, const F *S, const G *vec, size_t k)
 	if (!b) throw cybozu::Exception("LagrangeInterpolation");
 }
 
+template<class F>
+void LagrangeCoeff(F *c, const F *S, size_t k)
+{
+	bool b;
+	LagrangeCoeff(&b, c, S, k);
+	if (!b) throw cybozu::Exception("LagrangeCoeff");
+}
+
 template<class G, class T>
 void evaluatePolynomial(G& out, const G *c, size_t cSize, const T& x)
 {
@@ -134,6 +355,22 @@ void evaluatePolynomial(G& out, const G *c, size_t cSize, const T& x)
 	evaluatePolynomial(&b, out, c, cSize, x);
 	if (!b) throw cybozu::Exception("evaluatePolynomial");
 }
+
+template<class G, class T>
+void evaluatePolynomialVec(G *out, const G *c, size_t cSize, const T *x, size_t n)
+{
+	bool b;
+	evaluatePolynomialVec(&b, out, c, cSize, x, n);
+	if (!b) throw cybozu::Exception("evaluatePolynomialVec");
+}
+
+template<class G, class T>
+void evaluatePolynomialVecMT(G *out, const G *c, size_t cSize, const T *x, size_t n, size_t cpuN = 0)
+{
+	bool b;
+	evaluatePolynomialVecMT(&b, out, c, cSize, x, n, cpuN);
+	if (!b) throw cybozu::Exception("evaluatePolynomialVecMT");
+}
 #endif
 
 } // mcl
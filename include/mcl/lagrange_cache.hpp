@@ -0,0 +1,95 @@
+#pragma once
+/**
+	@file
+	@brief cache of the coefficients of Lagrange Interpolation
+	@author MITSUNARI Shigeo(@herumi)
+	@license modified new BSD license
+	http://opensource.org/licenses/BSD-3-Clause
+*/
+#include <mcl/lagrange.hpp>
+#include <vector>
+#include <map>
+
+namespace mcl {
+
+/*
+	cache of LagrangeCoeff for the sets S used repeatedly (e.g. the same signers)
+	the key is the sequence S (the order matters)
+	all the entries are removed if the num of entries exceeds maxEntryN
+	@note not thread safe ; use one cache per thread or lock it
+*/
+template<class F>
+class LagrangeCoeffCache {
+	typedef std::vector<F> Vec;
+	struct Less {
+		bool operator()(const Vec& x, const Vec& y) const
+		{
+			if (x.size() != y.size()) return x.size() < y.size();
+			for (size_t i = 0; i < x.size(); i++) {
+				int c = F::compareRaw(x[i], y[i]);
+				if (c) return c < 0;
+			}
+			return false;
+		}
+	};
+	typedef std::map<Vec, Vec, Less> Map;
+	Map map_;
+	size_t maxEntryN_;
+public:
+	explicit LagrangeCoeffCache(size_t maxEntryN = 16) : maxEntryN_(maxEntryN) {}
+	/*
+		c[i] = LagrangeCoeff of S for i < k
+		return false if LagrangeCoeff fails
+	*/
+	bool get(F *c, const F *S, size_t k)
+	{
+		if (k == 0) return false;
+		Vec key(S, S + k);
+		typename Map::const_iterator it = map_.find(key);
+		if (it == map_.end()) {
+			Vec v(k);
+			bool b;
+			LagrangeCoeff(&b, &v[0], S, k);
+			if (!b) return false;
+			if (map_.size() >= maxEntryN_) map_.clear();
+			it = map_.insert(typename Map::value_type(key, v)).first;
+		}
+		const Vec& v = it->second;
+		for (size_t i = 0; i < k; i++) {
+			c[i] = v[i];
+		}
+		return true;
+	}
+	size_t size() const { return map_.size(); }
+	void clear() { map_.clear(); }
+};
+
+// LagrangeInterpolation with the coefficients in cache
+template<class G, class F>
+void LagrangeInterpolation(bool *pb, G& out, LagrangeCoeffCache<F>& cache, const F *S, const G *vec, size_t k)
+{
+	if (k == 1) {
+		out = vec[0];
+		*pb = true;
+		return;
+	}
+	F *c = (F*)CYBOZU_ALLOCA(sizeof(F) * k);
+	if (!cache.get(c, S, k)) {
+		*pb = false;
+		return;
+	}
+	local::LagrangeSum<G, F>::f(out, c, vec, k);
+	*pb = true;
+}
+
+#ifndef CYBOZU_DONT_USE_EXCEPTION
+template<class G, class F>
+void LagrangeInterpolation(G& out, LagrangeCoeffCache<F>& cache, const F *S, const G *vec, size_t k)
+{
+	bool b;
+	LagrangeInterpolation(&b, out, cache, S, vec, k);
+	if (!b) throw cybozu::Exception("LagrangeInterpolation:cache");
+}
+#endif
+
+} // mcl
@@ -6,6 +6,8 @@
 	http://opensource.org/licenses/BSD-3-Clause
 */
 #include <cybozu/inttype.hpp>
+#include <mcl/util.hpp>
+#include <algorithm>
 
 namespace mcl {
 
@@ -80,20 +82,38 @@ struct BitReverse {
 
 } // mcl::local
 
+/*
+	ntt(Fr*) and intt(Fr*) use the following method
+	N <= 2^maxDirectBitN : bit reversal and radix-4 butterflies with the twiddle table of each stage
+	otherwise : four-step method with N = N1 x N2
+	  1. N1-point NTT of each column (blocks of columns are copied into a buffer)
+	  2. multiply w^(i j) for (i, j)-element
+	  3. N2-point NTT of each row
+	  4. transpose
+	the multiplication by 1/N for intt is fused into the last stage
+*/
 template<class Fr>
 struct Ntt {
+	static const size_t maxDirectBitN = 18; // 2^18 elements of Fr (8MiB) fit the last level cache
+	static const size_t colBlockN = 8; // num of columns copied at once in the four-step method
 	local::BitReverse br_;
 	Fr root_; // (r-1)/(2^32)
 	Fr w_;
 	Fr invN_;
 	bool isAllocated_;
 	Fr *ws_; // [N + 1];
+	Fr *tw_; // tw_[L + j] = w_{2L}^j for L = 1, 2, 4, ... < getStageN(bitN) and j < L
+	Fr *itw_; // inverse of tw_
+	Fr *sitw_; // sitw_[j] = itw_[M/4 + j] / N for j < M/4 where M = getLastN(bitN)
 	size_t N_;
 	size_t bitN_;
 
 	Ntt()
 		: isAllocated_(false)
 		, ws_(0)
+		, tw_(0)
+		, itw_(0)
+		, sitw_(0)
 		, N_(0)
 		, bitN_(0)
 	{
@@ -101,7 +121,7 @@ struct Ntt {
 #if 1
 		bool b;
 		root_.setStr(&b, "212d79e5b416b6f0fd56dc8d168d6c0c4024ff270b3e0941b788f500b912f1f", 16);
-		assert(b); (void)b;
+		if (!b) root_.clear();
 #else
 		const Fr g = 5; // generator of Fr^*
 		// e=(r-1)/(2^32)
@@ -126,14 +146,36 @@ struct Ntt {
 	{
 		return N > 1 && (N & (N - 1)) == 0;
 	}
+	// return true if root_ is a primitive 2^32-th root of unity in Fr (false for Fr other than that of BLS12-381)
+	bool isSupported() const
+	{
+		Fr t = root_;
+		for (int i = 0; i < 31; i++) {
+			Fr::sqr(t, t);
+		}
+		return !t.isOne() && (t * t).isOne();
+	}
+	static bool isDirect(size_t bitN) { return bitN <= maxDirectBitN; }
+	// max size of the sub NTTs
+	static size_t getStageN(size_t bitN)
+	{
+		return size_t(1) << (isDirect(bitN) ? bitN : (bitN + 1) / 2);
+	}
+	// size of the sub NTTs of the last stage
+	static size_t getLastN(size_t bitN)
+	{
+		return size_t(1) << (isDirect(bitN) ? bitN : bitN / 2);
+	}
 	static size_t requiredByteSize(size_t N)
 	{
-		return sizeof(Fr) * (N + 1);
+		const size_t bitN = cybozu::bsr(N);
+		const size_t M4 = getLastN(bitN) / 4;
+		return sizeof(Fr) * (N + 1 + getStageN(bitN) * 2 + (M4 ? M4 : 1));
 	}
 	// use malloc if buffer == 0, or buffer must have requiredByteSize(N)
 	bool init(size_t N, void *buffer = 0)
 	{
-		if (!verifyN(N)) return false;
+		if (!verifyN(N) || !isSupported()) return false;
 		clean();
 		if (buffer) {
 			ws_ = reinterpret_cast<Fr*>(buffer);
@@ -151,6 +193,23 @@ struct Ntt {
 		Fr::pow(w, root_, (int64_t(1) << 32) / N);
 		local::initPowSeq(ws_, w, N + 1);
 		Fr::inv(invN_, N);
+		const size_t T = getStageN(bitN_);
+		tw_ = ws_ + N + 1;
+		itw_ = tw_ + T;
+		sitw_ = itw_ + T;
+		tw_[0] = 1;
+		itw_[0] = 1;
+		for (size_t L = 1; L < T; L *= 2) {
+			const size_t step = N / (L * 2);
+			for (size_t j = 0; j < L; j++) {
+				tw_[L + j] = ws_[j * step];
+				itw_[L + j] = ws_[N - j * step];
+			}
+		}
+		const size_t M4 = getLastN(bitN_) / 4;
+		for (size_t j = 0; j < M4; j++) {
+			Fr::mul(sitw_[j], itw_[M4 + j], invN_);
+		}
 		return true;
 	}
 	const Fr& getW() const { return ws_[1]; }
@@ -188,6 +247,392 @@ struct Ntt {
 	void ntt(G *xs) const { _ntt(xs, ws_, false); }
 	template<class G>
 	void intt(G *xs) const { _ntt(xs, ws_, true); }
+	void ntt(Fr *xs) const { nttFr(xs, false, 1); }
+	void intt(Fr *xs) const { nttFr(xs, true, 1); }
+	// multi thread version of ntt/intt (enabled if MCL_USE_OMP is defined)
+	// the num of thread is automatically detected if cpuN = 0
+	void nttMT(Fr *xs, size_t cpuN = 0) const { nttFr(xs, false, cpuN); }
+	void inttMT(Fr *xs, size_t cpuN = 0) const { nttFr(xs, true, cpuN); }
+	/*
+		ntt/intt of x[0, 2^bitK) for bitK <= bitN with the same roots as Ntt of size 2^bitK
+		the tables are shared, so one Ntt can be used for all sizes up to N
+	*/
+	void nttSub(Fr *x, size_t bitK, bool inv) const
+	{
+		assert(bitK <= bitN_);
+		const size_t K = size_t(1) << bitK;
+		if (bitK == bitN_) {
+			nttFr(x, inv, 1);
+			return;
+		}
+		if (K <= getStageN(bitN_)) {
+			nttSmall(x, bitK, inv ? itw_ : tw_, 0, 0);
+		} else {
+			br_.revArray(x, bitK);
+			for (size_t L = 1; L < K; L *= 2) {
+				const size_t h = N_ / (L * 2);
+				for (size_t i = 0; i < K; i += L * 2) {
+					for (size_t j = 0; j < L; j++) {
+						Fr t;
+						Fr::mul(t, x[i + j + L], ws_[inv ? N_ - j * h : j * h]);
+						Fr::sub(x[i + j + L], x[i + j], t);
+						Fr::add(x[i + j], x[i + j], t);
+					}
+				}
+			}
+		}
+		if (inv) {
+			Fr invK;
+			Fr::inv(invK, K);
+			Fr::mulScalarVec(x, x, invK, K);
+		}
+	}
+	/*
+		ntt/intt of G1 or G2 (the outputs are normalized)
+		the twiddle multiplications use G::mulEach (GLV)
+		the butterflies add/sub in affine coordinates with one inversion per block
+		inttEc converts a KZG setup [tau^i]G to the Lagrange basis [L_i(tau)]G and nttEc is its inverse
+	*/
+	template<class G>
+	void nttEc(G *xs) const { nttEcT(xs, false, 1); }
+	template<class G>
+	void inttEc(G *xs) const { nttEcT(xs, true, 1); }
+	// multi thread version of nttEc/inttEc
+	template<class G>
+	void nttEcMT(G *xs, size_t cpuN = 0) const { nttEcT(xs, false, cpuN); }
+	template<class G>
+	void inttEcMT(G *xs, size_t cpuN = 0) const { nttEcT(xs, true, cpuN); }
+	/*
+		NTT of x[0, 2^bitN) with the stage table tw
+		the outputs are multiplied by *s if s is not null, where stw[j] = (*s) tw[2^bitN/4 + j]
+	*/
+	template<class G>
+	void nttSmall(G *x, size_t bitN, const Fr *tw, const Fr *s, const Fr *stw) const
+	{
+		const size_t n = size_t(1) << bitN;
+		br_.revArray(x, bitN);
+		size_t L = 1;
+		if (bitN & 1) {
+			// the first stage (w = 1)
+			for (size_t i = 0; i < n; i += 2) {
+				G t = x[i + 1];
+				G::sub(x[i + 1], x[i], t);
+				G::add(x[i], x[i], t);
+			}
+			L = 2;
+		}
+		// radix-4 butterflies of the two stages L and 2L
+		for (; L < n; L *= 4) {
+			const bool scale = s && L * 4 == n;
+			const Fr *tw1 = scale ? stw : tw + L;
+			const Fr *tw2 = tw + L * 2;
+			for (size_t i = 0; i < n; i += L * 4) {
+				if (radix4Vec(x + i, L, tw1, tw2, scale ? s : 0)) continue;
+				G *p0 = x + i;
+				G *p1 = p0 + L;
+				G *p2 = p1 + L;
+				G *p3 = p2 + L;
+				size_t j = 0;
+				if (!scale) {
+					// tw1[0] = tw2[0] = 1
+					G a0, a1, a2, a3, t;
+					G::sub(a1, p0[0], p1[0]);
+					G::add(a0, p0[0], p1[0]);
+					G::sub(a3, p2[0], p3[0]);
+					G::add(a2, p2[0], p3[0]);
+					G::add(p0[0], a0, a2);
+					G::sub(p2[0], a0, a2);
+					G::mul(t, a3, tw2[L]);
+					G::add(p1[0], a1, t);
+					G::sub(p3[0], a1, t);
+					j = 1;
+				}
+				for (; j < L; j++) {
+					G a0, a1, a2, a3, t;
+					if (scale) {
+						G::mul(a0, p0[j], *s);
+						G::mul(a2, p2[j], *s);
+					} else {
+						a0 = p0[j];
+						a2 = p2[j];
+					}
+					G::mul(t, p1[j], tw1[j]);
+					G::sub(a1, a0, t);
+					G::add(a0, a0, t);
+					G::mul(t, p3[j], tw1[j]);
+					G::sub(a3, a2, t);
+					G::add(a2, a2, t);
+					G::mul(t, a2, tw2[j]);
+					G::add(p0[j], a0, t);
+					G::sub(p2[j], a0, t);
+					G::mul(t, a3, tw2[j + L]);
+					G::add(p1[j], a1, t);
+					G::sub(p3[j], a1, t);
+				}
+			}
+		}
+		if (s && n <= 2) {
+			for (size_t i = 0; i < n; i++) {
+				G::mul(x[i], x[i], *s);
+			}
+		}
+	}
+	/*
+		radix-4 butterflies of nttSmall for j in [0, L) with SIMD
+		return false if not available
+	*/
+	template<class G>
+	static bool radix4Vec(G *, size_t, const Fr *, const Fr *, const Fr *) { return false; }
+	static bool radix4Vec(Fr *x, size_t L, const Fr *tw1, const Fr *tw2, const Fr *s)
+	{
+		const fp::Op& op = Fr::getOp();
+		if (op.fp_radix4Vec == 0 || L < 8) return false;
+		op.fp_radix4Vec((Unit*)x, L, (const Unit*)tw1, (const Unit*)tw2, (const Unit*)s);
+		return true;
+	}
+	/*
+		step 1 and 2 of the four-step method for the columns [begin * colBlockN, end * colBlockN)
+		buf has N1 * colBlockN elements for each thread
+	*/
+	struct ColumnF {
+		const Ntt *self;
+		Fr *x;
+		Fr *buf;
+		bool inv;
+		ColumnF(const Ntt *self, Fr *x, Fr *buf, bool inv) : self(self), x(x), buf(buf), inv(inv) {}
+		void operator()(size_t idx, size_t begin, size_t end) const
+		{
+			const size_t bitN = self->bitN_;
+			const size_t bit1 = (bitN + 1) / 2;
+			const size_t N1 = size_t(1) << bit1;
+			const size_t N2 = size_t(1) << (bitN / 2);
+			const size_t B = colBlockN;
+			const Fr *tw = inv ? self->itw_ : self->tw_;
+			Fr *v = buf + idx * N1 * B;
+			for (size_t cb = begin; cb < end; cb++) {
+				const size_t c0 = cb * B;
+				for (size_t r = 0; r < N1; r++) {
+					const Fr *src = x + r * N2 + c0;
+					for (size_t c = 0; c < B; c++) {
+						v[c * N1 + r] = src[c];
+					}
+				}
+				for (size_t c = 0; c < B; c++) {
+					Fr *col = v + c * N1;
+					self->nttSmall(col, bit1, tw, 0, 0);
+					const size_t j = c0 + c;
+					for (size_t i = 1; i < N1; i++) {
+						const size_t e = i * j; // < N
+						if (e == 0) continue;
+						col[i] *= self->ws_[inv ? self->N_ - e : e];
+					}
+				}
+				for (size_t r = 0; r < N1; r++) {
+					Fr *dst = x + r * N2 + c0;
+					for (size_t c = 0; c < B; c++) {
+						dst[c] = v[c * N1 + r];
+					}
+				}
+			}
+		}
+	};
+	// step 3 of the four-step method for the rows [begin, end)
+	struct RowF {
+		const Ntt *self;
+		Fr *x;
+		bool inv;
+		RowF(const Ntt *self, Fr *x, bool inv) : self(self), x(x), inv(inv) {}
+		void operator()(size_t, size_t begin, size_t end) const
+		{
+			const size_t bit2 = self->bitN_ / 2;
+			const size_t N2 = size_t(1) << bit2;
+			for (size_t r = begin; r < end; r++) {
+				if (inv) {
+					self->nttSmall(x + r * N2, bit2, self->itw_, &self->invN_, self->sitw_);
+				} else {
+					self->nttSmall(x + r * N2, bit2, self->tw_, 0, 0);
+				}
+			}
+		}
+	};
+	// transpose the n x n matrix x in place for the rows of the tiles [begin, end)
+	struct TransposeF {
+		static const size_t tileN = 16;
+		Fr *x;
+		size_t n;
+		TransposeF(Fr *x, size_t n) : x(x), n(n) {}
+		void operator()(size_t, size_t begin, size_t end) const
+		{
+			const size_t tn = n / tileN;
+			for (size_t bi = begin; bi < end; bi++) {
+				for (size_t bj = bi; bj < tn; bj++) {
+					for (size_t i = bi * tileN; i < (bi + 1) * tileN; i++) {
+						size_t j = bj * tileN;
+						if (bi == bj) j = i + 1;
+						for (; j < (bj + 1) * tileN; j++) {
+							Fr t = x[i * n + j];
+							x[i * n + j] = x[j * n + i];
+							x[j * n + i] = t;
+						}
+					}
+				}
+			}
+		}
+	};
+	/*
+		transpose the N1 x N2 matrix x in place, where N1 = N2 or N1 = 2 N2
+		x = [T; B] (T, B are N2 x N2 matrices) for N1 = 2 N2
+		transpose T and B, and interleave their rows
+		flag[] and tmp[] have 2 N2 and N2 elements
+	*/
+	static void transpose(Fr *x, size_t N1, size_t N2, Fr *tmp, uint8_t *flag, size_t cpuN)
+	{
+		const size_t tn = N2 / TransposeF::tileN;
+		fp::parallelForIdx(TransposeF(x, N2), tn, cpuN);
+		if (N1 == N2) return;
+		fp::parallelForIdx(TransposeF(x + N2 * N2, N2), tn, cpuN);
+		// move the i-th row of N2 elements to dst(i) = 2i if i < N2 else 2(i - N2) + 1
+		const size_t n = N2 * 2;
+		for (size_t i = 0; i < n; i++) flag[i] = 0;
+		for (size_t i = 1; i < n - 1; i++) {
+			if (flag[i]) continue;
+			for (size_t k = 0; k < N2; k++) tmp[k] = x[i * N2 + k];
+			size_t cur = i;
+			for (;;) {
+				flag[cur] = 1;
+				const size_t src = (cur & 1) ? N2 + cur / 2 : cur / 2;
+				if (src == i) break;
+				for (size_t k = 0; k < N2; k++) x[cur * N2 + k] = x[src * N2 + k];
+				cur = src;
+			}
+			for (size_t k = 0; k < N2; k++) x[cur * N2 + k] = tmp[k];
+		}
+	}
+	void nttFr(Fr *x, bool inv, size_t cpuN) const
+	{
+		if (isDirect(bitN_)) {
+			if (inv) {
+				nttSmall(x, bitN_, itw_, &invN_, sitw_);
+			} else {
+				nttSmall(x, bitN_, tw_, 0, 0);
+			}
+			return;
+		}
+#ifdef MCL_USE_OMP
+		if (cpuN == 0) cpuN = omp_get_num_procs();
+#else
+		cpuN = 1;
+#endif
+		const size_t N1 = size_t(1) << ((bitN_ + 1) / 2);
+		const size_t N2 = size_t(1) << (bitN_ / 2);
+		const size_t bufN = N1 * colBlockN * cpuN;
+		Fr *buf = (Fr*)malloc(sizeof(Fr) * bufN + N2 * 2);
+		if (buf == 0) {
+			_ntt(x, ws_, inv);
+			return;
+		}
+		fp::parallelForIdx(ColumnF(this, x, buf, inv), N2 / colBlockN, cpuN);
+		fp::parallelForIdx(RowF(this, x, inv), N1, cpuN);
+		transpose(x, N1, N2, buf, (uint8_t*)(buf + bufN), cpuN);
+		free(buf);
+	}
+	static const size_t ecBlockN = 256; // num of butterflies sharing one inversion
+	/*
+		butterflies of the stage L for the blocks [begin, end) of ecBlockN pairs
+		the k-th pair is (x[a], x[a + L]) where a = (k % gN) * 2L + j, j = k / gN and gN = N / 2L
+		then the pairs of j = 0 (w^0 = 1) come first
+		P and Q have ecBlockN elements and s has ecBlockN elements for each thread
+	*/
+	template<class G>
+	struct ButterflyEcF {
+		const Ntt *self;
+		G *x;
+		G *buf;
+		Fr *sbuf;
+		size_t L;
+		bool inv;
+		ButterflyEcF(const Ntt *self, G *x, G *buf, Fr *sbuf, size_t L, bool inv) : self(self), x(x), buf(buf), sbuf(sbuf), L(L), inv(inv) {}
+		void operator()(size_t idx, size_t begin, size_t end) const
+		{
+			const size_t N = self->N_;
+			const size_t gN = N / (L * 2);
+			G *P = buf + idx * ecBlockN * 2;
+			G *Q = P + ecBlockN;
+			Fr *s = sbuf + idx * ecBlockN;
+			for (size_t b = begin; b < end; b++) {
+				const size_t k0 = b * ecBlockN;
+				const size_t m = (std::min)(ecBlockN, N / 2 - k0);
+				for (size_t i = 0; i < m; i++) {
+					const size_t k = k0 + i;
+					const size_t j = k / gN;
+					const size_t a = (k % gN) * L * 2 + j;
+					P[i] = x[a];
+					Q[i] = x[a + L];
+					const size_t e = j * gN;
+					s[i] = self->ws_[inv ? N - e : e];
+				}
+				const size_t t = k0 < gN ? (std::min)(gN - k0, m) : 0;
+				if (t < m) {
+					G::mulEach(Q + t, s + t, m - t);
+					G::normalizeVec(Q + t, Q + t, m - t);
+				}
+				ec::addSubAffineVec(P, Q, P, Q, m);
+				for (size_t i = 0; i < m; i++) {
+					const size_t k = k0 + i;
+					const size_t a = (k % gN) * L * 2 + k / gN;
+					x[a] = P[i];
+					x[a + L] = Q[i];
+				}
+			}
+		}
+	};
+	// x[i] = normalize(x[i] * (*s)) for the blocks [begin, end) of ecBlockN elements
+	template<class G>
+	struct ScaleEcF {
+		G *x;
+		Fr *sbuf;
+		size_t n;
+		ScaleEcF(G *x, Fr *sbuf, size_t n) : x(x), sbuf(sbuf), n(n) {}
+		void operator()(size_t idx, size_t begin, size_t end) const
+		{
+			const Fr *s = sbuf + idx * ecBlockN;
+			for (size_t b = begin; b < end; b++) {
+				const size_t k0 = b * ecBlockN;
+				const size_t m = (std::min)(ecBlockN, n - k0);
+				G::mulEach(x + k0, s, m);
+				G::normalizeVec(x + k0, x + k0, m);
+			}
+		}
+	};
+	template<class G>
+	void nttEcT(G *x, bool inv, size_t cpuN) const
+	{
+#ifdef MCL_USE_OMP
+		if (cpuN == 0) cpuN = omp_get_num_procs();
+#else
+		cpuN = 1;
+#endif
+		G *buf = (G*)malloc(sizeof(G) * ecBlockN * 2 * cpuN);
+		Fr *sbuf = (Fr*)malloc(sizeof(Fr) * ecBlockN * cpuN);
+		if (buf == 0 || sbuf == 0) {
+			free(buf);
+			free(sbuf);
+			_ntt(x, ws_, inv);
+			return;
+		}
+		br_.revArray(x, bitN_);
+		G::normalizeVec(x, x, N_);
+		const size_t blockN = (N_ / 2 + ecBlockN - 1) / ecBlockN;
+		for (size_t L = 1; L < N_; L *= 2) {
+			fp::parallelForIdx(ButterflyEcF<G>(this, x, buf, sbuf, L, inv), blockN, cpuN);
+		}
+		if (inv) {
+			for (size_t i = 0; i < ecBlockN * cpuN; i++) sbuf[i] = invN_;
+			fp::parallelForIdx(ScaleEcF<G>(x, sbuf, N_), (N_ + ecBlockN - 1) / ecBlockN, cpuN);
+		}
+		free(buf);
+		free(sbuf);
+	}
 };
 
 } // mcl
@@ -228,6 +228,15 @@ struct Op {
 	void3u fp2Dbl_mulPreA_;
 	void2u fp2Dbl_sqrPreA_;
 	void2u fp2Dbl_mul_xiA_;
+	/*
+		fused kernels for Fp6 (0 if not available)
+		fp6Dbl_mulPreA_ : Fp6Dbl::mulPre
+		fp6_mulA_ : Fp6::mul
+		fp6_mul01A_ : z = x * (d + e v) used in sparse multiplication of Fp12
+	*/
+	void3u fp6Dbl_mulPreA_;
+	void3u fp6_mulA_;
+	void4u fp6_mul01A_;
 	size_t maxN;
 	size_t N;
 	size_t bitSize;
@@ -242,6 +251,7 @@ struct Op {
 	void3u fp_sqr;
 	void3u fp_mul2;
 	void2uOp fp_invOp;
+	void2uOp fp_invCTOp; // constant time
 	void2uIu fp_mulUnit; // fp_mulUnitPre
 	bool (*mulSmallUnit)(const mcl::bint::SmallModP&, Unit *z, const Unit *x, Unit y);
 
@@ -258,6 +268,20 @@ struct Op {
 	u3u fp_subPre; // without modulo p
 	u3u fpDbl_addPre;
 	u3u fpDbl_subPre;
+	/*
+		SIMD version of vector operations (0 if not available)
+		z[i] = x[i] op y[i] for i < n (y[0] for fp_mulScalarVec)
+		fp_fmaVec : z[i] = x[i] * y[i] + w[i]
+		fp_radix4Vec : radix-4 butterflies used in Ntt
+		fp_powVec : z[i] = x[i]^e for i < n where e = e[0, en)
+	*/
+	void (*fp_addVec)(Unit *z, const Unit *x, const Unit *y, size_t n);
+	void (*fp_subVec)(Unit *z, const Unit *x, const Unit *y, size_t n);
+	void (*fp_mulVec)(Unit *z, const Unit *x, const Unit *y, size_t n);
+	void (*fp_mulScalarVec)(Unit *z, const Unit *x, const Unit *y, size_t n);
+	void (*fp_fmaVec)(Unit *z, const Unit *x, const Unit *y, const Unit *w, size_t n);
+	void (*fp_radix4Vec)(Unit *x, size_t L, const Unit *tw1, const Unit *tw2, const Unit *s);
+	void (*fp_powVec)(Unit *z, const Unit *x, size_t n, const Unit *e, size_t en);
 	/*
 		for Fp2 = F[X] / (X^2 + u)
 		x = a + bu
@@ -319,6 +343,9 @@ struct Op {
 		fp2Dbl_mulPreA_ = 0;
 		fp2Dbl_sqrPreA_ = 0;
 		fp2Dbl_mul_xiA_ = 0;
+		fp6Dbl_mulPreA_ = 0;
+		fp6_mulA_ = 0;
+		fp6_mul01A_ = 0;
 		maxN = 0;
 		N = 0;
 		bitSize = 0;
@@ -333,6 +360,7 @@ struct Op {
 		fp_sqr = 0;
 		fp_mul2 = 0;
 		fp_invOp = 0;
+		fp_invCTOp = 0;
 		fp_mulUnit = 0;
 		mulSmallUnit = 0;
 
@@ -350,6 +378,14 @@ struct Op {
 		fpDbl_addPre = 0;
 		fpDbl_subPre = 0;
 
+		fp_addVec = 0;
+		fp_subVec = 0;
+		fp_mulVec = 0;
+		fp_mulScalarVec = 0;
+		fp_fmaVec = 0;
+		fp_radix4Vec = 0;
+		fp_powVec = 0;
+
 		u = 0;
 		xi_a = 0;
 		fp2_mul_xiA_ = 0;
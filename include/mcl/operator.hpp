@@ -32,25 +32,46 @@ struct AsConstArray {
 	void operator+=(size_t i) { p += i; }
 };
 
+/*
+	Montgomery's trick with invVecChainN independent chains of products
+	the chains hide the latency of mul
+	t[pos] = t[pos - invVecChainN] * x[i] where pos is the index of x[i] not in {0, 1}
+*/
+static const size_t invVecChainN = 4;
+
 template<class Tout, class Tin, class T>
 size_t invVecWork(Tout& y, Tin& x, size_t n, T *t)
 {
+	const size_t C = invVecChainN;
 	size_t pos = 0;
 	for (size_t i = 0; i < n; i++) {
 		if (!(x[i].isZero() || x[i].isOne())) {
-			if (pos == 0) {
+			if (pos < C) {
 				t[pos] = x[i];
 			} else {
-				T::mul(t[pos], t[pos - 1], x[i]);
+				T::mul(t[pos], t[pos - C], x[i]);
 			}
 			pos++;
 		}
 	}
 	const size_t retNum = pos;
-	T inv;
+	// inv[c] = 1 / (the product of the chain c) for c = pos % C
+	T inv[C];
 	if (pos > 0) {
-		T::inv(inv, t[pos - 1]);
-		pos--;
+		const size_t m = pos < C ? pos : C;
+		const T *top = t + pos - m;
+		T u[C];
+		u[0] = top[0];
+		for (size_t k = 1; k < m; k++) {
+			T::mul(u[k], u[k - 1], top[k]);
+		}
+		T r;
+		T::inv(r, u[m - 1]);
+		for (size_t k = m - 1; k > 0; k--) {
+			T::mul(inv[(pos - m + k) % C], r, u[k - 1]);
+			r *= top[k];
+		}
+		inv[(pos - m) % C] = r;
 	}
 	bool x_is_equal_y = &x[0] == &y[0];
 	for (size_t i = 0; i < n; i++) {
@@ -58,18 +79,19 @@ size_t invVecWork(Tout& y, Tin& x, size_t n, T *t)
 		if (x[idx].isZero() || x[idx].isOne()) {
 			if (!x_is_equal_y) y[idx] = x[idx];
 		} else {
-			if (pos > 0) {
+			pos--;
+			T& v = inv[pos % C];
+			if (pos >= C) {
 				if (x_is_equal_y) {
 					T tmp = x[idx];
-					T::mul(y[idx], inv, t[pos - 1]);
-					inv *= tmp;
+					T::mul(y[idx], v, t[pos - C]);
+					v *= tmp;
 				} else {
-					T::mul(y[idx], inv, t[pos - 1]);
-					inv *= x[idx];
+					T::mul(y[idx], v, t[pos - C]);
+					v *= x[idx];
 				}
-				pos--;
 			} else {
-				y[idx] = inv;
+				y[idx] = v;
 			}
 		}
 	}
@@ -381,5 +403,35 @@ size_t invVec(T *y, const T* x, size_t n, size_t N = 256)
 	return invVecT<T>(y, in, n, N);
 }
 
+namespace local {
+
+template<class T>
+struct InvVecF {
+	T *y;
+	const T *x;
+	size_t *retNum;
+	InvVecF(T *y, const T *x, size_t *retNum) : y(y), x(x), retNum(retNum) {}
+	void operator()(size_t begin, size_t end) const
+	{
+		size_t n = invVec(y + begin, x + begin, end - begin);
+#ifdef MCL_USE_OMP
+		#pragma omp atomic
+#endif
+		*retNum += n;
+	}
+};
+
+} // mcl::local
+
+// multi thread version of invVec
+// the num of thread is automatically detected if cpuN = 0
+template<class T>
+size_t invVecMT(T *y, const T* x, size_t n, size_t cpuN = 0)
+{
+	size_t retNum = 0;
+	fp::parallelFor(local::InvVecF<T>(y, x, &retNum), n, cpuN, 1024);
+	return retNum;
+}
+
 } // mcl
 
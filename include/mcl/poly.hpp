@@ -0,0 +1,513 @@
+#pragma once
+/**
+	@file
+	@brief polynomial arithmetic over Fr with Ntt
+	@author MITSUNARI Shigeo(@herumi)
+	@license modified new BSD license
+	http://opensource.org/licenses/BSD-3-Clause
+*/
+#include <mcl/config.hpp>
+#include <mcl/ntt.hpp>
+#include <stdlib.h>
+
+namespace mcl {
+
+/*
+	f(X) = f[0] + f[1] X + ... + f[n-1] X^(n-1) is represented by (f, n)
+	one Ntt of size maxN is used for all the products of at most maxN coefficients
+	the temporaries are taken from one arena, which is released at the end of each method
+	the sizes of inputs should be at most maxN / 2
+	the outputs must not overlap the inputs unless otherwise noted
+*/
+template<class Fr>
+class PolyT {
+	static const size_t smallN = 32; // use the schoolbook method if the size <= smallN
+	Ntt<Fr> ntt_;
+	size_t maxN_;
+	size_t bitN_;
+	Fr *buf_;
+	size_t bufN_;
+	size_t pos_;
+	bool isAllocated_;
+	// release the arena at the end of the scope
+	struct Scope {
+		PolyT *p;
+		size_t pos;
+		explicit Scope(PolyT *p) : p(p), pos(p->pos_) {}
+		~Scope() { p->pos_ = pos; }
+	};
+	Fr *alloc(size_t n)
+	{
+		if (pos_ + n > bufN_) return 0;
+		Fr *p = buf_ + pos_;
+		pos_ += n;
+		return p;
+	}
+	static size_t getBitSize(size_t n)
+	{
+		size_t b = 0;
+		while ((size_t(1) << b) < n) b++;
+		return b;
+	}
+	static void copy(Fr *y, const Fr *x, size_t n)
+	{
+		for (size_t i = 0; i < n; i++) y[i] = x[i];
+	}
+	static void clear(Fr *x, size_t n)
+	{
+		for (size_t i = 0; i < n; i++) x[i].clear();
+	}
+	// z[0, xn + yn - 1) = x * y
+	static void mulSchool(Fr *z, const Fr *x, size_t xn, const Fr *y, size_t yn, Fr *t)
+	{
+		clear(z, xn + yn - 1);
+		for (size_t i = 0; i < xn; i++) {
+			Fr::mulScalarVec(t, y, x[i], yn);
+			Fr::addVec(z + i, z + i, t, yn);
+		}
+	}
+	/*
+		tree of prod_{i in [j 2^k, (j+1) 2^k)} (X - x[i]) for the level k and the node j
+		the node has s + 1 coefficients at tree + off[k] + j (2^k + 1) where s is the num of points
+	*/
+	struct Tree {
+		Fr *buf;
+		size_t m;
+		size_t height; // the root is at the level height
+		size_t off[sizeof(size_t) * 8 + 1];
+		size_t getNodeN(size_t k) const { return (m + (size_t(1) << k) - 1) >> k; }
+		size_t getPointN(size_t k, size_t j) const
+		{
+			const size_t b = j << k;
+			const size_t e = (std::min)(b + (size_t(1) << k), m);
+			return e - b;
+		}
+		Fr *get(size_t k, size_t j) const { return buf + off[k] + j * ((size_t(1) << k) + 1); }
+	};
+	bool buildTree(Tree& tree, const Fr *x, size_t m)
+	{
+		tree.m = m;
+		tree.height = getBitSize(m);
+		size_t n = 0;
+		for (size_t k = 0; k <= tree.height; k++) {
+			tree.off[k] = n;
+			n += tree.getNodeN(k) * ((size_t(1) << k) + 1);
+		}
+		tree.buf = alloc(n);
+		if (tree.buf == 0) return false;
+		for (size_t i = 0; i < m; i++) {
+			Fr *p = tree.get(0, i);
+			Fr::neg(p[0], x[i]);
+			p[1] = 1;
+		}
+		for (size_t k = 0; k < tree.height; k++) {
+			const size_t nodeN = tree.getNodeN(k);
+			for (size_t j = 0; j < nodeN; j += 2) {
+				const size_t s0 = tree.getPointN(k, j);
+				Fr *dst = tree.get(k + 1, j / 2);
+				if (j + 1 == nodeN) {
+					copy(dst, tree.get(k, j), s0 + 1);
+					continue;
+				}
+				const size_t s1 = tree.getPointN(k, j + 1);
+				if (!mul(dst, tree.get(k, j), s0 + 1, tree.get(k, j + 1), s1 + 1)) return false;
+			}
+		}
+		return true;
+	}
+	// y[i] = f(x[i]) for i < m with the tree of x where fn <= m
+	bool evaluateTree(Fr *y, const Fr *f, size_t fn, const Fr *x, const Tree& tree)
+	{
+		Scope scope(this);
+		const size_t m = tree.m;
+		const size_t H = tree.height;
+		const size_t remN = size_t(2) << H;
+		Fr *cur = alloc(remN);
+		Fr *next = alloc(remN);
+		if (cur == 0 || next == 0) return false;
+		// cur has the remainders of the nodes of the level k at cur + j 2^k
+		copy(cur, f, fn);
+		clear(cur + fn, m - fn);
+		for (size_t k = H; k > 0; k--) {
+			const size_t w = size_t(1) << k;
+			if (w <= smallN) {
+				// Horner's method for each point of the node
+				const size_t nodeN = tree.getNodeN(k);
+				for (size_t j = 0; j < nodeN; j++) {
+					const Fr *r = cur + j * w;
+					const size_t s = tree.getPointN(k, j);
+					for (size_t i = 0; i < s; i++) {
+						const Fr& v = x[j * w + i];
+						Fr t = r[s - 1];
+						for (size_t u = s - 1; u > 0; u--) {
+							t *= v;
+							t += r[u - 1];
+						}
+						y[j * w + i] = t;
+					}
+				}
+				return true;
+			}
+			const size_t h = w / 2;
+			const size_t nodeN = tree.getNodeN(k - 1);
+			for (size_t j = 0; j < nodeN; j++) {
+				const Fr *r = cur + (j / 2) * w;
+				const size_t rn = tree.getPointN(k, j / 2);
+				const size_t s = tree.getPointN(k - 1, j);
+				if (rn == s) {
+					copy(next + j * h, r, s);
+					continue;
+				}
+				if (!mod(next + j * h, r, rn, tree.get(k - 1, j), s + 1)) return false;
+			}
+			Fr *t = cur;
+			cur = next;
+			next = t;
+		}
+		copy(y, cur, m);
+		return true;
+	}
+	// d[i] = M'(x[i]) where M = prod_i (X - x[i]) is the root of the tree
+	bool getDenominatorsTree(Fr *d, const Fr *x, const Tree& tree)
+	{
+		Scope scope(this);
+		const size_t m = tree.m;
+		const Fr *M = tree.get(tree.height, 0);
+		Fr *dM = alloc(m);
+		if (dM == 0) return false;
+		for (size_t i = 0; i < m; i++) {
+			Fr::mulUnit(dM[i], M[i + 1], Unit(i + 1));
+		}
+		return evaluateTree(d, dM, m, x, tree);
+	}
+	PolyT(const PolyT&);
+	void operator=(const PolyT&);
+public:
+	PolyT() : maxN_(0), bitN_(0), buf_(0), bufN_(0), pos_(0), isAllocated_(false) {}
+	~PolyT() { clean(); }
+	void clean()
+	{
+		if (isAllocated_) {
+			free(buf_);
+			isAllocated_ = false;
+		}
+		buf_ = 0;
+		bufN_ = 0;
+	}
+	static size_t getArenaSize(size_t maxN)
+	{
+		return maxN * (getBitSize(maxN) * 2 + 16);
+	}
+	static size_t requiredByteSize(size_t maxN)
+	{
+		return sizeof(Fr) * getArenaSize(maxN) + Ntt<Fr>::requiredByteSize(maxN);
+	}
+	/*
+		maxN : max num of coefficients of products (a power of two)
+		use malloc if buffer == 0, or buffer must have requiredByteSize(maxN)
+	*/
+	bool init(size_t maxN, void *buffer = 0)
+	{
+		clean();
+		if (!ntt_.verifyN(maxN)) return false;
+		bufN_ = getArenaSize(maxN);
+		if (buffer) {
+			buf_ = reinterpret_cast<Fr*>(buffer);
+		} else {
+			buf_ = (Fr*)malloc(requiredByteSize(maxN));
+			if (buf_ == 0) return false;
+			isAllocated_ = true;
+		}
+		if (!ntt_.init(maxN, buf_ + bufN_)) {
+			clean();
+			return false;
+		}
+		maxN_ = maxN;
+		bitN_ = getBitSize(maxN);
+		pos_ = 0;
+		return true;
+	}
+	const Ntt<Fr>& getNtt() const { return ntt_; }
+	size_t getMaxN() const { return maxN_; }
+	/*
+		z[0, xn + yn - 1) = x * y (z may be equal to x or y)
+		return false if xn + yn - 1 > maxN
+	*/
+	bool mul(Fr *z, const Fr *x, size_t xn, const Fr *y, size_t yn)
+	{
+		if (xn == 0 || yn == 0) return true;
+		Scope scope(this);
+		const size_t zn = xn + yn - 1;
+		if ((std::min)(xn, yn) <= smallN) {
+			if (xn > yn) {
+				std::swap(x, y);
+				std::swap(xn, yn);
+			}
+			Fr *w = alloc(zn + yn);
+			if (w == 0) return false;
+			mulSchool(w, x, xn, y, yn, w + zn);
+			copy(z, w, zn);
+			return true;
+		}
+		const size_t bitK = getBitSize(zn);
+		if (bitK > bitN_) return false;
+		const size_t K = size_t(1) << bitK;
+		Fr *a = alloc(K);
+		if (a == 0) return false;
+		copy(a, x, xn);
+		clear(a + xn, K - xn);
+		ntt_.nttSub(a, bitK, false);
+		if (x == y && xn == yn) {
+			Fr::mulVec(a, a, a, K);
+		} else {
+			Fr *b = alloc(K);
+			if (b == 0) return false;
+			copy(b, y, yn);
+			clear(b + yn, K - yn);
+			ntt_.nttSub(b, bitK, false);
+			Fr::mulVec(a, a, b, K);
+		}
+		ntt_.nttSub(a, bitK, true);
+		copy(z, a, zn);
+		return true;
+	}
+	/*
+		y[0, k) = 1 / x mod X^k by Newton's method (x[0] != 0)
+	*/
+	bool inv(Fr *y, size_t k, const Fr *x, size_t xn)
+	{
+		if (k == 0) return true;
+		if (xn == 0 || x[0].isZero()) return false;
+		Fr::inv(y[0], x[0]);
+		for (size_t t = 1; t < k;) {
+			Scope scope(this);
+			const size_t t2 = (std::min)(t * 2, k);
+			// e = x y mod X^t2 = 1 + X^t e'
+			const size_t xn2 = (std::min)(xn, t2);
+			const size_t en = xn2 + t - 1;
+			Fr *e = alloc((std::max)(en, t2));
+			if (e == 0 || !mul(e, x, xn2, y, t)) return false;
+			if (en < t2) clear(e + en, t2 - en);
+			// y += -y (e - 1) mod X^t2
+			const size_t d = t2 - t;
+			Fr *u = alloc(d * 2 - 1);
+			if (u == 0 || !mul(u, y, d, e + t, d)) return false;
+			for (size_t i = 0; i < d; i++) {
+				Fr::neg(y[t + i], u[i]);
+			}
+			t = t2;
+		}
+		return true;
+	}
+	/*
+		f = q g + r where q has fn - gn + 1 and r has gn - 1 coefficients (q is not set if fn < gn)
+		g[gn - 1] != 0
+	*/
+	bool divmod(Fr *q, Fr *r, const Fr *f, size_t fn, const Fr *g, size_t gn)
+	{
+		if (gn == 0 || g[gn - 1].isZero()) return false;
+		if (fn < gn) {
+			copy(r, f, fn);
+			clear(r + fn, gn - 1 - fn);
+			return true;
+		}
+		Scope scope(this);
+		const size_t qn = fn - gn + 1;
+		if (qn <= smallN || gn <= smallN) {
+			// long division
+			Fr *rem = alloc(fn + gn);
+			if (rem == 0) return false;
+			Fr *t = rem + fn;
+			copy(rem, f, fn);
+			Fr c;
+			Fr::inv(c, g[gn - 1]);
+			for (size_t i = qn; i > 0; i--) {
+				Fr& qi = q[i - 1];
+				Fr::mul(qi, rem[i - 1 + gn - 1], c);
+				Fr::mulScalarVec(t, g, qi, gn - 1);
+				Fr::subVec(rem + i - 1, rem + i - 1, t, gn - 1);
+			}
+			copy(r, rem, gn - 1);
+			return true;
+		}
+		// rev(q) = rev(f) / rev(g) mod X^qn
+		const size_t gn2 = (std::min)(gn, qn);
+		Fr *fr = alloc(qn);
+		Fr *gr = alloc(gn2);
+		Fr *gi = alloc(qn);
+		Fr *qr = alloc(qn * 2 - 1);
+		if (fr == 0 || gr == 0 || gi == 0 || qr == 0) return false;
+		for (size_t i = 0; i < qn; i++) fr[i] = f[fn - 1 - i];
+		for (size_t i = 0; i < gn2; i++) gr[i] = g[gn - 1 - i];
+		if (!inv(gi, qn, gr, gn2)) return false;
+		if (!mul(qr, fr, qn, gi, qn)) return false;
+		for (size_t i = 0; i < qn; i++) q[i] = qr[qn - 1 - i];
+		// r = f - q g mod X^(gn - 1)
+		const size_t rn = gn - 1;
+		const size_t qn2 = (std::min)(qn, rn);
+		Fr *t = alloc(qn2 + rn - 1);
+		if (t == 0 || !mul(t, q, qn2, g, rn)) return false;
+		Fr::subVec(r, f, t, rn);
+		return true;
+	}
+	// r = f mod g where r has gn - 1 coefficients
+	bool mod(Fr *r, const Fr *f, size_t fn, const Fr *g, size_t gn)
+	{
+		Scope scope(this);
+		Fr *q = fn >= gn ? alloc(fn - gn + 1) : 0;
+		if (fn >= gn && q == 0) return false;
+		return divmod(q, r, f, fn, g, gn);
+	}
+	/*
+		f = q (X^n - 1) + r where q has fn - n and r has n coefficients (q is not set if fn <= n)
+	*/
+	static void divXnMinus1(Fr *q, Fr *r, const Fr *f, size_t fn, size_t n)
+	{
+		const size_t qn = fn > n ? fn - n : 0;
+		for (size_t i = qn; i > 0; i--) {
+			q[i - 1] = f[i - 1 + n];
+			if (i - 1 + n < qn) q[i - 1] += q[i - 1 + n];
+		}
+		for (size_t i = 0; i < n; i++) {
+			if (i < fn) {
+				r[i] = f[i];
+			} else {
+				r[i].clear();
+			}
+			if (i < qn) r[i] += q[i];
+		}
+	}
+	/*
+		f = q (X - a) + r where q has fn - 1 coefficients
+		q may be equal to f + 1
+	*/
+	static void divLinear(Fr *q, Fr& r, const Fr *f, size_t fn, const Fr& a)
+	{
+		if (fn == 0) {
+			r.clear();
+			return;
+		}
+		Fr t = f[fn - 1];
+		for (size_t i = fn - 1; i > 0; i--) {
+			const Fr c = f[i - 1];
+			q[i - 1] = t;
+			t *= a;
+			t += c;
+		}
+		r = t;
+	}
+	/*
+		x[i] = f(g w^i) for i < 2^bitK where f = x[0, 2^bitK) and w is the 2^bitK-th root of unity
+		the evaluations on a coset gH are used for quotients by X^n - 1 which vanishes on H
+	*/
+	bool cosetNtt(Fr *x, size_t bitK, const Fr& g)
+	{
+		if (bitK > bitN_) return false;
+		Scope scope(this);
+		const size_t K = size_t(1) << bitK;
+		Fr *p = alloc(K);
+		if (p == 0) return false;
+		local::initPowSeq(p, g, K);
+		Fr::mulVec(x, x, p, K);
+		ntt_.nttSub(x, bitK, false);
+		return true;
+	}
+	// inverse of cosetNtt
+	bool cosetIntt(Fr *x, size_t bitK, const Fr& g)
+	{
+		if (bitK > bitN_ || g.isZero()) return false;
+		Scope scope(this);
+		const size_t K = size_t(1) << bitK;
+		Fr *p = alloc(K);
+		if (p == 0) return false;
+		Fr invG;
+		Fr::inv(invG, g);
+		local::initPowSeq(p, invG, K);
+		ntt_.nttSub(x, bitK, true);
+		Fr::mulVec(x, x, p, K);
+		return true;
+	}
+	/*
+		y[i] = f(x[i]) for i < m with the subproduct tree in O(n log^2 n)
+	*/
+	bool evaluate(Fr *y, const Fr *f, size_t fn, const Fr *x, size_t m)
+	{
+		if (m == 0) return true;
+		if (fn == 0) {
+			clear(y, m);
+			return true;
+		}
+		Scope scope(this);
+		Tree tree;
+		if (!buildTree(tree, x, m)) return false;
+		if (fn <= m) return evaluateTree(y, f, fn, x, tree);
+		Fr *r = alloc(m);
+		if (r == 0 || !mod(r, f, fn, tree.get(tree.height, 0), m + 1)) return false;
+		return evaluateTree(y, r, m, x, tree);
+	}
+	/*
+		d[i] = prod_{j != i} (x[i] - x[j]) for i < m in O(n log^2 n)
+		d[i] = 0 if x[i] = x[j] for some j != i
+	*/
+	bool getDenominators(Fr *d, const Fr *x, size_t m)
+	{
+		if (m == 0) return true;
+		Scope scope(this);
+		Tree tree;
+		if (!buildTree(tree, x, m)) return false;
+		return getDenominatorsTree(d, x, tree);
+	}
+	/*
+		f[0, m) such that f(x[i]) = y[i] for i < m in O(n log^2 n)
+		return false if x[i] = x[j] for some i != j
+	*/
+	bool interpolate(Fr *f, const Fr *x, const Fr *y, size_t m)
+	{
+		if (m == 0) return true;
+		Scope scope(this);
+		Tree tree;
+		if (!buildTree(tree, x, m)) return false;
+		// w[i] = y[i] / M'(x[i]) where M = prod (X - x[i])
+		Fr *w = alloc(m * 2);
+		if (w == 0) return false;
+		Fr *dM = w + m;
+		if (!getDenominatorsTree(w, x, tree)) return false;
+		for (size_t i = 0; i < m; i++) {
+			if (w[i].isZero()) return false;
+		}
+		invVec(w, w, m);
+		Fr::mulVec(w, w, y, m);
+		// the node (k, j) has c = sum_i w[i] prod_{l != i} (X - x[l]) at w + j 2^k
+		Fr *cur = w;
+		Fr *next = dM;
+		for (size_t k = 0; k < tree.height; k++) {
+			const size_t h = size_t(1) << k;
+			const size_t nodeN = tree.getNodeN(k);
+			for (size_t j = 0; j < nodeN; j += 2) {
+				const Fr *c0 = cur + j * h;
+				const size_t s0 = tree.getPointN(k, j);
+				Fr *dst = next + j * h;
+				if (j + 1 == nodeN) {
+					copy(dst, c0, s0);
+					continue;
+				}
+				const Fr *c1 = c0 + h;
+				const size_t s1 = tree.getPointN(k, j + 1);
+				Scope scope2(this);
+				Fr *t = alloc(s0 + s1);
+				if (t == 0) return false;
+				// c0 M1 + c1 M0
+				if (!mul(t, c0, s0, tree.get(k, j + 1), s1 + 1)) return false;
+				if (!mul(dst, c1, s1, tree.get(k, j), s0 + 1)) return false;
+				Fr::addVec(dst, dst, t, s0 + s1);
+			}
+			Fr *t = cur;
+			cur = next;
+			next = t;
+		}
+		copy(f, cur, m);
+		return true;
+	}
+};
+
+} // mcl
@@ -183,6 +183,25 @@ MCLSHE_DLL_API int shePrecomputedPublicKeyEncG1(sheCipherTextG1 *c, const shePre
 MCLSHE_DLL_API int shePrecomputedPublicKeyEncG2(sheCipherTextG2 *c, const shePrecomputedPublicKey *ppub, mclInt m);
 MCLSHE_DLL_API int shePrecomputedPublicKeyEncGT(sheCipherTextGT *c, const shePrecomputedPublicKey *ppub, mclInt m);
 
+/*
+	c[i] = Enc(m[i]) for i = 0, ..., n-1
+	return 0 if success
+*/
+MCLSHE_DLL_API int sheEncG1Vec(sheCipherTextG1 *c, const shePublicKey *pub, const mclInt *m, mclSize n);
+MCLSHE_DLL_API int sheEncG2Vec(sheCipherTextG2 *c, const shePublicKey *pub, const mclInt *m, mclSize n);
+MCLSHE_DLL_API int sheEncGTVec(sheCipherTextGT *c, const shePublicKey *pub, const mclInt *m, mclSize n);
+MCLSHE_DLL_API int shePrecomputedPublicKeyEncG1Vec(sheCipherTextG1 *c, const shePrecomputedPublicKey *ppub, const mclInt *m, mclSize n);
+MCLSHE_DLL_API int shePrecomputedPublicKeyEncG2Vec(sheCipherTextG2 *c, const shePrecomputedPublicKey *ppub, const mclInt *m, mclSize n);
+MCLSHE_DLL_API int shePrecomputedPublicKeyEncGTVec(sheCipherTextGT *c, const shePrecomputedPublicKey *ppub, const mclInt *m, mclSize n);
+// multi thread version of sheEnc*Vec (enabled if the library built with MCL_USE_OMP=1)
+// the num of thread is automatically detected if cpuN = 0
+MCLSHE_DLL_API int sheEncG1VecMT(sheCipherTextG1 *c, const shePublicKey *pub, const mclInt *m, mclSize n, mclSize cpuN);
+MCLSHE_DLL_API int sheEncG2VecMT(sheCipherTextG2 *c, const shePublicKey *pub, const mclInt *m, mclSize n, mclSize cpuN);
+MCLSHE_DLL_API int sheEncGTVecMT(sheCipherTextGT *c, const shePublicKey *pub, const mclInt *m, mclSize n, mclSize cpuN);
+MCLSHE_DLL_API int shePrecomputedPublicKeyEncG1VecMT(sheCipherTextG1 *c, const shePrecomputedPublicKey *ppub, const mclInt *m, mclSize n, mclSize cpuN);
+MCLSHE_DLL_API int shePrecomputedPublicKeyEncG2VecMT(sheCipherTextG2 *c, const shePrecomputedPublicKey *ppub, const mclInt *m, mclSize n, mclSize cpuN);
+MCLSHE_DLL_API int shePrecomputedPublicKeyEncGTVecMT(sheCipherTextGT *c, const shePrecomputedPublicKey *ppub, const mclInt *m, mclSize n, mclSize cpuN);
+
 /*
 	enc large integer
 	buf[bufSize] is little endian
@@ -253,6 +272,36 @@ MCLSHE_DLL_API int shePrecomputedPublicKeyVerifyZkpEq(const shePrecomputedPublic
 MCLSHE_DLL_API int shePrecomputedPublicKeyVerifyZkpBinEq(const shePrecomputedPublicKey *ppub, const sheCipherTextG1 *c1, const sheCipherTextG2 *c2, const sheZkpBinEq *zkp);
 MCLSHE_DLL_API int sheVerifyZkpDecG1(const shePublicKey *pub, const sheCipherTextG1 *c1, mclInt m, const sheZkpDec *zkp);
 MCLSHE_DLL_API int sheVerifyZkpDecGT(const sheAuxiliaryForZkpDecGT *aux, const sheCipherTextGT *ct, mclInt m, const sheZkpDecGT *zkp);
+/*
+	verify n proofs at once
+	return 1 if all the proofs are valid
+	okVec[i] = 1 if the i-th proof is valid else 0 (okVec can be NULL)
+	zkp of ZkpSetG1 has (n * mSize * 2) elements
+*/
+MCLSHE_DLL_API int sheVerifyZkpBinG1Vec(const shePublicKey *pub, const sheCipherTextG1 *c, const sheZkpBin *zkp, mclSize n, int *okVec);
+MCLSHE_DLL_API int sheVerifyZkpBinG2Vec(const shePublicKey *pub, const sheCipherTextG2 *c, const sheZkpBin *zkp, mclSize n, int *okVec);
+MCLSHE_DLL_API int sheVerifyZkpSetG1Vec(const shePublicKey *pub, const sheCipherTextG1 *c, const mclBnFr *zkp, const int *mVec, mclSize mSize, mclSize n, int *okVec);
+MCLSHE_DLL_API int sheVerifyZkpEqVec(const shePublicKey *pub, const sheCipherTextG1 *c1, const sheCipherTextG2 *c2, const sheZkpEq *zkp, mclSize n, int *okVec);
+MCLSHE_DLL_API int sheVerifyZkpBinEqVec(const shePublicKey *pub, const sheCipherTextG1 *c1, const sheCipherTextG2 *c2, const sheZkpBinEq *zkp, mclSize n, int *okVec);
+MCLSHE_DLL_API int shePrecomputedPublicKeyVerifyZkpBinG1Vec(const shePrecomputedPublicKey *ppub, const sheCipherTextG1 *c, const sheZkpBin *zkp, mclSize n, int *okVec);
+MCLSHE_DLL_API int shePrecomputedPublicKeyVerifyZkpBinG2Vec(const shePrecomputedPublicKey *ppub, const sheCipherTextG2 *c, const sheZkpBin *zkp, mclSize n, int *okVec);
+MCLSHE_DLL_API int shePrecomputedPublicKeyVerifyZkpSetG1Vec(const shePrecomputedPublicKey *ppub, const sheCipherTextG1 *c, const mclBnFr *zkp, const int *mVec, mclSize mSize, mclSize n, int *okVec);
+MCLSHE_DLL_API int shePrecomputedPublicKeyVerifyZkpEqVec(const shePrecomputedPublicKey *ppub, const sheCipherTextG1 *c1, const sheCipherTextG2 *c2, const sheZkpEq *zkp, mclSize n, int *okVec);
+MCLSHE_DLL_API int shePrecomputedPublicKeyVerifyZkpBinEqVec(const shePrecomputedPublicKey *ppub, const sheCipherTextG1 *c1, const sheCipherTextG2 *c2, const sheZkpBinEq *zkp, mclSize n, int *okVec);
+/*
+	multi thread version of verify*Vec (enabled if MCL_USE_OMP is defined)
+	the num of thread is automatically detected if cpuN = 0
+*/
+MCLSHE_DLL_API int sheVerifyZkpBinG1VecMT(const shePublicKey *pub, const sheCipherTextG1 *c, const sheZkpBin *zkp, mclSize n, int *okVec, mclSize cpuN);
+MCLSHE_DLL_API int sheVerifyZkpBinG2VecMT(const shePublicKey *pub, const sheCipherTextG2 *c, const sheZkpBin *zkp, mclSize n, int *okVec, mclSize cpuN);
+MCLSHE_DLL_API int sheVerifyZkpSetG1VecMT(const shePublicKey *pub, const sheCipherTextG1 *c, const mclBnFr *zkp, const int *mVec, mclSize mSize, mclSize n, int *okVec, mclSize cpuN);
+MCLSHE_DLL_API int sheVerifyZkpEqVecMT(const shePublicKey *pub, const sheCipherTextG1 *c1, const sheCipherTextG2 *c2, const sheZkpEq *zkp, mclSize n, int *okVec, mclSize cpuN);
+MCLSHE_DLL_API int sheVerifyZkpBinEqVecMT(const shePublicKey *pub, const sheCipherTextG1 *c1, const sheCipherTextG2 *c2, const sheZkpBinEq *zkp, mclSize n, int *okVec, mclSize cpuN);
+MCLSHE_DLL_API int shePrecomputedPublicKeyVerifyZkpBinG1VecMT(const shePrecomputedPublicKey *ppub, const sheCipherTextG1 *c, const sheZkpBin *zkp, mclSize n, int *okVec, mclSize cpuN);
+MCLSHE_DLL_API int shePrecomputedPublicKeyVerifyZkpBinG2VecMT(const shePrecomputedPublicKey *ppub, const sheCipherTextG2 *c, const sheZkpBin *zkp, mclSize n, int *okVec, mclSize cpuN);
+MCLSHE_DLL_API int shePrecomputedPublicKeyVerifyZkpSetG1VecMT(const shePrecomputedPublicKey *ppub, const sheCipherTextG1 *c, const mclBnFr *zkp, const int *mVec, mclSize mSize, mclSize n, int *okVec, mclSize cpuN);
+MCLSHE_DLL_API int shePrecomputedPublicKeyVerifyZkpEqVecMT(const shePrecomputedPublicKey *ppub, const sheCipherTextG1 *c1, const sheCipherTextG2 *c2, const sheZkpEq *zkp, mclSize n, int *okVec, mclSize cpuN);
+MCLSHE_DLL_API int shePrecomputedPublicKeyVerifyZkpBinEqVecMT(const shePrecomputedPublicKey *ppub, const sheCipherTextG1 *c1, const sheCipherTextG2 *c2, const sheZkpBinEq *zkp, mclSize n, int *okVec, mclSize cpuN);
 /*
 	decode c via GT and set m
 	return 0 if success
@@ -279,6 +328,33 @@ MCLSHE_DLL_API int sheAddG1(sheCipherTextG1 *z, const sheCipherTextG1 *x, const
 MCLSHE_DLL_API int sheAddG2(sheCipherTextG2 *z, const sheCipherTextG2 *x, const sheCipherTextG2 *y);
 MCLSHE_DLL_API int sheAddGT(sheCipherTextGT *z, const sheCipherTextGT *x, const sheCipherTextGT *y);
 
+/*
+	z[i] = x[i] + y[i] for i in [0, n)
+	z may be equal to x or y
+	return 0 if success
+*/
+MCLSHE_DLL_API int sheAddG1Vec(sheCipherTextG1 *z, const sheCipherTextG1 *x, const sheCipherTextG1 *y, mclSize n);
+MCLSHE_DLL_API int sheAddG2Vec(sheCipherTextG2 *z, const sheCipherTextG2 *x, const sheCipherTextG2 *y, mclSize n);
+MCLSHE_DLL_API int sheAddGTVec(sheCipherTextGT *z, const sheCipherTextGT *x, const sheCipherTextGT *y, mclSize n);
+// multi thread version of sheAdd*Vec (enabled if the library built with MCL_USE_OMP=1)
+// the num of thread is automatically detected if cpuN = 0
+MCLSHE_DLL_API int sheAddG1VecMT(sheCipherTextG1 *z, const sheCipherTextG1 *x, const sheCipherTextG1 *y, mclSize n, mclSize cpuN);
+MCLSHE_DLL_API int sheAddG2VecMT(sheCipherTextG2 *z, const sheCipherTextG2 *x, const sheCipherTextG2 *y, mclSize n, mclSize cpuN);
+MCLSHE_DLL_API int sheAddGTVecMT(sheCipherTextGT *z, const sheCipherTextGT *x, const sheCipherTextGT *y, mclSize n, mclSize cpuN);
+
+/*
+	z = x[0] + ... + x[n-1]
+	return 0 if success
+*/
+MCLSHE_DLL_API int sheSumG1Vec(sheCipherTextG1 *z, const sheCipherTextG1 *x, mclSize n);
+MCLSHE_DLL_API int sheSumG2Vec(sheCipherTextG2 *z, const sheCipherTextG2 *x, mclSize n);
+MCLSHE_DLL_API int sheSumGTVec(sheCipherTextGT *z, const sheCipherTextGT *x, mclSize n);
+// multi thread version of sheSum*Vec (enabled if the library built with MCL_USE_OMP=1)
+// the num of thread is automatically detected if cpuN = 0
+MCLSHE_DLL_API int sheSumG1VecMT(sheCipherTextG1 *z, const sheCipherTextG1 *x, mclSize n, mclSize cpuN);
+MCLSHE_DLL_API int sheSumG2VecMT(sheCipherTextG2 *z, const sheCipherTextG2 *x, mclSize n, mclSize cpuN);
+MCLSHE_DLL_API int sheSumGTVecMT(sheCipherTextGT *z, const sheCipherTextGT *x, mclSize n, mclSize cpuN);
+
 // return 0 if success
 // z = x - y
 MCLSHE_DLL_API int sheSubG1(sheCipherTextG1 *z, const sheCipherTextG1 *x, const sheCipherTextG1 *y);
@@ -310,17 +386,53 @@ MCLSHE_DLL_API int sheMul(sheCipherTextGT *z, const sheCipherTextG1 *x, const sh
 */
 MCLSHE_DLL_API int sheMulML(sheCipherTextGT *z, const sheCipherTextG1 *x, const sheCipherTextG2 *y);
 MCLSHE_DLL_API int sheFinalExpGT(sheCipherTextGT *y, const sheCipherTextGT *x);
+/*
+	z = sum_i sheMul(x[i], y[i]) for i in [0, n)
+	finalExp is called once
+*/
+MCLSHE_DLL_API int sheMulVec(sheCipherTextGT *z, const sheCipherTextG1 *x, const sheCipherTextG2 *y, mclSize n);
+// multi thread version of sheMulVec (enabled if MCL_USE_OMP is defined)
+// the num of thread is automatically detected if cpuN = 0
+MCLSHE_DLL_API int sheMulVecMT(sheCipherTextGT *z, const sheCipherTextG1 *x, const sheCipherTextG2 *y, mclSize n, mclSize cpuN);
 
 // return 0 if success
 // rerandomize(c)
 MCLSHE_DLL_API int sheReRandG1(sheCipherTextG1 *c, const shePublicKey *pub);
 MCLSHE_DLL_API int sheReRandG2(sheCipherTextG2 *c, const shePublicKey *pub);
 MCLSHE_DLL_API int sheReRandGT(sheCipherTextGT *c, const shePublicKey *pub);
+/*
+	c[i] = rerandomize(c[i]) for i = 0, ..., n-1
+	return 0 if success
+*/
+MCLSHE_DLL_API int sheReRandG1Vec(sheCipherTextG1 *c, const shePublicKey *pub, mclSize n);
+MCLSHE_DLL_API int sheReRandG2Vec(sheCipherTextG2 *c, const shePublicKey *pub, mclSize n);
+MCLSHE_DLL_API int sheReRandGTVec(sheCipherTextGT *c, const shePublicKey *pub, mclSize n);
+MCLSHE_DLL_API int shePrecomputedPublicKeyReRandG1Vec(sheCipherTextG1 *c, const shePrecomputedPublicKey *ppub, mclSize n);
+MCLSHE_DLL_API int shePrecomputedPublicKeyReRandG2Vec(sheCipherTextG2 *c, const shePrecomputedPublicKey *ppub, mclSize n);
+MCLSHE_DLL_API int shePrecomputedPublicKeyReRandGTVec(sheCipherTextGT *c, const shePrecomputedPublicKey *ppub, mclSize n);
+// multi thread version of sheReRand*Vec (enabled if the library built with MCL_USE_OMP=1)
+// the num of thread is automatically detected if cpuN = 0
+MCLSHE_DLL_API int sheReRandG1VecMT(sheCipherTextG1 *c, const shePublicKey *pub, mclSize n, mclSize cpuN);
+MCLSHE_DLL_API int sheReRandG2VecMT(sheCipherTextG2 *c, const shePublicKey *pub, mclSize n, mclSize cpuN);
+MCLSHE_DLL_API int sheReRandGTVecMT(sheCipherTextGT *c, const shePublicKey *pub, mclSize n, mclSize cpuN);
+MCLSHE_DLL_API int shePrecomputedPublicKeyReRandG1VecMT(sheCipherTextG1 *c, const shePrecomputedPublicKey *ppub, mclSize n, mclSize cpuN);
+MCLSHE_DLL_API int shePrecomputedPublicKeyReRandG2VecMT(sheCipherTextG2 *c, const shePrecomputedPublicKey *ppub, mclSize n, mclSize cpuN);
+MCLSHE_DLL_API int shePrecomputedPublicKeyReRandGTVecMT(sheCipherTextGT *c, const shePrecomputedPublicKey *ppub, mclSize n, mclSize cpuN);
 
 // return 0 if success
 // y = convert(x)
 MCLSHE_DLL_API int sheConvertG1(sheCipherTextGT *y, const shePublicKey *pub, const sheCipherTextG1 *x);
 MCLSHE_DLL_API int sheConvertG2(sheCipherTextGT *y, const shePublicKey *pub, const sheCipherTextG2 *x);
+/*
+	y[i] = convert(x[i]) for i = 0, ..., n-1
+	return 0 if success
+*/
+MCLSHE_DLL_API int sheConvertG1Vec(sheCipherTextGT *y, const shePublicKey *pub, const sheCipherTextG1 *x, mclSize n);
+MCLSHE_DLL_API int sheConvertG2Vec(sheCipherTextGT *y, const shePublicKey *pub, const sheCipherTextG2 *x, mclSize n);
+// multi thread version of sheConvert*Vec (enabled if the library built with MCL_USE_OMP=1)
+// the num of thread is automatically detected if cpuN = 0
+MCLSHE_DLL_API int sheConvertG1VecMT(sheCipherTextGT *y, const shePublicKey *pub, const sheCipherTextG1 *x, mclSize n, mclSize cpuN);
+MCLSHE_DLL_API int sheConvertG2VecMT(sheCipherTextGT *y, const shePublicKey *pub, const sheCipherTextG2 *x, mclSize n, mclSize cpuN);
 
 // return nonzero if success
 MCLSHE_DLL_API shePrecomputedPublicKey *shePrecomputedPublicKeyCreate();
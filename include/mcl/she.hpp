@@ -87,6 +87,11 @@ struct InterfaceForHashTable<G, false> : G {
 	static uint32_t getHash(const G& x) { return uint32_t(*x.getFp0()->getUnit()); }
 	static void clear(G& x) { x = 1; }
 	static void normalize(G&) { }
+	static void normalizeVec(G *y, const G *x, size_t n)
+	{
+		if (y == x) return;
+		for (size_t i = 0; i < n; i++) y[i] = x[i];
+	}
 	static void dbl(G& y, const G& x) { G::sqr(y, x); }
 	static void neg(G& Q, const G& P) { G::unitaryInv(Q, P); }
 	static void add(G& z, const G& x, const G& y) { G::mul(z, x, y); }
@@ -109,7 +114,7 @@ class HashTable {
 	typedef std::vector<KeyCount> KeyCountVec;
 	KeyCountVec kcv_;
 	G P_;
-	mcl::fp::WindowMethod<I> wm_;
+	mcl::fp::SignedWindowMethod<I> wm_;
 	G nextP_;
 	G nextNegP_;
 	size_t tryNum_;
@@ -296,7 +301,7 @@ public:
 		load(is);
 		return is.getPos();
 	}
-	const mcl::fp::WindowMethod<I>& getWM() const { return wm_; }
+	const mcl::fp::SignedWindowMethod<I>& getWM() const { return wm_; }
 	/*
 		mul(x, P, y);
 	*/
@@ -376,6 +381,18 @@ struct AsArrayOfFp {
 	void operator+=(size_t n) { c += n; }
 };
 
+/*
+	window size of a temporary table for a fixed base used n times
+	return 0 if making the table is slower than n scalar multiplications
+*/
+inline size_t getWinSizeForVec(size_t n)
+{
+	if (n < 128) return 0;
+	if (n < 512) return 4;
+	if (n < 4096) return 6;
+	return 8;
+}
+
 
 } // mcl::she::local
 
@@ -467,6 +484,111 @@ struct SHET {
 		}
 		void add(const CipherTextAT& c) { add(*this, *this, c); }
 		void sub(const CipherTextAT& c) { sub(*this, *this, c); }
+		/*
+			z[i] = x[i] + y[i] for i in the blocks [begin, end)
+			S and T of each block are normalized and added in affine coordinates
+			with one inversion
+		*/
+		struct AddVecF {
+			static const size_t blockN = 128;
+			CipherTextAT *z;
+			const CipherTextAT *x;
+			const CipherTextAT *y;
+			size_t n;
+			AddVecF(CipherTextAT *z, const CipherTextAT *x, const CipherTextAT *y, size_t n) : z(z), x(x), y(y), n(n) {}
+			void operator()(size_t begin, size_t end) const
+			{
+				std::vector<G> P(blockN * 2);
+				std::vector<G> Q(blockN * 2);
+				for (size_t b = begin; b < end; b++) {
+					const size_t i0 = b * blockN;
+					const size_t m = fp::min_(n - i0, blockN);
+					// P = (S[], T[]) of x, Q = (S[], T[]) of y
+					for (size_t i = 0; i < m; i++) {
+						P[i] = x[i0 + i].S_;
+						P[m + i] = x[i0 + i].T_;
+						Q[i] = y[i0 + i].S_;
+						Q[m + i] = y[i0 + i].T_;
+					}
+					G::normalizeVec(&P[0], &P[0], m * 2);
+					G::normalizeVec(&Q[0], &Q[0], m * 2);
+					ec::addAffineVec(&P[0], &P[0], &Q[0], m * 2);
+					for (size_t i = 0; i < m; i++) {
+						z[i0 + i].S_ = P[i];
+						z[i0 + i].T_ = P[m + i];
+					}
+				}
+			}
+		};
+		/*
+			part[b] = sum_i x[i] for i in the block b for b in [begin, end)
+			the ciphertexts of each block are summed by the pairwise addition in affine coordinates
+		*/
+		struct SumVecF {
+			static const size_t blockN = 1024;
+			CipherTextAT *part;
+			const CipherTextAT *x;
+			size_t n;
+			SumVecF(CipherTextAT *part, const CipherTextAT *x, size_t n) : part(part), x(x), n(n) {}
+			void operator()(size_t begin, size_t end) const
+			{
+				std::vector<G> P(blockN * 2);
+				for (size_t b = begin; b < end; b++) {
+					const size_t i0 = b * blockN;
+					const size_t m = fp::min_(n - i0, blockN);
+					for (size_t i = 0; i < m; i++) {
+						P[i] = x[i0 + i].S_;
+						P[m + i] = x[i0 + i].T_;
+					}
+					G::normalizeVec(&P[0], &P[0], m * 2);
+					ec::sumAffineVec(part[b].S_, &P[0], m);
+					ec::sumAffineVec(part[b].T_, &P[m], m);
+				}
+			}
+		};
+		/*
+			z[i] = x[i] + y[i] for i in [0, n)
+			z may be equal to x or y
+			z[] are normalized
+		*/
+		static void addVec(CipherTextAT *z, const CipherTextAT *x, const CipherTextAT *y, size_t n)
+		{
+			addVecMT(z, x, y, n, 1);
+		}
+		// multi thread version of addVec (enabled if MCL_USE_OMP is defined)
+		// the num of thread is automatically detected if cpuN = 0
+		static void addVecMT(CipherTextAT *z, const CipherTextAT *x, const CipherTextAT *y, size_t n, size_t cpuN = 0)
+		{
+			const size_t blockN = AddVecF::blockN;
+			mcl::fp::parallelFor(AddVecF(z, x, y, n), (n + blockN - 1) / blockN, cpuN);
+		}
+		/*
+			z = sum_i x[i] for i in [0, n)
+			z is normalized
+		*/
+		static void sumVec(CipherTextAT& z, const CipherTextAT *x, size_t n)
+		{
+			sumVecMT(z, x, n, 1);
+		}
+		// multi thread version of sumVec (enabled if MCL_USE_OMP is defined)
+		// the num of thread is automatically detected if cpuN = 0
+		static void sumVecMT(CipherTextAT& z, const CipherTextAT *x, size_t n, size_t cpuN = 0)
+		{
+			if (n == 0) {
+				z.clear();
+				return;
+			}
+			const size_t blockN = SumVecF::blockN;
+			const size_t bn = (n + blockN - 1) / blockN;
+			if (bn == 1) {
+				SumVecF(&z, x, n)(0, 1);
+				return;
+			}
+			// the partial sums are already normalized
+			std::vector<CipherTextAT> part(bn);
+			mcl::fp::parallelFor(SumVecF(&part[0], x, n), bn, cpuN);
+			sumVecMT(z, &part[0], bn, cpuN);
+		}
 		template<class InputStream>
 		void load(bool *pb, InputStream& is, int ioMode = IoSerialize)
 		{
@@ -1033,7 +1155,7 @@ private:
 		use *encRand if encRand is not null
 	*/
 	template<class G, class INT, class MulG, class I>
-	static void ElGamalEnc(G& S, G& T, const INT& m, const mcl::fp::WindowMethod<I>& Pmul, const MulG& xPmul, const Fr *encRand = 0)
+	static void ElGamalEnc(G& S, G& T, const INT& m, const mcl::fp::SignedWindowMethod<I>& Pmul, const MulG& xPmul, const Fr *encRand = 0)
 	{
 		Fr r;
 		if (encRand) {
@@ -1048,6 +1170,46 @@ private:
 		Pmul.mul(static_cast<I&>(C), m);
 		S += C;
 	}
+	template<class G, class INT, class MulG, class I>
+	struct ElGamalEncVecF {
+		CipherTextAT<G> *c;
+		const INT *m;
+		const Fr *r;
+		const mcl::fp::SignedWindowMethod<I>& Pmul;
+		const MulG& xPmul;
+		ElGamalEncVecF(CipherTextAT<G> *c, const INT *m, const Fr *r, const mcl::fp::SignedWindowMethod<I>& Pmul, const MulG& xPmul)
+			: c(c), m(m), r(r), Pmul(Pmul), xPmul(xPmul) {}
+		void operator()(size_t begin, size_t end) const
+		{
+			for (size_t i = begin; i < end; i++) {
+				ElGamalEnc(c[i].getNonConstRefS(), c[i].getNonConstRefT(), m[i], Pmul, xPmul, &r[i]);
+			}
+		}
+	};
+	template<class G>
+	static void normalizeCipherVec(CipherTextAT<G> *c, size_t n)
+	{
+		typedef local::CipherAsArrayOfEc<CipherTextAT<G> > Array;
+		// use two objects because normalizeVecT advances both of them
+		Array out(c), in(c);
+		ec::local::normalizeVecT<typename G::Fp, Array, Array, local::AsArrayOfFp<Array> >(out, in, n * 2);
+	}
+	/*
+		c[i] = ElGamalEnc(m[i]) for i in [0, n)
+		the random values are generated before the parallel loop because RandGen is not thread safe
+		c[] are normalized by one inversion
+	*/
+	template<class G, class INT, class MulG, class I>
+	static void ElGamalEncVec(CipherTextAT<G> *c, const INT *m, size_t n, const mcl::fp::SignedWindowMethod<I>& Pmul, const MulG& xPmul, size_t cpuN)
+	{
+		if (n == 0) return;
+		std::vector<Fr> r(n);
+		for (size_t i = 0; i < n; i++) {
+			r[i].setRand();
+		}
+		mcl::fp::parallelFor(ElGamalEncVecF<G, INT, MulG, I>(c, m, &r[0], Pmul, xPmul), n, cpuN);
+		normalizeCipherVec(c, n);
+	}
 	/*
 		https://github.com/herumi/mcl/blob/master/misc/she/nizkp.pdf
 
@@ -1064,7 +1226,7 @@ private:
 		s[m] = r + d[m] encRand
 	*/
 	template<class G, class I, class MulG>
-	static bool makeZkpBin(ZkpBin& zkp, const G& S, const G& T, const Fr& encRand, const G& P, int m, const mcl::fp::WindowMethod<I>& Pmul, const MulG& xPmul)
+	static bool makeZkpBin(ZkpBin& zkp, const G& S, const G& T, const Fr& encRand, const G& P, int m, const mcl::fp::SignedWindowMethod<I>& Pmul, const MulG& xPmul)
 	{
 		if (m != 0 && m != 1) return false;
 		Fr *s = &zkp.d_[0];
@@ -1097,37 +1259,53 @@ private:
 		return true;
 	}
 	/*
-		R[0][i] = s[i] P - d[i] T ; i = 0,1
-		R[1][0] = s[0] xP - d[0] S
-		R[1][1] = s[1] xP - d[1](S - P)
-		c = H(S, T, R[0][0], R[0][1], R[1][0], R[1][1])
-		c == d[0] + d[1]
+		R[i] = s[i] P - d[i] T ; i = 0,1
+		R[2] = s[0] xP - d[0] S
+		R[3] = s[1] xP - d[1](S - P)
 	*/
 	template<class G, class I, class MulG>
-	static bool verifyZkpBin(const G& S, const G& T, const G& P, const ZkpBin& zkp, const mcl::fp::WindowMethod<I>& Pmul, const MulG& xPmul)
+	static void commitZkpBin(G R[4], const G& S, const G& T, const G& P, const ZkpBin& zkp, const mcl::fp::SignedWindowMethod<I>& Pmul, const MulG& xPmul)
 	{
 		const Fr *s = &zkp.d_[0];
 		const Fr *d = &zkp.d_[2];
-		G R[2][2];
 		G T1, T2;
 		for (int i = 0; i < 2; i++) {
 			Pmul.mul(static_cast<I&>(T1), s[i]); // T1 = s[i] P
 			G::mul(T2, T, d[i]);
-			G::sub(R[0][i], T1, T2);
+			G::sub(R[i], T1, T2);
 		}
 		xPmul.mul(T1, s[0]); // T1 = s[0] xP
 		G::mul(T2, S, d[0]);
-		G::sub(R[1][0], T1, T2);
+		G::sub(R[2], T1, T2);
 		xPmul.mul(T1, s[1]); // T1 = x[1] xP
 		G::sub(T2, S, P);
 		G::mul(T2, T2, d[1]);
-		G::sub(R[1][1], T1, T2);
+		G::sub(R[3], T1, T2);
+	}
+	template<class G>
+	static bool checkZkpBin(const G& S, const G& T, const G R[4], const ZkpBin& zkp)
+	{
+		const Fr *d = &zkp.d_[2];
 		Fr c;
 		local::Hash hash;
-		hash << S << T << R[0][0] << R[0][1] << R[1][0] << R[1][1];
+		hash << S << T << R[0] << R[1] << R[2] << R[3];
 		hash.get(c);
 		return c == d[0] + d[1];
 	}
+	/*
+		R[0][i] = s[i] P - d[i] T ; i = 0,1
+		R[1][0] = s[0] xP - d[0] S
+		R[1][1] = s[1] xP - d[1](S - P)
+		c = H(S, T, R[0][0], R[0][1], R[1][0], R[1][1])
+		c == d[0] + d[1]
+	*/
+	template<class G, class I, class MulG>
+	static bool verifyZkpBin(const G& S, const G& T, const G& P, const ZkpBin& zkp, const mcl::fp::SignedWindowMethod<I>& Pmul, const MulG& xPmul)
+	{
+		G R[4];
+		commitZkpBin(R, S, T, P, zkp, Pmul, xPmul);
+		return checkZkpBin(S, T, R, zkp);
+	}
 	// check m[i] < m[i+1]
 	static bool check_mVec(const int *mVec, size_t mSize)
 	{
@@ -1146,7 +1324,7 @@ private:
 		2) i0 exists such that m[i0] = m
 	*/
 	template<class G, class I, class MulG>
-	static bool makeZkpSet(Fr *zkp, const G& xP, const G& S, const G& T, const Fr& encRand, int m, const int *mVec, size_t mSize, const mcl::fp::WindowMethod<I>& Pmul, const MulG& xPmul)
+	static bool makeZkpSet(Fr *zkp, const G& xP, const G& S, const G& T, const Fr& encRand, int m, const int *mVec, size_t mSize, const mcl::fp::SignedWindowMethod<I>& Pmul, const MulG& xPmul)
 	{
 		if (!check_mVec(mVec, mSize)) return false;
 		// find i0 s.t. m[i0] = m
@@ -1198,27 +1376,42 @@ private:
 		see https://github.com/herumi/mcl/blob/master/misc/she/nizkp.pdf
 	*/
 	template<class G, class I, class MulG>
-	static bool verifyZkpSet(const G& xP, const G& S, const G& T, const Fr *zkp, const int *mVec, size_t mSize, const mcl::fp::WindowMethod<I>& Pmul, const MulG& xPmul)
+	static bool verifyZkpSet(const G& xP, const G& S, const G& T, const Fr *zkp, const int *mVec, size_t mSize, const mcl::fp::SignedWindowMethod<I>& Pmul, const MulG& xPmul)
 	{
 		if (!check_mVec(mVec, mSize)) return false;
+		std::vector<G> R(mSize * 2);
+		commitZkpSet(&R[0], S, T, zkp, mVec, mSize, Pmul, xPmul);
+		return checkZkpSet(xP, S, T, &R[0], zkp, mSize);
+	}
+	/*
+		ai(C - Enc(mi, 0)) - Enc(0, bi)
+		= ai(S - mi P, T) - (bi xP, bi P)
+		R[i * 2 + 0] = ai(S - mi P) + bi xP
+		R[i * 2 + 1] = ai T + bi P
+	*/
+	template<class G, class I, class MulG>
+	static void commitZkpSet(G *R, const G& S, const G& T, const Fr *zkp, const int *mVec, size_t mSize, const mcl::fp::SignedWindowMethod<I>& Pmul, const MulG& xPmul)
+	{
 		const Fr *a = zkp;
 		const Fr *b = zkp + mSize;
-		Fr c;
-		local::Hash hash;
-		hash << xP << S << T;
-		/*
-			ai(C - Enc(mi, 0)) - Enc(0, bi)
-			= ai(S - mi P, T) - (bi xP, bi P)
-		*/
-		Fr sum = 0;
 		for (size_t i = 0; i < mSize; i++) {
-			G1 S1, S2, T1, T2;
+			G S1, S2, T2;
 			Pmul.mul(static_cast<I&>(S1), mVec[i]);
 			xPmul.mul(S2, b[i]);
 			Pmul.mul(static_cast<I&>(T2), b[i]);
-			S1 = (S - S1) * a[i] + S2;
-			T1 = T * a[i] + T2;
-			hash << S1 << T1;
+			R[i * 2 + 0] = (S - S1) * a[i] + S2;
+			R[i * 2 + 1] = T * a[i] + T2;
+		}
+	}
+	template<class G>
+	static bool checkZkpSet(const G& xP, const G& S, const G& T, const G *R, const Fr *zkp, size_t mSize)
+	{
+		const Fr *a = zkp;
+		local::Hash hash;
+		hash << xP << S << T;
+		Fr sum = 0;
+		for (size_t i = 0; i < mSize; i++) {
+			hash << R[i * 2 + 0] << R[i * 2 + 1];
 			sum += a[i];
 		}
 		Fr h;
@@ -1229,7 +1422,7 @@ private:
 		encRand1, encRand2 are random values use for ElGamalEnc()
 	*/
 	template<class G1, class G2, class INT, class I1, class I2, class MulG1, class MulG2>
-	static void makeZkpEq(ZkpEq& zkp, G1& S1, G1& T1, G2& S2, G2& T2, const INT& m, const mcl::fp::WindowMethod<I1>& Pmul, const MulG1& xPmul, const mcl::fp::WindowMethod<I2>& Qmul, const MulG2& yQmul)
+	static void makeZkpEq(ZkpEq& zkp, G1& S1, G1& T1, G2& S2, G2& T2, const INT& m, const mcl::fp::SignedWindowMethod<I1>& Pmul, const MulG1& xPmul, const mcl::fp::SignedWindowMethod<I2>& Qmul, const MulG2& yQmul)
 	{
 		Fr p, s;
 		p.setRand();
@@ -1258,36 +1451,50 @@ private:
 		Fr::mul(sm, c, m);
 		sm += rm;
 	}
+	// R12[] = { R1, R2 }, R34[] = { R3, R4 }
 	template<class G1, class G2, class I1, class I2, class MulG1, class MulG2>
-	static bool verifyZkpEq(const ZkpEq& zkp, const G1& S1, const G1& T1, const G2& S2, const G2& T2, const mcl::fp::WindowMethod<I1>& Pmul, const MulG1& xPmul, const mcl::fp::WindowMethod<I2>& Qmul, const MulG2& yQmul)
+	static void commitZkpEq(G1 R12[2], G2 R34[2], const ZkpEq& zkp, const G1& S1, const G1& T1, const G2& S2, const G2& T2, const mcl::fp::SignedWindowMethod<I1>& Pmul, const MulG1& xPmul, const mcl::fp::SignedWindowMethod<I2>& Qmul, const MulG2& yQmul)
 	{
 		const Fr& c = zkp.d_[0];
 		const Fr& sp = zkp.d_[1];
 		const Fr& ss = zkp.d_[2];
 		const Fr& sm = zkp.d_[3];
-		G1 R1, R2, X1;
-		G2 R3, R4, X2;
-		ElGamalEnc(R1, R2, sm, Pmul, xPmul, &sp);
+		G1 X1;
+		G2 X2;
+		ElGamalEnc(R12[0], R12[1], sm, Pmul, xPmul, &sp);
 		G1::mul(X1, S1, c);
-		R1 -= X1;
+		R12[0] -= X1;
 		G1::mul(X1, T1, c);
-		R2 -= X1;
-		ElGamalEnc(R3, R4, sm, Qmul, yQmul, &ss);
+		R12[1] -= X1;
+		ElGamalEnc(R34[0], R34[1], sm, Qmul, yQmul, &ss);
 		G2::mul(X2, S2, c);
-		R3 -= X2;
+		R34[0] -= X2;
 		G2::mul(X2, T2, c);
-		R4 -= X2;
+		R34[1] -= X2;
+	}
+	template<class G1, class G2>
+	static bool checkZkpEq(const ZkpEq& zkp, const G1& S1, const G1& T1, const G2& S2, const G2& T2, const G1 R12[2], const G2 R34[2])
+	{
+		const Fr& c = zkp.d_[0];
 		Fr c2;
 		local::Hash hash;
-		hash << S1 << T1 << S2 << T2 << R1 << R2 << R3 << R4;
+		hash << S1 << T1 << S2 << T2 << R12[0] << R12[1] << R34[0] << R34[1];
 		hash.get(c2);
 		return c == c2;
 	}
+	template<class G1, class G2, class I1, class I2, class MulG1, class MulG2>
+	static bool verifyZkpEq(const ZkpEq& zkp, const G1& S1, const G1& T1, const G2& S2, const G2& T2, const mcl::fp::SignedWindowMethod<I1>& Pmul, const MulG1& xPmul, const mcl::fp::SignedWindowMethod<I2>& Qmul, const MulG2& yQmul)
+	{
+		G1 R12[2];
+		G2 R34[2];
+		commitZkpEq(R12, R34, zkp, S1, T1, S2, T2, Pmul, xPmul, Qmul, yQmul);
+		return checkZkpEq(zkp, S1, T1, S2, T2, R12, R34);
+	}
 	/*
 		encRand1, encRand2 are random values use for ElGamalEnc()
 	*/
 	template<class G1, class G2, class I1, class I2, class MulG1, class MulG2>
-	static bool makeZkpBinEq(ZkpBinEq& zkp, G1& S1, G1& T1, G2& S2, G2& T2, int m, const mcl::fp::WindowMethod<I1>& Pmul, const MulG1& xPmul, const mcl::fp::WindowMethod<I2>& Qmul, const MulG2& yQmul)
+	static bool makeZkpBinEq(ZkpBinEq& zkp, G1& S1, G1& T1, G2& S2, G2& T2, int m, const mcl::fp::SignedWindowMethod<I1>& Pmul, const MulG1& xPmul, const mcl::fp::SignedWindowMethod<I2>& Qmul, const MulG2& yQmul)
 	{
 		if (m != 0 && m != 1) return false;
 		Fr *d = &zkp.d_[0];
@@ -1339,48 +1546,270 @@ private:
 		sm += rm;
 		return true;
 	}
+	// R1_4[] = { R1[0], R1[1], R2[0], R2[1], R3, R4 }, R56[] = { R5, R6 }
 	template<class G1, class G2, class I1, class I2, class MulG1, class MulG2>
-	static bool verifyZkpBinEq(const ZkpBinEq& zkp, const G1& S1, const G1& T1, const G2& S2, const G2& T2, const mcl::fp::WindowMethod<I1>& Pmul, const MulG1& xPmul, const mcl::fp::WindowMethod<I2>& Qmul, const MulG2& yQmul)
+	static void commitZkpBinEq(G1 R1_4[6], G2 R56[2], const ZkpBinEq& zkp, const G1& S1, const G1& T1, const G2& S2, const G2& T2, const mcl::fp::SignedWindowMethod<I1>& Pmul, const MulG1& xPmul, const mcl::fp::SignedWindowMethod<I2>& Qmul, const MulG2& yQmul)
 	{
 		const Fr *d = &zkp.d_[0];
 		const Fr *spm = &zkp.d_[2];
 		const Fr& ss = zkp.d_[4];
 		const Fr& sp = zkp.d_[5];
 		const Fr& sm = zkp.d_[6];
-		G1 R1[2], R2[2], X1;
+		G1 *R1 = &R1_4[0];
+		G1 *R2 = &R1_4[2];
+		G1& R3 = R1_4[4];
+		G1& R4 = R1_4[5];
+		G2& R5 = R56[0];
+		G2& R6 = R56[1];
+		Fr c;
+		Fr::add(c, d[0], d[1]);
+		/*
+			dT[i] = d[i] T1, dS[i] = d[i] S1
+			c T1 = dT[0] + dT[1], c S1 = dS[0] + dS[1] because c = d[0] + d[1]
+			d[1](S1 - P) = dS[1] - d[1] P
+		*/
+		G1 dT[2], dS[2], X1;
 		for (int i = 0; i < 2; i++) {
+			G1::mul(dT[i], T1, d[i]);
+			G1::mul(dS[i], S1, d[i]);
 			Pmul.mul(static_cast<I1&>(R1[i]), spm[i]);
-			G1::mul(X1, T1, d[i]);
-			R1[i] -= X1;
+			R1[i] -= dT[i];
 		}
 		xPmul.mul(R2[0], spm[0]);
-		G1::mul(X1, S1, d[0]);
-		R2[0] -= X1;
+		R2[0] -= dS[0];
 		xPmul.mul(R2[1], spm[1]);
-		G1::sub(X1, S1, P_);
-		G1::mul(X1, X1, d[1]);
-		R2[1] -= X1;
-		Fr c;
-		Fr::add(c, d[0], d[1]);
-		G1 R3, R4;
-		G2 R5, R6;
+		R2[1] -= dS[1];
+		Pmul.mul(static_cast<I1&>(X1), d[1]);
+		R2[1] += X1;
 		ElGamalEnc(R4, R3, sm, Pmul, xPmul, &sp);
-		G1::mul(X1, T1, c);
-		R3 -= X1;
-		G1::mul(X1, S1, c);
-		R4 -= X1;
+		R3 -= dT[0];
+		R3 -= dT[1];
+		R4 -= dS[0];
+		R4 -= dS[1];
 		ElGamalEnc(R6, R5, sm, Qmul, yQmul, &ss);
 		G2 X2;
 		G2::mul(X2, T2, c);
 		R5 -= X2;
 		G2::mul(X2, S2, c);
 		R6 -= X2;
+	}
+	template<class G1, class G2>
+	static bool checkZkpBinEq(const ZkpBinEq& zkp, const G1& S1, const G1& T1, const G1 R1_4[6], const G2 R56[2])
+	{
+		const Fr *d = &zkp.d_[0];
+		Fr c;
+		Fr::add(c, d[0], d[1]);
 		Fr c2;
 		local::Hash hash;
-		hash << S1 << T1 << R1[0] << R1[1] << R2[0] << R2[1] << R3 << R4 << R5 << R6;
+		hash << S1 << T1;
+		for (int i = 0; i < 6; i++) {
+			hash << R1_4[i];
+		}
+		hash << R56[0] << R56[1];
 		hash.get(c2);
 		return c == c2;
 	}
+	template<class G1, class G2, class I1, class I2, class MulG1, class MulG2>
+	static bool verifyZkpBinEq(const ZkpBinEq& zkp, const G1& S1, const G1& T1, const G2& S2, const G2& T2, const mcl::fp::SignedWindowMethod<I1>& Pmul, const MulG1& xPmul, const mcl::fp::SignedWindowMethod<I2>& Qmul, const MulG2& yQmul)
+	{
+		G1 R1_4[6];
+		G2 R56[2];
+		commitZkpBinEq(R1_4, R56, zkp, S1, T1, S2, T2, Pmul, xPmul, Qmul, yQmul);
+		return checkZkpBinEq(zkp, S1, T1, R1_4, R56);
+	}
+	/*
+		the points of the i-th proof are stored in A[i * na, (i + 1) * na) and B[i * nb, (i + 1) * nb)
+		the first points are the ciphertext and the rest are the commitments
+	*/
+	template<class G, class I, class MulG>
+	struct ZkpBinVerifier {
+		typedef G Ga;
+		typedef G Gb;
+		const CipherTextAT<G> *c;
+		const ZkpBin *zkp;
+		const G& P;
+		const mcl::fp::SignedWindowMethod<I>& Pmul;
+		const MulG& xPmul;
+		size_t na, nb;
+		ZkpBinVerifier(const CipherTextAT<G> *c, const ZkpBin *zkp, const G& P, const mcl::fp::SignedWindowMethod<I>& Pmul, const MulG& xPmul)
+			: c(c), zkp(zkp), P(P), Pmul(Pmul), xPmul(xPmul), na(6), nb(0) {}
+		void commit(G *A, G *, size_t i) const
+		{
+			A[0] = c[i].getS();
+			A[1] = c[i].getT();
+			commitZkpBin(A + 2, A[0], A[1], P, zkp[i], Pmul, xPmul);
+		}
+		bool check(const G *A, const G *, size_t i) const
+		{
+			return checkZkpBin(A[0], A[1], A + 2, zkp[i]);
+		}
+	};
+	template<class I, class MulG>
+	struct ZkpSetVerifier {
+		typedef G1 Ga;
+		typedef G1 Gb;
+		const CipherTextG1 *c;
+		const Fr *zkp;
+		const int *mVec;
+		size_t mSize;
+		G1 xP; // normalized
+		const mcl::fp::SignedWindowMethod<I>& Pmul;
+		const MulG& xPmul;
+		size_t na, nb;
+		ZkpSetVerifier(const CipherTextG1 *c, const Fr *zkp, const int *mVec, size_t mSize, const G1& xP, const mcl::fp::SignedWindowMethod<I>& Pmul, const MulG& xPmul)
+			: c(c), zkp(zkp), mVec(mVec), mSize(mSize), xP(xP), Pmul(Pmul), xPmul(xPmul), na(2 + mSize * 2), nb(0)
+		{
+			this->xP.normalize();
+		}
+		void commit(G1 *A, G1 *, size_t i) const
+		{
+			A[0] = c[i].getS();
+			A[1] = c[i].getT();
+			commitZkpSet(A + 2, A[0], A[1], zkp + i * mSize * 2, mVec, mSize, Pmul, xPmul);
+		}
+		bool check(const G1 *A, const G1 *, size_t i) const
+		{
+			return checkZkpSet(xP, A[0], A[1], A + 2, zkp + i * mSize * 2, mSize);
+		}
+	};
+	template<class I1, class I2, class MulG1, class MulG2>
+	struct ZkpEqVerifier {
+		typedef G1 Ga;
+		typedef G2 Gb;
+		const CipherTextG1 *c1;
+		const CipherTextG2 *c2;
+		const ZkpEq *zkp;
+		const mcl::fp::SignedWindowMethod<I1>& Pmul;
+		const MulG1& xPmul;
+		const mcl::fp::SignedWindowMethod<I2>& Qmul;
+		const MulG2& yQmul;
+		size_t na, nb;
+		ZkpEqVerifier(const CipherTextG1 *c1, const CipherTextG2 *c2, const ZkpEq *zkp, const mcl::fp::SignedWindowMethod<I1>& Pmul, const MulG1& xPmul, const mcl::fp::SignedWindowMethod<I2>& Qmul, const MulG2& yQmul)
+			: c1(c1), c2(c2), zkp(zkp), Pmul(Pmul), xPmul(xPmul), Qmul(Qmul), yQmul(yQmul), na(4), nb(4) {}
+		void commit(G1 *A, G2 *B, size_t i) const
+		{
+			A[0] = c1[i].getS();
+			A[1] = c1[i].getT();
+			B[0] = c2[i].getS();
+			B[1] = c2[i].getT();
+			commitZkpEq(A + 2, B + 2, zkp[i], A[0], A[1], B[0], B[1], Pmul, xPmul, Qmul, yQmul);
+		}
+		bool check(const G1 *A, const G2 *B, size_t i) const
+		{
+			return checkZkpEq(zkp[i], A[0], A[1], B[0], B[1], A + 2, B + 2);
+		}
+	};
+	template<class I1, class I2, class MulG1, class MulG2>
+	struct ZkpBinEqVerifier {
+		typedef G1 Ga;
+		typedef G2 Gb;
+		const CipherTextG1 *c1;
+		const CipherTextG2 *c2;
+		const ZkpBinEq *zkp;
+		const mcl::fp::SignedWindowMethod<I1>& Pmul;
+		const MulG1& xPmul;
+		const mcl::fp::SignedWindowMethod<I2>& Qmul;
+		const MulG2& yQmul;
+		size_t na, nb;
+		ZkpBinEqVerifier(const CipherTextG1 *c1, const CipherTextG2 *c2, const ZkpBinEq *zkp, const mcl::fp::SignedWindowMethod<I1>& Pmul, const MulG1& xPmul, const mcl::fp::SignedWindowMethod<I2>& Qmul, const MulG2& yQmul)
+			: c1(c1), c2(c2), zkp(zkp), Pmul(Pmul), xPmul(xPmul), Qmul(Qmul), yQmul(yQmul), na(8), nb(2) {}
+		void commit(G1 *A, G2 *B, size_t i) const
+		{
+			A[0] = c1[i].getS();
+			A[1] = c1[i].getT();
+			commitZkpBinEq(A + 2, B, zkp[i], A[0], A[1], c2[i].getS(), c2[i].getT(), Pmul, xPmul, Qmul, yQmul);
+		}
+		bool check(const G1 *A, const G2 *B, size_t i) const
+		{
+			return checkZkpBinEq(zkp[i], A[0], A[1], A + 2, B);
+		}
+	};
+	template<class V>
+	struct ZkpCommitVecF {
+		const V& v;
+		typename V::Ga *A;
+		typename V::Gb *B;
+		size_t offset;
+		ZkpCommitVecF(const V& v, typename V::Ga *A, typename V::Gb *B, size_t offset) : v(v), A(A), B(B), offset(offset) {}
+		void operator()(size_t begin, size_t end) const
+		{
+			for (size_t i = begin; i < end; i++) {
+				v.commit(A + i * v.na, B + i * v.nb, offset + i);
+			}
+		}
+	};
+	template<class V>
+	struct ZkpCheckVecF {
+		const V& v;
+		const typename V::Ga *A;
+		const typename V::Gb *B;
+		char *ok;
+		size_t offset;
+		ZkpCheckVecF(const V& v, const typename V::Ga *A, const typename V::Gb *B, char *ok, size_t offset) : v(v), A(A), B(B), ok(ok), offset(offset) {}
+		void operator()(size_t begin, size_t end) const
+		{
+			for (size_t i = begin; i < end; i++) {
+				ok[i] = v.check(A + i * v.na, B + i * v.nb, offset + i);
+			}
+		}
+	};
+	/*
+		verify n proofs by V
+		the ciphertexts and the commitments of all proofs are normalized at once before hashing them
+		because serializing a point in Jacobi coordinates needs an inversion for each point
+		okVec[i] = the result of the i-th proof if okVec is not null
+		return true if all the proofs are valid
+	*/
+	template<class V>
+	static bool verifyZkpVec(const V& v, size_t n, bool *okVec, size_t cpuN)
+	{
+		typedef typename V::Ga Ga;
+		typedef typename V::Gb Gb;
+		if (n == 0) return true;
+		const size_t blockN = fp::min_<size_t>(n, 1024);
+		std::vector<Ga> A(blockN * v.na);
+		std::vector<Gb> B(blockN * v.nb + 1); // + 1 for nb = 0
+		std::vector<char> ok(blockN);
+		bool ret = true;
+		for (size_t done = 0; done < n; done += blockN) {
+			const size_t m = fp::min_<size_t>(n - done, blockN);
+			mcl::fp::parallelFor(ZkpCommitVecF<V>(v, &A[0], &B[0], done), m, cpuN);
+			Ga::normalizeVec(&A[0], &A[0], m * v.na);
+			Gb::normalizeVec(&B[0], &B[0], m * v.nb);
+			mcl::fp::parallelFor(ZkpCheckVecF<V>(v, &A[0], &B[0], &ok[0], done), m, cpuN);
+			for (size_t i = 0; i < m; i++) {
+				if (okVec) okVec[done + i] = ok[i] != 0;
+				if (!ok[i]) ret = false;
+			}
+		}
+		return ret;
+	}
+	template<class G, class I, class MulG>
+	static bool verifyZkpBinVec(const CipherTextAT<G> *c, const ZkpBin *zkp, size_t n, bool *okVec, size_t cpuN, const G& P, const mcl::fp::SignedWindowMethod<I>& Pmul, const MulG& xPmul)
+	{
+		return verifyZkpVec(ZkpBinVerifier<G, I, MulG>(c, zkp, P, Pmul, xPmul), n, okVec, cpuN);
+	}
+	template<class I, class MulG>
+	static bool verifyZkpSetVec(const CipherTextG1 *c, const Fr *zkp, const int *mVec, size_t mSize, size_t n, bool *okVec, size_t cpuN, const G1& xP, const mcl::fp::SignedWindowMethod<I>& Pmul, const MulG& xPmul)
+	{
+		if (!check_mVec(mVec, mSize)) {
+			if (okVec) {
+				for (size_t i = 0; i < n; i++) okVec[i] = false;
+			}
+			return n == 0;
+		}
+		return verifyZkpVec(ZkpSetVerifier<I, MulG>(c, zkp, mVec, mSize, xP, Pmul, xPmul), n, okVec, cpuN);
+	}
+	template<class I1, class I2, class MulG1, class MulG2>
+	static bool verifyZkpEqVec(const CipherTextG1 *c1, const CipherTextG2 *c2, const ZkpEq *zkp, size_t n, bool *okVec, size_t cpuN, const mcl::fp::SignedWindowMethod<I1>& Pmul, const MulG1& xPmul, const mcl::fp::SignedWindowMethod<I2>& Qmul, const MulG2& yQmul)
+	{
+		return verifyZkpVec(ZkpEqVerifier<I1, I2, MulG1, MulG2>(c1, c2, zkp, Pmul, xPmul, Qmul, yQmul), n, okVec, cpuN);
+	}
+	template<class I1, class I2, class MulG1, class MulG2>
+	static bool verifyZkpBinEqVec(const CipherTextG1 *c1, const CipherTextG2 *c2, const ZkpBinEq *zkp, size_t n, bool *okVec, size_t cpuN, const mcl::fp::SignedWindowMethod<I1>& Pmul, const MulG1& xPmul, const mcl::fp::SignedWindowMethod<I2>& Qmul, const MulG2& yQmul)
+	{
+		return verifyZkpVec(ZkpBinEqVerifier<I1, I2, MulG1, MulG2>(c1, c2, zkp, Pmul, xPmul, Qmul, yQmul), n, okVec, cpuN);
+	}
 	/*
 		common method for PublicKey and PrecomputedPublicKey
 	*/
@@ -1421,6 +1850,90 @@ private:
 				enc(c.a_, m);
 			}
 		}
+		/*
+			c[i] = Enc(m[i]) for i in [0, n)
+			the multiples of fixed bases are computed by window tables and
+			c[] of G1/G2 are normalized at once
+		*/
+		template<class INT>
+		void encVec(CipherTextG1 *c, const INT *m, size_t n) const
+		{
+			static_cast<const T&>(*this).encG1Vec(c, m, n, 1);
+		}
+		template<class INT>
+		void encVec(CipherTextG2 *c, const INT *m, size_t n) const
+		{
+			static_cast<const T&>(*this).encG2Vec(c, m, n, 1);
+		}
+		template<class INT>
+		void encVec(CipherTextGT *c, const INT *m, size_t n) const
+		{
+			static_cast<const T&>(*this).encGTVec(c, m, n, 1);
+		}
+		// multi thread version of encVec (enabled if MCL_USE_OMP is defined)
+		// the num of thread is automatically detected if cpuN = 0
+		template<class INT>
+		void encVecMT(CipherTextG1 *c, const INT *m, size_t n, size_t cpuN = 0) const
+		{
+			static_cast<const T&>(*this).encG1Vec(c, m, n, cpuN);
+		}
+		template<class INT>
+		void encVecMT(CipherTextG2 *c, const INT *m, size_t n, size_t cpuN = 0) const
+		{
+			static_cast<const T&>(*this).encG2Vec(c, m, n, cpuN);
+		}
+		template<class INT>
+		void encVecMT(CipherTextGT *c, const INT *m, size_t n, size_t cpuN = 0) const
+		{
+			static_cast<const T&>(*this).encGTVec(c, m, n, cpuN);
+		}
+		/*
+			verify n proofs at once
+			okVec[i] = verify(c[i], zkp[i]) if okVec is not null
+			return true if all the proofs are valid
+		*/
+		bool verifyVec(const CipherTextG1 *c, const ZkpBin *zkp, size_t n, bool *okVec = 0) const
+		{
+			return static_cast<const T&>(*this).verifyZkpBinG1Vec(c, zkp, n, okVec, 1);
+		}
+		bool verifyVec(const CipherTextG2 *c, const ZkpBin *zkp, size_t n, bool *okVec = 0) const
+		{
+			return static_cast<const T&>(*this).verifyZkpBinG2Vec(c, zkp, n, okVec, 1);
+		}
+		// zkp has (n * mSize * 2) elements
+		bool verifyVec(const CipherTextG1 *c, const Fr *zkp, const int *mVec, size_t mSize, size_t n, bool *okVec = 0) const
+		{
+			return static_cast<const T&>(*this).verifyZkpSetVec(c, zkp, mVec, mSize, n, okVec, 1);
+		}
+		bool verifyVec(const CipherTextG1 *c1, const CipherTextG2 *c2, const ZkpEq *zkp, size_t n, bool *okVec = 0) const
+		{
+			return static_cast<const T&>(*this).verifyZkpEqVec(c1, c2, zkp, n, okVec, 1);
+		}
+		bool verifyVec(const CipherTextG1 *c1, const CipherTextG2 *c2, const ZkpBinEq *zkp, size_t n, bool *okVec = 0) const
+		{
+			return static_cast<const T&>(*this).verifyZkpBinEqVec(c1, c2, zkp, n, okVec, 1);
+		}
+		// multi thread version of verifyVec
+		bool verifyVecMT(const CipherTextG1 *c, const ZkpBin *zkp, size_t n, bool *okVec = 0, size_t cpuN = 0) const
+		{
+			return static_cast<const T&>(*this).verifyZkpBinG1Vec(c, zkp, n, okVec, cpuN);
+		}
+		bool verifyVecMT(const CipherTextG2 *c, const ZkpBin *zkp, size_t n, bool *okVec = 0, size_t cpuN = 0) const
+		{
+			return static_cast<const T&>(*this).verifyZkpBinG2Vec(c, zkp, n, okVec, cpuN);
+		}
+		bool verifyVecMT(const CipherTextG1 *c, const Fr *zkp, const int *mVec, size_t mSize, size_t n, bool *okVec = 0, size_t cpuN = 0) const
+		{
+			return static_cast<const T&>(*this).verifyZkpSetVec(c, zkp, mVec, mSize, n, okVec, cpuN);
+		}
+		bool verifyVecMT(const CipherTextG1 *c1, const CipherTextG2 *c2, const ZkpEq *zkp, size_t n, bool *okVec = 0, size_t cpuN = 0) const
+		{
+			return static_cast<const T&>(*this).verifyZkpEqVec(c1, c2, zkp, n, okVec, cpuN);
+		}
+		bool verifyVecMT(const CipherTextG1 *c1, const CipherTextG2 *c2, const ZkpBinEq *zkp, size_t n, bool *okVec = 0, size_t cpuN = 0) const
+		{
+			return static_cast<const T&>(*this).verifyZkpBinEqVec(c1, c2, zkp, n, okVec, cpuN);
+		}
 		/*
 			reRand method is for circuit privacy
 		*/
@@ -1481,6 +1994,106 @@ private:
 			cm.isMultiplied_ = true;
 			convert(cm.m_, ca.a_);
 		}
+		/*
+			c[i] = reRand(c[i]) for i in [0, n)
+			Enc(0) are made by encVec with the fixed-base tables and
+			added by addVec
+		*/
+		template<class CT>
+		void reRandVecT(CT *c, size_t n, size_t cpuN) const
+		{
+			if (n == 0) return;
+			std::vector<int64_t> zero(n);
+			std::vector<CT> c0(n);
+			encVecMT(&c0[0], &zero[0], n, cpuN);
+			CT::addVecMT(c, c, &c0[0], n, cpuN);
+		}
+		void reRandVec(CipherTextG1 *c, size_t n) const { reRandVecT(c, n, 1); }
+		void reRandVec(CipherTextG2 *c, size_t n) const { reRandVecT(c, n, 1); }
+		void reRandVec(CipherTextGT *c, size_t n) const { reRandVecT(c, n, 1); }
+		// multi thread version of reRandVec (enabled if MCL_USE_OMP is defined)
+		// the num of thread is automatically detected if cpuN = 0
+		void reRandVecMT(CipherTextG1 *c, size_t n, size_t cpuN = 0) const { reRandVecT(c, n, cpuN); }
+		void reRandVecMT(CipherTextG2 *c, size_t n, size_t cpuN = 0) const { reRandVecT(c, n, cpuN); }
+		void reRandVecMT(CipherTextGT *c, size_t n, size_t cpuN = 0) const { reRandVecT(c, n, cpuN); }
+		/*
+			cm[i] = convert(P[i], P[n + i]) for i in [begin, end)
+			P[] = (S[], T[]) are normalized
+		*/
+		struct ConvertG1VecF {
+			CipherTextGT *cm;
+			const G1 *P;
+			size_t n;
+			ConvertG1VecF(CipherTextGT *cm, const G1 *P, size_t n) : cm(cm), P(P), n(n) {}
+			void operator()(size_t begin, size_t end) const
+			{
+				for (size_t i = begin; i < end; i++) {
+					GT *g = cm[i].g_;
+					precomputedMillerLoop(g[0], P[i], Qcoeff_);
+					finalExp(g[0], g[0]);
+					precomputedMillerLoop(g[2], P[n + i], Qcoeff_);
+					finalExp(g[2], g[2]);
+					g[1] = g[3] = 1;
+				}
+			}
+		};
+		struct ConvertG2VecF {
+			CipherTextGT *cm;
+			const G2 *Q;
+			size_t n;
+			ConvertG2VecF(CipherTextGT *cm, const G2 *Q, size_t n) : cm(cm), Q(Q), n(n) {}
+			void operator()(size_t begin, size_t end) const
+			{
+				for (size_t i = begin; i < end; i++) {
+					GT *g = cm[i].g_;
+					millerLoop(g[0], P_, Q[i]);
+					finalExp(g[0], g[0]);
+					millerLoop(g[1], P_, Q[n + i]);
+					finalExp(g[1], g[1]);
+					g[2] = g[3] = 1;
+				}
+			}
+		};
+		/*
+			cm[i] = convert(c[i]) for i in [0, n)
+			the points of each block are normalized at once before the Miller loops
+		*/
+		template<class G, class F, class CT>
+		static void convertVecT(CipherTextGT *cm, const CT *c, size_t n, size_t cpuN)
+		{
+			const size_t blockN = 1024;
+			std::vector<G> P(fp::min_(n, blockN) * 2);
+			while (n > 0) {
+				const size_t m = fp::min_(n, blockN);
+				for (size_t i = 0; i < m; i++) {
+					P[i] = c[i].getS();
+					P[m + i] = c[i].getT();
+				}
+				G::normalizeVec(&P[0], &P[0], m * 2);
+				mcl::fp::parallelFor(F(cm, &P[0], m), m, cpuN);
+				cm += m;
+				c += m;
+				n -= m;
+			}
+		}
+		void convertVec(CipherTextGT *cm, const CipherTextG1 *c, size_t n) const
+		{
+			convertVecT<G1, ConvertG1VecF>(cm, c, n, 1);
+		}
+		void convertVec(CipherTextGT *cm, const CipherTextG2 *c, size_t n) const
+		{
+			convertVecT<G2, ConvertG2VecF>(cm, c, n, 1);
+		}
+		// multi thread version of convertVec (enabled if MCL_USE_OMP is defined)
+		// the num of thread is automatically detected if cpuN = 0
+		void convertVecMT(CipherTextGT *cm, const CipherTextG1 *c, size_t n, size_t cpuN = 0) const
+		{
+			convertVecT<G1, ConvertG1VecF>(cm, c, n, cpuN);
+		}
+		void convertVecMT(CipherTextGT *cm, const CipherTextG2 *c, size_t n, size_t cpuN = 0) const
+		{
+			convertVecT<G2, ConvertG2VecF>(cm, c, n, cpuN);
+		}
 	};
 public:
 	class PublicKey : public fp::Serializable<PublicKey,
@@ -1518,6 +2131,148 @@ public:
 			const MulG<G2> yQmul(yQ_);
 			ElGamalEnc(c.S_, c.T_, m, QhashTbl_.getWM(), yQmul);
 		}
+		/*
+			MulG for a base used n times
+			make a temporary window table of the base if n is large enough
+		*/
+		template<class G>
+		struct MulGVec {
+			const MulG<G> mulG;
+			mcl::fp::WindowMethod<G> wm;
+			bool useWM;
+			MulGVec(const G& base, size_t n) : mulG(base), useWM(false)
+			{
+				const size_t winSize = local::getWinSizeForVec(n);
+				if (winSize == 0) return;
+				wm.init(base, Fr::getBitSize(), winSize);
+				useWM = true;
+			}
+			template<class INT>
+			void mul(G& out, const INT& m) const
+			{
+				if (useWM) {
+					wm.mul(out, m);
+				} else {
+					mulG.mul(out, m);
+				}
+			}
+		};
+		template<class INT>
+		void encG1Vec(CipherTextG1 *c, const INT *m, size_t n, size_t cpuN) const
+		{
+			const MulGVec<G1> xPmul(xP_, n);
+			ElGamalEncVec(c, m, n, PhashTbl_.getWM(), xPmul, cpuN);
+		}
+		template<class INT>
+		void encG2Vec(CipherTextG2 *c, const INT *m, size_t n, size_t cpuN) const
+		{
+			const MulGVec<G2> yQmul(yQ_, n);
+			ElGamalEncVec(c, m, n, QhashTbl_.getWM(), yQmul, cpuN);
+		}
+		bool verifyZkpBinG1Vec(const CipherTextG1 *c, const ZkpBin *zkp, size_t n, bool *okVec, size_t cpuN) const
+		{
+			const MulGVec<G1> xPmul(xP_, n * 2);
+			return verifyZkpBinVec(c, zkp, n, okVec, cpuN, P_, PhashTbl_.getWM(), xPmul);
+		}
+		bool verifyZkpBinG2Vec(const CipherTextG2 *c, const ZkpBin *zkp, size_t n, bool *okVec, size_t cpuN) const
+		{
+			const MulGVec<G2> yQmul(yQ_, n * 2);
+			return verifyZkpBinVec(c, zkp, n, okVec, cpuN, Q_, QhashTbl_.getWM(), yQmul);
+		}
+		bool verifyZkpSetVec(const CipherTextG1 *c, const Fr *zkp, const int *mVec, size_t mSize, size_t n, bool *okVec, size_t cpuN) const
+		{
+			const MulGVec<G1> xPmul(xP_, n * mSize);
+			return SHET::verifyZkpSetVec(c, zkp, mVec, mSize, n, okVec, cpuN, P_, PhashTbl_.getWM(), xPmul);
+		}
+		bool verifyZkpEqVec(const CipherTextG1 *c1, const CipherTextG2 *c2, const ZkpEq *zkp, size_t n, bool *okVec, size_t cpuN) const
+		{
+			const MulGVec<G1> xPmul(xP_, n);
+			const MulGVec<G2> yQmul(yQ_, n);
+			return SHET::verifyZkpEqVec(c1, c2, zkp, n, okVec, cpuN, PhashTbl_.getWM(), xPmul, QhashTbl_.getWM(), yQmul);
+		}
+		bool verifyZkpBinEqVec(const CipherTextG1 *c1, const CipherTextG2 *c2, const ZkpBinEq *zkp, size_t n, bool *okVec, size_t cpuN) const
+		{
+			const MulGVec<G1> xPmul(xP_, n * 3);
+			const MulGVec<G2> yQmul(yQ_, n);
+			return SHET::verifyZkpBinEqVec(c1, c2, zkp, n, okVec, cpuN, PhashTbl_.getWM(), xPmul, QhashTbl_.getWM(), yQmul);
+		}
+		/*
+			P[i * 2 + 0] = ra xP + m P
+			P[i * 2 + 1] = rb P - rc xP
+			where (ra, rb, rc) = r[i * 3 + (0, 1, 2)]
+		*/
+		template<class INT, class MulG1>
+		struct EncGTVecPointF {
+			G1 *P;
+			const INT *m;
+			const Fr *r;
+			const MulG1& xPmul;
+			EncGTVecPointF(G1 *P, const INT *m, const Fr *r, const MulG1& xPmul) : P(P), m(m), r(r), xPmul(xPmul) {}
+			void operator()(size_t begin, size_t end) const
+			{
+				for (size_t i = begin; i < end; i++) {
+					G1& P1 = P[i * 2 + 0];
+					G1& P2 = P[i * 2 + 1];
+					const Fr *ri = &r[i * 3];
+					G1 T;
+					xPmul.mul(P1, ri[0]);
+					if (m[i] != 0) {
+						PhashTbl_.mulByWindowMethod(T, m[i]);
+						P1 += T;
+					}
+					PhashTbl_.mulByWindowMethod(P2, ri[1]);
+					xPmul.mul(T, ri[2]);
+					P2 -= T;
+				}
+			}
+		};
+		/*
+			c[i] = (e(P1, Q) e(P2, yQ), e^rb, e^ra, e^rc)
+		*/
+		struct EncGTVecPairingF {
+			CipherTextGT *c;
+			const G1 *P;
+			const Fr *r;
+			const Fp6 *yQcoeff;
+			EncGTVecPairingF(CipherTextGT *c, const G1 *P, const Fr *r, const Fp6 *yQcoeff) : c(c), P(P), r(r), yQcoeff(yQcoeff) {}
+			void operator()(size_t begin, size_t end) const
+			{
+				for (size_t i = begin; i < end; i++) {
+					GT *g = c[i].g_;
+					const Fr *ri = &r[i * 3];
+					precomputedMillerLoop2(g[0], P[i * 2 + 0], Qcoeff_.data(), P[i * 2 + 1], yQcoeff);
+					finalExp(g[0], g[0]);
+					ePQhashTbl_.mulByWindowMethod(g[1], ri[1]);
+					ePQhashTbl_.mulByWindowMethod(g[2], ri[0]);
+					ePQhashTbl_.mulByWindowMethod(g[3], ri[2]);
+				}
+			}
+		};
+		template<class INT, class MulG1>
+		void encGTVecByMulG1(CipherTextGT *c, const INT *m, size_t n, size_t cpuN, const MulG1& xPmul) const
+		{
+			std::vector<Fr> r(n * 3);
+			for (size_t i = 0; i < r.size(); i++) {
+				r[i].setRand();
+			}
+			std::vector<G1> P(n * 2);
+			mcl::fp::parallelFor(EncGTVecPointF<INT, MulG1>(&P[0], m, &r[0], xPmul), n, cpuN);
+			G1::normalizeVec(&P[0], &P[0], n * 2);
+			std::vector<Fp6> yQcoeff;
+			precomputeG2(yQcoeff, yQ_);
+			mcl::fp::parallelFor(EncGTVecPairingF(c, &P[0], &r[0], yQcoeff.data()), n, cpuN);
+		}
+		/*
+			same as encGT for each element,
+			but yQ is precomputed once and the points in G1 are normalized at once
+		*/
+		template<class INT>
+		void encGTVec(CipherTextGT *c, const INT *m, size_t n, size_t cpuN) const
+		{
+			if (n == 0) return;
+			const MulGVec<G1> xPmul(xP_, n * 2);
+			encGTVecByMulG1(c, m, n, cpuN, xPmul);
+		}
 public:
 		void getAuxiliaryForZkpDecGT(AuxiliaryForZkpDecGT& aux) const
 		{
@@ -1768,15 +2523,78 @@ public:
 			ElGamalEnc(c.S_, c.T_, m, QhashTbl_.getWM(), yQwm_);
 		}
 		template<class INT>
+		void encG1Vec(CipherTextG1 *c, const INT *m, size_t n, size_t cpuN) const
+		{
+			ElGamalEncVec(c, m, n, PhashTbl_.getWM(), xPwm_, cpuN);
+		}
+		template<class INT>
+		void encG2Vec(CipherTextG2 *c, const INT *m, size_t n, size_t cpuN) const
+		{
+			ElGamalEncVec(c, m, n, QhashTbl_.getWM(), yQwm_, cpuN);
+		}
+		bool verifyZkpBinG1Vec(const CipherTextG1 *c, const ZkpBin *zkp, size_t n, bool *okVec, size_t cpuN) const
+		{
+			return verifyZkpBinVec(c, zkp, n, okVec, cpuN, P_, PhashTbl_.getWM(), xPwm_);
+		}
+		bool verifyZkpBinG2Vec(const CipherTextG2 *c, const ZkpBin *zkp, size_t n, bool *okVec, size_t cpuN) const
+		{
+			return verifyZkpBinVec(c, zkp, n, okVec, cpuN, Q_, QhashTbl_.getWM(), yQwm_);
+		}
+		bool verifyZkpSetVec(const CipherTextG1 *c, const Fr *zkp, const int *mVec, size_t mSize, size_t n, bool *okVec, size_t cpuN) const
+		{
+			return SHET::verifyZkpSetVec(c, zkp, mVec, mSize, n, okVec, cpuN, xPwm_.tbl_[1], PhashTbl_.getWM(), xPwm_);
+		}
+		bool verifyZkpEqVec(const CipherTextG1 *c1, const CipherTextG2 *c2, const ZkpEq *zkp, size_t n, bool *okVec, size_t cpuN) const
+		{
+			return SHET::verifyZkpEqVec(c1, c2, zkp, n, okVec, cpuN, PhashTbl_.getWM(), xPwm_, QhashTbl_.getWM(), yQwm_);
+		}
+		bool verifyZkpBinEqVec(const CipherTextG1 *c1, const CipherTextG2 *c2, const ZkpBinEq *zkp, size_t n, bool *okVec, size_t cpuN) const
+		{
+			return SHET::verifyZkpBinEqVec(c1, c2, zkp, n, okVec, cpuN, PhashTbl_.getWM(), xPwm_, QhashTbl_.getWM(), yQwm_);
+		}
+		template<class INT>
 		void encGT(CipherTextGT& c, const INT& m) const
+		{
+			Fr r[3];
+			for (int i = 0; i < 3; i++) {
+				r[i].setRand();
+			}
+			encGTwithRand(c, m, r);
+		}
+		template<class INT>
+		struct EncGTVecF {
+			const PrecomputedPublicKey& ppub;
+			CipherTextGT *c;
+			const INT *m;
+			const Fr *r;
+			EncGTVecF(const PrecomputedPublicKey& ppub, CipherTextGT *c, const INT *m, const Fr *r) : ppub(ppub), c(c), m(m), r(r) {}
+			void operator()(size_t begin, size_t end) const
+			{
+				for (size_t i = begin; i < end; i++) {
+					ppub.encGTwithRand(c[i], m[i], &r[i * 3]);
+				}
+			}
+		};
+		template<class INT>
+		void encGTVec(CipherTextGT *c, const INT *m, size_t n, size_t cpuN) const
+		{
+			if (n == 0) return;
+			std::vector<Fr> r(n * 3);
+			for (size_t i = 0; i < r.size(); i++) {
+				r[i].setRand();
+			}
+			mcl::fp::parallelFor(EncGTVecF<INT>(*this, c, m, &r[0]), n, cpuN);
+		}
+		// r[] = { ra, rb, rc }
+		template<class INT>
+		void encGTwithRand(CipherTextGT& c, const INT& m, const Fr r[3]) const
 		{
 			/*
 				(s, t, u, v) = (e^m e^(xya), (e^x)^b, (e^y)^c, e^(b + c - a))
 			*/
-			Fr ra, rb, rc;
-			ra.setRand();
-			rb.setRand();
-			rc.setRand();
+			const Fr& ra = r[0];
+			Fr rb = r[1];
+			const Fr& rc = r[2];
 			GT t;
 			ePQhashTbl_.mulByWindowMethod(c.g_[0], m); // e^m
 			mulByWindowMethod(t, exyPQwm_, ra); // (e^xy)^a
@@ -2039,6 +2857,139 @@ public:
 		{
 			mul(z, x.c1_, y.c2_);
 		}
+		/*
+			g[begin * 4 + (0, 1, 2, 3)] = sum_i mulML(x[i], y[i]) for i in the blocks [begin, end)
+			the points of each block are normalized at once and
+			millerLoopVec shares the squaring of the accumulator among the pairs
+		*/
+		struct MulMLVecF {
+			static const size_t blockN = 128;
+			GT *g;
+			const CipherTextG1 *x;
+			const CipherTextG2 *y;
+			size_t n;
+			MulMLVecF(GT *g, const CipherTextG1 *x, const CipherTextG2 *y, size_t n) : g(g), x(x), y(y), n(n) {}
+			void operator()(size_t begin, size_t end) const
+			{
+				GT *out = g + begin * 4;
+				std::vector<G1> P(blockN * 2);
+				std::vector<G2> Q(blockN * 2);
+				for (size_t b = begin; b < end; b++) {
+					const size_t i0 = b * blockN;
+					const size_t m = fp::min_(n - i0, blockN);
+					// P = (S1[], T1[]), Q = (S2[], T2[])
+					for (size_t i = 0; i < m; i++) {
+						P[i] = x[i0 + i].S_;
+						P[m + i] = x[i0 + i].T_;
+						Q[i] = y[i0 + i].S_;
+						Q[m + i] = y[i0 + i].T_;
+					}
+					G1::normalizeVec(&P[0], &P[0], m * 2);
+					G2::normalizeVec(&Q[0], &Q[0], m * 2);
+					const bool initF = b == begin;
+					millerLoopVec(out[0], &P[0], &Q[0], m, initF);
+					millerLoopVec(out[1], &P[0], &Q[m], m, initF);
+					millerLoopVec(out[2], &P[m], &Q[0], m, initF);
+					millerLoopVec(out[3], &P[m], &Q[m], m, initF);
+				}
+			}
+		};
+		/*
+			z = sum_i mul(x[i], y[i]) for i in [0, n)
+			finalExp is called once
+		*/
+		static void mulVec(CipherTextGT& z, const CipherTextG1 *x, const CipherTextG2 *y, size_t n)
+		{
+			mulVecMT(z, x, y, n, 1);
+		}
+		// multi thread version of mulVec (enabled if MCL_USE_OMP is defined)
+		// the num of thread is automatically detected if cpuN = 0
+		static void mulVecMT(CipherTextGT& z, const CipherTextG1 *x, const CipherTextG2 *y, size_t n, size_t cpuN = 0)
+		{
+			if (n == 0) {
+				z.clear();
+				return;
+			}
+			const size_t blockN = MulMLVecF::blockN;
+			const size_t bn = (n + blockN - 1) / blockN;
+			std::vector<GT> g(bn * 4);
+			for (size_t i = 0; i < g.size(); i++) {
+				g[i].setOne();
+			}
+			mcl::fp::parallelFor(MulMLVecF(&g[0], x, y, n), bn, cpuN);
+			for (size_t b = 1; b < bn; b++) {
+				for (int i = 0; i < 4; i++) {
+					if (!g[b * 4 + i].isOne()) g[i] *= g[b * 4 + i];
+				}
+			}
+			finalExp4(z.g_, &g[0]);
+		}
+		struct AddVecF {
+			CipherTextGT *z;
+			const CipherTextGT *x;
+			const CipherTextGT *y;
+			AddVecF(CipherTextGT *z, const CipherTextGT *x, const CipherTextGT *y) : z(z), x(x), y(y) {}
+			void operator()(size_t begin, size_t end) const
+			{
+				for (size_t i = begin; i < end; i++) {
+					add(z[i], x[i], y[i]);
+				}
+			}
+		};
+		// part[b] = sum_i x[i] for i in the block b for b in [begin, end)
+		struct SumVecF {
+			static const size_t blockN = 256;
+			CipherTextGT *part;
+			const CipherTextGT *x;
+			size_t n;
+			SumVecF(CipherTextGT *part, const CipherTextGT *x, size_t n) : part(part), x(x), n(n) {}
+			void operator()(size_t begin, size_t end) const
+			{
+				for (size_t b = begin; b < end; b++) {
+					const size_t i0 = b * blockN;
+					const size_t m = fp::min_(n - i0, blockN);
+					CipherTextGT t = x[i0];
+					for (size_t i = 1; i < m; i++) {
+						add(t, t, x[i0 + i]);
+					}
+					part[b] = t;
+				}
+			}
+		};
+		// z[i] = x[i] + y[i] for i in [0, n)
+		static void addVec(CipherTextGT *z, const CipherTextGT *x, const CipherTextGT *y, size_t n)
+		{
+			addVecMT(z, x, y, n, 1);
+		}
+		// multi thread version of addVec (enabled if MCL_USE_OMP is defined)
+		// the num of thread is automatically detected if cpuN = 0
+		static void addVecMT(CipherTextGT *z, const CipherTextGT *x, const CipherTextGT *y, size_t n, size_t cpuN = 0)
+		{
+			mcl::fp::parallelFor(AddVecF(z, x, y), n, cpuN, 16);
+		}
+		// z = sum_i x[i] for i in [0, n)
+		static void sumVec(CipherTextGT& z, const CipherTextGT *x, size_t n)
+		{
+			sumVecMT(z, x, n, 1);
+		}
+		// multi thread version of sumVec (enabled if MCL_USE_OMP is defined)
+		// the num of thread is automatically detected if cpuN = 0
+		static void sumVecMT(CipherTextGT& z, const CipherTextGT *x, size_t n, size_t cpuN = 0)
+		{
+			if (n == 0) {
+				z.clear();
+				return;
+			}
+			const size_t blockN = SumVecF::blockN;
+			const size_t bn = (n + blockN - 1) / blockN;
+			if (bn == 1) {
+				SumVecF(&z, x, n)(0, 1);
+				return;
+			}
+			std::vector<CipherTextGT> part(bn);
+			mcl::fp::parallelFor(SumVecF(&part[0], x, n), bn, cpuN);
+			sumVecMT(z, &part[0], bn, cpuN);
+		}
 		template<class INT>
 		static void mul(CipherTextGT& z, const CipherTextGT& x, const INT& y)
 		{
@@ -2330,8 +3281,8 @@ void normalizeVec(SHE::CipherTextAT<G> *v, size_t n)
 {
 	typedef SHE::CipherTextAT<G> Cipher;
 	typedef local::CipherAsArrayOfEc<Cipher> Array;
-	Array arr(v);
-	ec::local::normalizeVecT<typename G::Fp, Array, Array, local::AsArrayOfFp<Array> >(arr, arr, n * 2);
+	Array out(v), in(v);
+	ec::local::normalizeVecT<typename G::Fp, Array, Array, local::AsArrayOfFp<Array> >(out, in, n * 2);
 }
 
 template<class OutputStream, class G>
@@ -7,6 +7,9 @@
 	http://opensource.org/licenses/BSD-3-Clause
 */
 #include <cybozu/bit_operation.hpp>
+#ifdef MCL_USE_OMP
+#include <omp.h>
+#endif
 
 #ifdef _MSC_VER
 	#pragma warning(push)
@@ -39,6 +42,58 @@ T min_(T x, T y) { return x < y ? x : y; }
 template<class T>
 T max_(T x, T y) { return x < y ? y : x; }
 
+/*
+	split [0, n) into cpuN blocks and call f(i, begin, end) for the i-th block
+	the num of thread is automatically detected if cpuN = 0
+	(then each block has at least minN elements)
+	f is called once with (0, 0, n) if MCL_USE_OMP is not defined
+*/
+template<class F>
+void parallelForIdx(const F& f, size_t n, size_t cpuN, size_t minN = 1)
+{
+	if (n == 0) return;
+#ifdef MCL_USE_OMP
+	if (cpuN == 0) {
+		cpuN = omp_get_num_procs();
+		if (n < minN * cpuN) {
+			cpuN = (n + minN - 1) / minN;
+		}
+	}
+	if (cpuN > 1 && n >= cpuN) {
+		const size_t q = n / cpuN;
+		const size_t r = n % cpuN;
+		#pragma omp parallel for
+		for (size_t i = 0; i < cpuN; i++) {
+			size_t adj = q * i + min_(i, r);
+			f(i, adj, adj + q + (i < r));
+		}
+		return;
+	}
+#else
+	(void)cpuN;
+	(void)minN;
+#endif
+	f(0, 0, n);
+}
+
+namespace local {
+
+template<class F>
+struct ParallelForF {
+	const F& f;
+	explicit ParallelForF(const F& f) : f(f) {}
+	void operator()(size_t, size_t begin, size_t end) const { f(begin, end); }
+};
+
+} // mcl::fp::local
+
+// parallelForIdx for f(begin, end)
+template<class F>
+void parallelFor(const F& f, size_t n, size_t cpuN, size_t minN = 1)
+{
+	parallelForIdx(local::ParallelForF<F>(f), n, cpuN, minN);
+}
+
 template<class T>
 void swap_(T& x, T& y)
 {
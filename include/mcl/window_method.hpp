@@ -7,9 +7,20 @@
 #include <mcl/array.hpp>
 #include <mcl/util.hpp>
 #include <mcl/op.hpp>
+#include <cybozu/endian.hpp>
 #include <assert.h>
 
-namespace mcl { namespace fp {
+namespace mcl {
+
+namespace ec {
+
+// defined in ec.hpp
+template<class E>
+void mulSignedWindowCT(E& z, const E *tbl, size_t bitSize, size_t winSize, const Unit *y, size_t n);
+
+} // mcl::ec
+
+namespace fp {
 
 template<class Ec>
 class WindowMethod {
@@ -49,10 +60,8 @@ public:
 				}
 				Ec::dbl(t, t);
 			}
-			for (size_t j = 0; j < r; j++) {
-				w[j].normalize();
-			}
 		}
+		Ec::normalizeVec(&tbl_[0], &tbl_[0], tbl_.size());
 	}
 #ifndef CYBOZU_DONT_USE_EXCEPTION
 	void init(const Ec& x, size_t bitSize, size_t winSize)
@@ -115,5 +124,188 @@ public:
 	}
 };
 
+/*
+	fixed-base multiplication with signed digits and no doubling
+	y = sum_i d_i 2^(winSize i) where -2^(winSize-1) < d_i <= 2^(winSize-1)
+	tbl_[i * h + j - 1] = j 2^(winSize i) x for 1 <= j <= h := 2^(winSize-1) in affine coordinates
+	the table is half of WindowMethod for the same winSize and the number of additions is the same,
+	so SignedWindowMethod with winSize + 1 has the same table size as WindowMethod with fewer additions
+	all additions are mixed ones (Jacobi/Proj + affine)
+	the interface is the same as WindowMethod
+*/
+template<class Ec>
+class SignedWindowMethod {
+public:
+	size_t bitSize_;
+	size_t winSize_;
+	mcl::Array<Ec> tbl_;
+	SignedWindowMethod(const Ec& x, size_t bitSize, size_t winSize)
+	{
+		init(x, bitSize, winSize);
+	}
+	SignedWindowMethod()
+		: bitSize_(0)
+		, winSize_(0)
+	{
+	}
+	static size_t getTblNum(size_t bitSize, size_t winSize)
+	{
+		// +1 for the carry of the top digit
+		return bitSize / winSize + 1;
+	}
+	/*
+		@param x [in] base index
+		@param bitSize [in] exponent bit length
+		@param winSize [in] window size (2 <= winSize < 32)
+	*/
+	void init(bool *pb, const Ec& x, size_t bitSize, size_t winSize)
+	{
+		*pb = false;
+		if (winSize < 2 || winSize >= 32) return;
+		bitSize_ = bitSize;
+		winSize_ = winSize;
+		const size_t tblNum = getTblNum(bitSize, winSize);
+		const size_t h = size_t(1) << (winSize - 1);
+		*pb = tbl_.resize(tblNum * h);
+		if (!*pb) return;
+		Ec t(x);
+		for (size_t i = 0; i < tblNum; i++) {
+			Ec *w = &tbl_[i * h];
+			w[0] = t;
+			for (size_t j = 1; j < h; j++) {
+				Ec::add(w[j], w[j - 1], t);
+			}
+			Ec::dbl(t, w[h - 1]);
+		}
+		Ec::normalizeVec(&tbl_[0], &tbl_[0], tbl_.size());
+	}
+#ifndef CYBOZU_DONT_USE_EXCEPTION
+	void init(const Ec& x, size_t bitSize, size_t winSize)
+	{
+		bool b;
+		init(&b, x, bitSize, winSize);
+		if (!b) throw cybozu::Exception("mcl:SignedWindowMethod:init") << bitSize << winSize;
+	}
+#endif
+	/*
+		@param z [out] x multiplied by y
+		@param y [in] exponent
+	*/
+	template<int tag2, size_t maxBitSize2, template<int tag2_, size_t maxBitSize2_> class FpT>
+	void mul(Ec& z, const FpT<tag2, maxBitSize2>& y) const
+	{
+		fp::Block b;
+		y.getBlock(b);
+		powArray(z, b.p, b.n, false);
+	}
+	void mul(Ec& z, int64_t y) const
+	{
+#if MCL_SIZEOF_UNIT == 8
+		Unit u = fp::abs_(y);
+		powArray(z, &u, 1, y < 0);
+#else
+		uint64_t ua = fp::abs_(y);
+		Unit u[2] = { uint32_t(ua), uint32_t(ua >> 32) };
+		size_t un = u[1] ? 2 : 1;
+		powArray(z, u, un, y < 0);
+#endif
+	}
+	void mul(Ec& z, const mpz_class& y) const
+	{
+		powArray(z, gmp::getUnit(y), gmp::getUnitSize(y), y < 0);
+	}
+	void powArray(Ec& z, const Unit* y, size_t n, bool isNegative) const
+	{
+		z.clear();
+		BitIterator<Unit> ai(y, n);
+		if (ai.getBitSize() == 0) return;
+		assert(ai.getBitSize() <= bitSize_);
+		if (ai.getBitSize() > bitSize_) return;
+		const size_t h = size_t(1) << (winSize_ - 1);
+		const Ec *w = &tbl_[0];
+		Unit carry = 0;
+		do {
+			Unit v = ai.getNext(winSize_) + carry;
+			if (v > h) {
+				// v - 2^winSize in (-h, 0]
+				v = (h << 1) - v;
+				carry = 1;
+				if (v) {
+					Ec t;
+					Ec::neg(t, w[v - 1]);
+					Ec::add(z, z, t);
+				}
+			} else {
+				carry = 0;
+				if (v) Ec::add(z, z, w[v - 1]);
+			}
+			w += h;
+		} while (ai.hasNext());
+		if (carry) {
+			Ec::add(z, z, w[0]);
+		}
+		if (isNegative) {
+			Ec::neg(z, z);
+		}
+	}
+	/*
+		constant-time version of mul for secret y (see ec::mulSignedWindowCT)
+		the cost of the masked scan is linear in 2^winSize, so use winSize = 4, ..., 6
+		@note y must be less than 2^bitSize_
+	*/
+	template<int tag2, size_t maxBitSize2, template<int tag2_, size_t maxBitSize2_> class FpT>
+	void mulCT(Ec& z, const FpT<tag2, maxBitSize2>& y) const
+	{
+		fp::Block b;
+		y.getBlock(b);
+		powArrayCT(z, b.p, b.n);
+	}
+	void powArrayCT(Ec& z, const Unit* y, size_t n) const
+	{
+		ec::mulSignedWindowCT(z, &tbl_[0], bitSize_, winSize_, y, n);
+	}
+	/*
+		serialize the table
+		bitSize and winSize (4-byte little endian) followed by Ec::serializeRawVec
+		return written bytes (0 if error)
+	*/
+	size_t serialize(void *buf, size_t maxBufSize) const
+	{
+		if (maxBufSize < 8) return 0;
+		uint8_t *dst = (uint8_t*)buf;
+		size_t n = Ec::serializeRawVec(dst + 8, maxBufSize - 8, &tbl_[0], tbl_.size());
+		if (n == 0) return 0;
+		cybozu::Set32bitAsLE(dst, uint32_t(bitSize_));
+		cybozu::Set32bitAsLE(dst + 4, uint32_t(winSize_));
+		return n + 8;
+	}
+	/*
+		load the table made by serialize()
+		verify : check that each point is on the curve
+		return read bytes (0 if error)
+	*/
+	size_t deserialize(const void *buf, size_t bufSize, bool verify = false)
+	{
+		if (bufSize < 8) return 0;
+		const uint8_t *src = (const uint8_t*)buf;
+		const size_t bitSize = cybozu::Get32bitAsLE(src);
+		const size_t winSize = cybozu::Get32bitAsLE(src + 4);
+		if (winSize < 2 || winSize >= 32) return 0;
+		const size_t tblN = getTblNum(bitSize, winSize) << (winSize - 1);
+		if (Ec::getRawVecN(src + 8, bufSize - 8) != tblN) return 0;
+		if (!tbl_.resize(tblN)) return 0;
+		size_t n = Ec::deserializeRawVec(&tbl_[0], tblN, src + 8, bufSize - 8, verify);
+		if (n == 0) {
+			bitSize_ = 0;
+			winSize_ = 0;
+			tbl_.clear();
+			return 0;
+		}
+		bitSize_ = bitSize;
+		winSize_ = winSize;
+		return n + 8;
+	}
+};
+
 } } // mcl::fp
 
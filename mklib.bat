@@ -23,10 +23,12 @@ if 1 == 1 (
 
 echo CFLAGS=%LOCAL_CFLAGS%
 
-set OBJ=obj\fp.obj obj\msm_avx.obj bint-x64-win.obj
+set OBJ=obj\fp.obj obj\msm_avx.obj obj\fr_avx.obj obj\sha256_avx.obj bint-x64-win.obj
 
 cl /c %LOCAL_CFLAGS% src\fp.cpp /Foobj\fp.obj
 cl /c %LOCAL_CFLAGS% src\msm_avx.cpp /Foobj\msm_avx.obj /arch:AVX512
+cl /c %LOCAL_CFLAGS% src\fr_avx.cpp /Foobj\fr_avx.obj /arch:AVX512
+cl /c %LOCAL_CFLAGS% src\sha256_avx.cpp /Foobj\sha256_avx.obj /arch:AVX512
 lib /nologo /OUT:lib\mcl.lib /nodefaultlib %OBJ%
 
 if "%1"=="dll" (
@@ -36,6 +36,9 @@ uint32_t initBint()
 	if (cpu.has(Cpu::tAVX512_IFMA)) {
 		type |= tAVX512_IFMA;
 	}
+	if (cpu.has(Cpu::tAVX512F)) {
+		type |= tAVX512F;
+	}
 	const char *env = 0;
 	const char *key = "MCL_CPU";
 #ifdef _WIN32
@@ -14,6 +14,25 @@ int setStr(T *x, const char *buf, mclSize bufSize, int ioMode)
 	return n > 0 ? 0 : -1;
 }
 
+// mclSize may be different from size_t
+template<class G>
+void hashAndMapToVec(void (*f)(G *, const void *const *, const size_t *, size_t), G *P, const void *const *bufVec, const mclSize *bufSizeVec, mclSize n)
+{
+	const size_t blockN = 256;
+	size_t sizeVec[blockN];
+	while (n > 0) {
+		const size_t m = fp::min_<size_t>(n, blockN);
+		for (size_t i = 0; i < m; i++) {
+			sizeVec[i] = bufSizeVec[i];
+		}
+		f(P, bufVec, sizeVec, m);
+		P += m;
+		bufVec += m;
+		bufSizeVec += m;
+		n -= m;
+	}
+}
+
 #ifdef __EMSCRIPTEN__
 // use these functions forcibly
 extern "C" MCL_DLL_API void *mclBnMalloc(size_t n)
@@ -373,6 +392,11 @@ int mclBnG1_hashAndMapToWithDst(mclBnG1 *x, const void *buf, mclSize bufSize, co
 	hashAndMapToG1(*cast(x), buf, bufSize, dst, dstSize);
 	return 0;
 }
+int mclBnG1_hashAndMapToVec(mclBnG1 *x, const void *const *bufVec, const mclSize *bufSizeVec, mclSize n)
+{
+	hashAndMapToVec<G1>(hashAndMapToG1Vec, cast(x), bufVec, bufSizeVec, n);
+	return 0;
+}
 
 mclSize mclBnG1_getStr(char *buf, mclSize maxBufSize, const mclBnG1 *x, int ioMode)
 {
@@ -410,6 +434,10 @@ void mclBnG1_mul(mclBnG1 *z, const mclBnG1 *x, const mclBnFr *y)
 }
 void mclBnG1_mulCT(mclBnG1 *z, const mclBnG1 *x, const mclBnFr *y)
 {
+	if (*cast(x) == getG1basePoint()) {
+		mulG1basePointCT(*cast(z), *cast(y));
+		return;
+	}
 	G1::mulCT(*cast(z),*cast(x), *cast(y));
 }
 
@@ -457,6 +485,11 @@ int mclBnG2_hashAndMapToWithDst(mclBnG2 *x, const void *buf, mclSize bufSize, co
 	hashAndMapToG2(*cast(x), buf, bufSize, dst, dstSize);
 	return 0;
 }
+int mclBnG2_hashAndMapToVec(mclBnG2 *x, const void *const *bufVec, const mclSize *bufSizeVec, mclSize n)
+{
+	hashAndMapToVec<G2>(hashAndMapToG2Vec, cast(x), bufVec, bufSizeVec, n);
+	return 0;
+}
 
 mclSize mclBnG2_getStr(char *buf, mclSize maxBufSize, const mclBnG2 *x, int ioMode)
 {
@@ -903,6 +936,31 @@ mclSize mclBnFp_invVec(mclBnFp *y, const mclBnFp *x, mclSize n)
 	return mcl::invVec(cast(y), cast(x), n);
 }
 
+void mclBnFr_addVec(mclBnFr *z, const mclBnFr *x, const mclBnFr *y, mclSize n)
+{
+	Fr::addVec(cast(z), cast(x), cast(y), n);
+}
+
+void mclBnFr_subVec(mclBnFr *z, const mclBnFr *x, const mclBnFr *y, mclSize n)
+{
+	Fr::subVec(cast(z), cast(x), cast(y), n);
+}
+
+void mclBnFr_mulVec(mclBnFr *z, const mclBnFr *x, const mclBnFr *y, mclSize n)
+{
+	Fr::mulVec(cast(z), cast(x), cast(y), n);
+}
+
+void mclBnFr_mulScalarVec(mclBnFr *z, const mclBnFr *x, const mclBnFr *y, mclSize n)
+{
+	Fr::mulScalarVec(cast(z), cast(x), *cast(y), n);
+}
+
+void mclBnFr_fmaVec(mclBnFr *z, const mclBnFr *x, const mclBnFr *y, const mclBnFr *w, mclSize n)
+{
+	Fr::fmaVec(cast(z), cast(x), cast(y), cast(w), n);
+}
+
 void mclBnG1_normalizeVec(mclBnG1 *y, const mclBnG1 *x, mclSize n)
 {
 	mcl::ec::normalizeVec(cast(y), cast(x), n);
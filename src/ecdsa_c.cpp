@@ -90,6 +90,11 @@ void ecdsaSign(ecdsaSignature *sig, const ecdsaSecretKey *sec, const void *m, mc
 	sign(*cast(sig), *cast(sec), m, size);
 }
 
+void ecdsaSignWithRecId(ecdsaSignature *sig, uint8_t *recId, const ecdsaSecretKey *sec, const void *m, mclSize size)
+{
+	sign(*cast(sig), *cast(sec), m, size, recId);
+}
+
 void ecdsaNormalizeSignature(ecdsaSignature *sig)
 {
 	normalizeSignature(*cast(sig));
@@ -104,6 +109,48 @@ int ecdsaVerifyPrecomputed(const ecdsaSignature *sig, const ecdsaPrecomputedPubl
 	return verify(*cast(sig), *cast(ppub), m, size);
 }
 
+// mclSize may be different from size_t
+int ecdsaVerifyBatch(const ecdsaSignature *sigVec, const uint8_t *recIdVec, const ecdsaPublicKey *pubVec, const void *const *msgVec, const mclSize *msgSizeVec, mclSize n, int *okVec)
+{
+	mcl::Array<size_t> sizeVec;
+	mcl::Array<bool> ok;
+	if (!sizeVec.resize(n)) return 0;
+	if (okVec && !ok.resize(n)) return 0;
+	for (size_t i = 0; i < n; i++) {
+		sizeVec[i] = msgSizeVec[i];
+	}
+	bool ret = verifyVec(cast(sigVec), recIdVec, cast(pubVec), msgVec, sizeVec.data(), n, okVec ? ok.data() : 0);
+	if (okVec) {
+		for (size_t i = 0; i < n; i++) {
+			okVec[i] = ok[i];
+		}
+	}
+	return ret;
+}
+
+int ecdsaRecoverPublicKey(ecdsaPublicKey *pub, const ecdsaSignature *sig, uint8_t recId, const void *m, mclSize size)
+{
+	return recoverPublicKey(*cast(pub), *cast(sig), recId, m, size) ? 0 : -1;
+}
+
+int ecdsaRecoverPublicKeyVec(ecdsaPublicKey *pubVec, const ecdsaSignature *sigVec, const uint8_t *recIdVec, const void *const *msgVec, const mclSize *msgSizeVec, mclSize n, int *okVec)
+{
+	mcl::Array<size_t> sizeVec;
+	mcl::Array<bool> ok;
+	if (!sizeVec.resize(n)) return -1;
+	if (okVec && !ok.resize(n)) return -1;
+	for (size_t i = 0; i < n; i++) {
+		sizeVec[i] = msgSizeVec[i];
+	}
+	bool ret = recoverPublicKeyVec(cast(pubVec), cast(sigVec), recIdVec, msgVec, sizeVec.data(), n, okVec ? ok.data() : 0);
+	if (okVec) {
+		for (size_t i = 0; i < n; i++) {
+			okVec[i] = ok[i];
+		}
+	}
+	return ret ? 0 : -1;
+}
+
 ecdsaPrecomputedPublicKey *ecdsaPrecomputedPublicKeyCreate()
 {
 	PrecomputedPublicKey *ppub = (PrecomputedPublicKey*)malloc(sizeof(PrecomputedPublicKey));
@@ -33,6 +33,8 @@
 // define Fp, Fr, G1
 #include <mcl/g1_def.hpp>
 #include "fp_tower_impl.hpp"
+#include <mcl/curve_type.hpp>
+#include "msm.hpp"
 
 namespace mcl {
 
@@ -192,6 +194,147 @@ void expand_message_xmd(uint8_t out[], size_t outSize, const void *msg, size_t m
 	}
 }
 
+#if MCL_MSM == 1
+namespace local {
+
+static const uint32_t sha256IV[8] = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+// append the padding of SHA-256 to buf[0, size) where preN bytes were already hashed and return the number of blocks
+inline size_t sha256Pad(uint8_t *buf, size_t size, size_t preN)
+{
+	const uint64_t bitLen = uint64_t(preN + size) * 8;
+	buf[size++] = 0x80;
+	while ((size % 64) != 56) buf[size++] = 0;
+	cybozu::Set64bitAsBE(buf + size, bitLen);
+	return (size + 8) / 64;
+}
+
+inline void sha256StoreVec(uint8_t *out, const uint32_t h[8][16], size_t i)
+{
+	for (size_t j = 0; j < 8; j++) {
+		cybozu::Set32bitAsBE(out + j * 4, h[j][i]);
+	}
+}
+
+/*
+	expand_message_xmd of msgVec[idx[i]] for i < n <= 16 (the padded msg must be in maxB0BlkN blocks)
+*/
+static void expand_message_xmdAVX512(uint8_t *out, size_t outSize, const void *const *msgVec, const size_t *msgSizeVec, const size_t *idx, size_t n, const uint8_t *dst, size_t dstSize)
+{
+	const size_t mdSize = 32;
+	const size_t r_in_bytes = 64;
+	const size_t maxB0BlkN = 8; // b_i needs at most (32 + 1 + 255 + 1 + 9 + 63) / 64 = 5 blocks
+	uint8_t buf[16][maxB0BlkN * 64];
+	const uint8_t *blk[16];
+	size_t blkN[16];
+	uint32_t h[8][16];
+	// the state after Z_pad is common
+	static const uint8_t Z_pad[r_in_bytes] = {};
+	for (size_t i = 0; i < 16; i++) {
+		blk[i] = Z_pad;
+		blkN[i] = i < n ? 1 : 0;
+		for (size_t j = 0; j < 8; j++) h[j][i] = sha256IV[j];
+	}
+	msm::sha256BlockVecAVX512(h, blk, blkN);
+	/*
+		b0 = H(Z_pad | msg | BE(outSize, 2) | BE(0, 1) | DST | BE(dstSize, 1))
+	*/
+	for (size_t i = 0; i < n; i++) {
+		const size_t msgSize = msgSizeVec[idx[i]];
+		uint8_t *p = buf[i];
+		memcpy(p, msgVec[idx[i]], msgSize);
+		size_t pos = msgSize;
+		cybozu::Set16bitAsBE(p + pos, uint16_t(outSize));
+		pos += 2;
+		p[pos++] = 0;
+		memcpy(p + pos, dst, dstSize);
+		pos += dstSize;
+		p[pos++] = uint8_t(dstSize);
+		blk[i] = p;
+		blkN[i] = sha256Pad(p, pos, r_in_bytes);
+	}
+	msm::sha256BlockVecAVX512(h, blk, blkN);
+	uint8_t b0[16][mdSize];
+	for (size_t i = 0; i < n; i++) {
+		sha256StoreVec(b0[i], h, i);
+	}
+	/*
+		b_1 = H(b0 | BE(1, 1) | DST | BE(dstSize, 1))
+		b_i = H((b0 ^ b_{i-1}) | BE(i, 1) | DST | BE(dstSize, 1))
+		the lengths are the same in all streams
+	*/
+	const size_t mdN = outSize / mdSize;
+	for (size_t k = 0; k < mdN; k++) {
+		for (size_t i = 0; i < n; i++) {
+			uint8_t *p = buf[i];
+			if (k == 0) {
+				memcpy(p, b0[i], mdSize);
+			} else {
+				const uint8_t *prev = out + outSize * idx[i] + mdSize * (k - 1);
+				for (size_t j = 0; j < mdSize; j++) {
+					p[j] = b0[i][j] ^ prev[j];
+				}
+			}
+			size_t pos = mdSize;
+			p[pos++] = uint8_t(k + 1);
+			memcpy(p + pos, dst, dstSize);
+			pos += dstSize;
+			p[pos++] = uint8_t(dstSize);
+			blkN[i] = sha256Pad(p, pos, 0);
+			for (size_t j = 0; j < 8; j++) h[j][i] = sha256IV[j];
+		}
+		msm::sha256BlockVecAVX512(h, blk, blkN);
+		for (size_t i = 0; i < n; i++) {
+			sha256StoreVec(out + outSize * idx[i] + mdSize * k, h, i);
+		}
+	}
+}
+
+} // local
+#endif
+
+void expand_message_xmdVec(uint8_t *out, size_t outSize, const void *const *msgVec, const size_t *msgSizeVec, size_t n, const void *dst, size_t dstSize)
+{
+#if MCL_MSM == 1
+	if (mcl::bint::g_cpuType & mcl::bint::tAVX512F) {
+		const size_t mdSize = 32;
+		assert((outSize % mdSize) == 0 && 0 < outSize && outSize <= 256);
+		uint8_t largeDst[mdSize];
+		if (dstSize > 255) {
+			cybozu::Sha256 h;
+			h.update("H2C-OVERSIZE-DST-", 17);
+			h.digest(largeDst, mdSize, dst, dstSize);
+			dst = largeDst;
+			dstSize = mdSize;
+		}
+		// msg | BE(outSize, 2) | BE(0, 1) | DST | BE(dstSize, 1) | padding (9 bytes at least)
+		const size_t maxMsgSize = 8 * 64 - 2 - 1 - dstSize - 1 - 9;
+		size_t idx[16];
+		size_t m = 0;
+		for (size_t i = 0; i < n; i++) {
+			if (msgSizeVec[i] > maxMsgSize) {
+				expand_message_xmd(out + outSize * i, outSize, msgVec[i], msgSizeVec[i], dst, dstSize);
+				continue;
+			}
+			idx[m++] = i;
+			if (m == 16) {
+				local::expand_message_xmdAVX512(out, outSize, msgVec, msgSizeVec, idx, m, (const uint8_t*)dst, dstSize);
+				m = 0;
+			}
+		}
+		if (m > 0) {
+			local::expand_message_xmdAVX512(out, outSize, msgVec, msgSizeVec, idx, m, (const uint8_t*)dst, dstSize);
+		}
+		return;
+	}
+#endif
+	for (size_t i = 0; i < n; i++) {
+		expand_message_xmd(out + outSize * i, outSize, msgVec[i], msgSizeVec[i], dst, dstSize);
+	}
+}
+
 /*
 	inv(xR) = (1/x)R^-1 -toMont-> 1/x -toMont-> (1/x)R
 */
@@ -202,6 +345,13 @@ static void fp_invMod(Unit *y, const Unit *x, const Op& op)
 	if (op.isMont) op.fp_mul(y, y, op.R3, op.p);
 }
 
+template<size_t N>
+static void fp_invModCT(Unit *y, const Unit *x, const Op& op)
+{
+	mcl::inv::execCT<N>(*reinterpret_cast<const mcl::inv::InvModT<N>*>(op.im), y, x);
+	if (op.isMont) op.fp_mul(y, y, op.R3, op.p);
+}
+
 // set x = y unless y = 0
 template<typename T>
 void setSafe(T& x, T y)
@@ -233,6 +383,7 @@ void setOp(Op& op)
 #if 1
 	mcl::inv::init(*reinterpret_cast<mcl::inv::InvModT<N>*>(op.im), op.mp);
 	op.fp_invOp = fp_invMod<N>;
+	op.fp_invCTOp = fp_invModCT<N>;
 #else
 	op.fp_invOp = fp_invOpC;
 #endif
@@ -273,6 +273,7 @@ struct FpGenerator : Xbyak::CodeGenerator {
 	Label fpDbl_modL;
 	Label fp_mulL;
 	Label fp2Dbl_mulPreL;
+	Label fp6Dbl_mulPreL;
 	const uint64_t *p_;
 	uint64_t rp_;
 	int pn_;
@@ -497,6 +498,17 @@ private:
 		if (gen_fp2_mul_xi(op.fp2_mul_xiA_)) {
 			setFuncInfo(prof_, suf, "2_mul_xi", op.fp2_mul_xiA_, getCurr());
 		}
+
+		if (!gen_fp6Dbl_mulPre(op.fp6Dbl_mulPreA_)) return;
+		setFuncInfo(prof_, suf, "6Dbl_mulPre", op.fp6Dbl_mulPreA_, getCurr());
+
+		if (gen_fp6_mul(op.fp6_mulA_)) {
+			setFuncInfo(prof_, suf, "6_mul", op.fp6_mulA_, getCurr());
+		}
+
+		if (gen_fp6_mul01(op.fp6_mul01A_)) {
+			setFuncInfo(prof_, suf, "6_mul01", op.fp6_mul01A_, getCurr());
+		}
 	}
 	template<class T1, class T2>
 	void add_ex(const T1& t1, const T2& t2, bool noCF)
@@ -3735,6 +3747,238 @@ private:
 		mov_mm(gp0 + FpByte_, t1, rax, pn_);
 		return true;
 	}
+	/*
+		raw operations for Fp2 and Fp2Dbl used in fused Fp6 kernels
+		they use rax and t.size() >= pn_ * 2
+	*/
+	// z = x + y for Fp2 without modulo (assume isLtQuad)
+	void gen_raw_fp2_addPre(const RegExp& pz, const RegExp& px, const RegExp& py)
+	{
+		gen_raw_add(pz, px, py, rax, pn_);
+		gen_raw_add(pz + FpByte_, px + FpByte_, py + FpByte_, rax, pn_);
+	}
+	// FpDbl::sub
+	void gen_raw_fpDbl_sub(const RegExp& pz, const RegExp& px, const RegExp& py, const Pack& t)
+	{
+		gen_raw_sub(pz, px, py, rax, pn_);
+		gen_raw_fp_sub(pz + pn_ * 8, px + pn_ * 8, py + pn_ * 8, t, true);
+	}
+	// FpDbl::add
+	void gen_raw_fpDbl_add(const RegExp& pz, const RegExp& px, const RegExp& py, const Pack& t)
+	{
+		gen_raw_add(pz, px, py, rax, pn_);
+		gen_raw_fp_add(pz + pn_ * 8, px + pn_ * 8, py + pn_ * 8, t, true);
+	}
+	void gen_raw_fp2Dbl_add(const RegExp& pz, const RegExp& px, const RegExp& py, const Pack& t)
+	{
+		gen_raw_fpDbl_add(pz, px, py, t);
+		gen_raw_fpDbl_add(pz + FpByte_ * 2, px + FpByte_ * 2, py + FpByte_ * 2, t);
+	}
+	// Fp2Dbl::subSpecial<true>
+	void gen_raw_fp2Dbl_subSpecial(const RegExp& pz, const RegExp& px, const RegExp& py, const Pack& t)
+	{
+		gen_raw_fpDbl_sub(pz, px, py, t);
+		gen_raw_sub(pz + FpByte_ * 2, px + FpByte_ * 2, py + FpByte_ * 2, rax, pn_ * 2);
+	}
+	/*
+		Fp2Dbl::mul_xi for xi_a = 1
+		y = (x.a - x.b, x.a + x.b)
+		y may be equal to x
+		use work area w of FpByte_ * 2 bytes
+	*/
+	void gen_raw_fp2Dbl_mul_xi(const RegExp& py, const RegExp& px, const RegExp& w, const Pack& t)
+	{
+		const Pack t1 = t.sub(0, pn_);
+		const Pack t2 = t.sub(pn_, pn_);
+		gen_raw_add(w, px, px + FpByte_ * 2, rax, pn_ * 2);
+		gen_raw_fpDbl_sub(py, px, px + FpByte_ * 2, t);
+		mov_mm(py + FpByte_ * 2, w, rax, pn_);
+		load_rm(t1, w + pn_ * 8);
+		lea(rax, ptr[rip + pL_]);
+		sub_p_mod(t2, t1, rax);
+		store_mr(py + FpByte_ * 2 + pn_ * 8, t2);
+	}
+	// z = x * y by fp2Dbl_mulPreL where px and py are evaluated after pz
+	void call_fp2Dbl_mulPre(const RegExp& pz, const RegExp& px, const RegExp& py)
+	{
+		lea(gp0, ptr [pz]);
+		lea(gp1, ptr [px]);
+		lea(gp2, ptr [py]);
+		call(fp2Dbl_mulPreL);
+	}
+	/*
+		Fp6Dbl::mulPreT<true> in one function
+		x = a + bv + cv^2, y = d + ev + fv^2
+		ZA = ((b + c)(e + f) - be - cf)xi + ad
+		ZB = (a + b)(d + e) - ad - be + cf xi
+		ZC = (a + c)(d + f) - ad - cf + be
+	*/
+	bool gen_fp6Dbl_mulPre(void3u& func)
+	{
+		if (isFullBit_ || !op_->isLtQuad) return false;
+		if (op_->xi_a != 1) return false;
+		if (!(pn_ == 4 || pn_ == 6)) return false;
+		align(16);
+		func = getCurr<void3u>();
+
+		StackFrame sf(this, 3, 10 | UseRDX, 0, false);
+		call(fp6Dbl_mulPreL);
+		sf.close();
+
+	L(fp6Dbl_mulPreL);
+		const RegExp z = rsp + 0 * 8;
+		const RegExp x = rsp + 1 * 8;
+		const RegExp y = rsp + 2 * 8;
+		const Ext1 t1(FpByte_ * 2, rsp, 3 * 8);
+		const Ext1 t2(FpByte_ * 2, rsp, t1.next);
+		const Ext1 BE(FpByte_ * 4, rsp, t2.next);
+		const Ext1 CF(FpByte_ * 4, rsp, BE.next);
+		const Ext1 AD(FpByte_ * 4, rsp, CF.next);
+		const int SS = AD.next;
+		const int F2 = FpByte_ * 2;
+		const int D2 = FpByte_ * 4;
+		sub(rsp, SS);
+		mov(ptr [z], gp0);
+		mov(ptr [x], gp1);
+		mov(ptr [y], gp2);
+		// ZA = (b + c)(e + f)
+		gen_raw_fp2_addPre(t1, gp1 + F2, gp1 + F2 * 2);
+		gen_raw_fp2_addPre(t2, gp2 + F2, gp2 + F2 * 2);
+		call_fp2Dbl_mulPre(gp0, t1, t2);
+		// ZB = (a + b)(d + e)
+		mov(gp1, ptr [x]);
+		mov(gp2, ptr [y]);
+		gen_raw_fp2_addPre(t1, gp1, gp1 + F2);
+		gen_raw_fp2_addPre(t2, gp2, gp2 + F2);
+		mov(gp0, ptr [z]);
+		call_fp2Dbl_mulPre(gp0 + D2, t1, t2);
+		// ZC = (a + c)(d + f)
+		mov(gp1, ptr [x]);
+		mov(gp2, ptr [y]);
+		gen_raw_fp2_addPre(t1, gp1, gp1 + F2 * 2);
+		gen_raw_fp2_addPre(t2, gp2, gp2 + F2 * 2);
+		mov(gp0, ptr [z]);
+		call_fp2Dbl_mulPre(gp0 + D2 * 2, t1, t2);
+		// BE, CF, AD
+		mov(gp1, ptr [x]);
+		mov(gp2, ptr [y]);
+		call_fp2Dbl_mulPre(BE, gp1 + F2, gp2 + F2);
+		mov(gp1, ptr [x]);
+		mov(gp2, ptr [y]);
+		call_fp2Dbl_mulPre(CF, gp1 + F2 * 2, gp2 + F2 * 2);
+		mov(gp1, ptr [x]);
+		mov(gp2, ptr [y]);
+		call_fp2Dbl_mulPre(AD, gp1, gp2);
+
+		Pack t = sf.t;
+		t.append(gp1);
+		t.append(gp2);
+		t = t.sub(0, pn_ * 2);
+		mov(gp0, ptr [z]);
+		const RegExp ZA = gp0;
+		const RegExp ZB = gp0 + D2;
+		const RegExp ZC = gp0 + D2 * 2;
+		gen_raw_fp2Dbl_subSpecial(ZA, ZA, BE, t);
+		gen_raw_fp2Dbl_subSpecial(ZA, ZA, CF, t);
+		gen_raw_fp2Dbl_subSpecial(ZB, ZB, AD, t);
+		gen_raw_fp2Dbl_subSpecial(ZB, ZB, BE, t);
+		gen_raw_fp2Dbl_subSpecial(ZC, ZC, AD, t);
+		gen_raw_fp2Dbl_subSpecial(ZC, ZC, CF, t);
+		gen_raw_fp2Dbl_mul_xi(ZA, ZA, t1, t);
+		gen_raw_fp2Dbl_add(ZA, ZA, AD, t);
+		gen_raw_fp2Dbl_mul_xi(CF, CF, t1, t);
+		gen_raw_fp2Dbl_add(ZB, ZB, CF, t);
+		gen_raw_fp2Dbl_add(ZC, ZC, BE, t);
+		add(rsp, SS);
+		ret();
+		return true;
+	}
+	// z = x * y for Fp6 (use after gen_fp6Dbl_mulPre)
+	bool gen_fp6_mul(void3u& func)
+	{
+		align(16);
+		func = getCurr<void3u>();
+		const RegExp z = rsp;
+		const Ext1 d(FpByte_ * 12, rsp, 8);
+		StackFrame sf(this, 3, 10 | UseRDX, d.next);
+		mov(ptr [z], gp0);
+		lea(gp0, ptr [d]);
+		call(fp6Dbl_mulPreL);
+		for (int i = 0; i < 6; i++) {
+			mov(gp0, ptr [z]);
+			if (i > 0) add(gp0, FpByte_ * i);
+			lea(gp1, ptr [(RegExp)d + FpByte_ * 2 * i]);
+			call(fpDbl_modL);
+		}
+		return true;
+	}
+	/*
+		sparse multiplication used in mul_403/mul_041 (use after gen_fp6Dbl_mulPre)
+		z = x * (d + ev) for x = a + bv + cv^2
+		= (ad + ce xi) + ((a + b)(d + e) - ad - be)v + (be + cd)v^2
+		z may be equal to x
+	*/
+	bool gen_fp6_mul01(void4u& func)
+	{
+		align(16);
+		func = getCurr<void4u>();
+		const RegExp z = rsp + 0 * 8;
+		const RegExp x = rsp + 1 * 8;
+		const RegExp d = rsp + 2 * 8;
+		const RegExp e = rsp + 3 * 8;
+		const Ext1 t1(FpByte_ * 2, rsp, 4 * 8);
+		const Ext1 t2(FpByte_ * 2, rsp, t1.next);
+		const Ext1 AD(FpByte_ * 4, rsp, t2.next);
+		const Ext1 CE(FpByte_ * 4, rsp, AD.next);
+		const Ext1 BE(FpByte_ * 4, rsp, CE.next);
+		const Ext1 CD(FpByte_ * 4, rsp, BE.next);
+		const Ext1 T(FpByte_ * 4, rsp, CD.next);
+		const int F2 = FpByte_ * 2;
+		// fp2Dbl_mulPreL and fpDbl_modL use all registers
+		StackFrame sf(this, 4, 9 | UseRDX, T.next);
+		mov(ptr [z], sf.p[0]);
+		mov(ptr [x], sf.p[1]);
+		mov(ptr [d], sf.p[2]);
+		mov(ptr [e], sf.p[3]);
+		mov(gp1, ptr [x]);
+		mov(gp2, ptr [d]);
+		call_fp2Dbl_mulPre(AD, gp1, gp2);
+		mov(gp1, ptr [x]);
+		mov(gp2, ptr [e]);
+		call_fp2Dbl_mulPre(CE, gp1 + F2 * 2, gp2);
+		mov(gp1, ptr [x]);
+		mov(gp2, ptr [e]);
+		call_fp2Dbl_mulPre(BE, gp1 + F2, gp2);
+		mov(gp1, ptr [x]);
+		mov(gp2, ptr [d]);
+		call_fp2Dbl_mulPre(CD, gp1 + F2 * 2, gp2);
+		mov(gp1, ptr [x]);
+		gen_raw_fp2_addPre(t1, gp1, gp1 + F2);
+		mov(gp1, ptr [d]);
+		mov(gp2, ptr [e]);
+		gen_raw_fp2_addPre(t2, gp1, gp2);
+		call_fp2Dbl_mulPre(T, t1, t2);
+
+		Pack t = sf.t;
+		t.append(gp1);
+		t.append(gp2);
+		t.append(rdx);
+		t = t.sub(0, pn_ * 2);
+		gen_raw_fp2Dbl_subSpecial(T, T, AD, t);
+		gen_raw_fp2Dbl_subSpecial(T, T, BE, t);
+		gen_raw_fp2Dbl_mul_xi(CE, CE, t1, t);
+		gen_raw_fp2Dbl_add(AD, AD, CE, t);
+		gen_raw_fp2Dbl_add(BE, BE, CD, t);
+		// z.a = AD, z.b = T, z.c = BE
+		const Ext1 *tbl[] = { &AD, &T, &BE };
+		for (int i = 0; i < 6; i++) {
+			mov(gp0, ptr [z]);
+			if (i > 0) add(gp0, FpByte_ * i);
+			lea(gp1, ptr [(RegExp)*tbl[i / 2] + FpByte_ * 2 * (i % 2)]);
+			call(fpDbl_modL);
+		}
+		return true;
+	}
 };
 
 } } // mcl::fp
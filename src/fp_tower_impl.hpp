@@ -111,6 +111,11 @@ void Fp6::sqr(Fp6& y, const Fp6& x)
 }
 void Fp6::mul(Fp6& z, const Fp6& x, const Fp6& y)
 {
+	const mcl::fp::Op& op = Fp::getOp();
+	if (op.fp6_mulA_) {
+		op.fp6_mulA_(reinterpret_cast<Unit*>(&z), x.getFp0()->getUnit(), y.getFp0()->getUnit());
+		return;
+	}
 	Fp6Dbl XY;
 	Fp6Dbl::mulPre(XY, x, y);
 	Fp6Dbl::mod(z, XY);
@@ -0,0 +1,404 @@
+/**
+	@file
+	@brief vector operations of Fr (at most 256-bit) with AVX-512 IFMA
+	@author MITSUNARI Shigeo(@herumi)
+	@license modified new BSD license
+	http://opensource.org/licenses/BSD-3-Clause
+*/
+#define MCL_DLL_EXPORT
+#include <mcl/bls12_381.hpp>
+#include <stdint.h>
+#include "avx512.hpp"
+#include "msm.hpp"
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic ignored "-Wunused-function"
+#ifndef __clang__
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized" // false positive
+#pragma GCC diagnostic ignored "-Wuninitialized" // false positive in avx512fintrin.h
+#pragma GCC diagnostic ignored "-Wignored-attributes" // false positive
+#endif
+#endif
+
+/*
+	an element x of Fr is the Montgomery form x R mod p where R = 2^256
+	it is split into N = 5 limbs of 52 bits and 8 elements are processed at once
+	the Montgomery multiplication of the limbs is x y / 2^260 mod p
+	so one operand is loaded as 16 x (< 2^260) to get x y / 2^256 mod p
+*/
+namespace {
+
+using namespace mcl;
+
+static const size_t S = sizeof(Unit)*8-1; // 63
+static const size_t W = 52;
+static const size_t N = 5; // = ceil(256/52)
+static const size_t M = sizeof(Vec) / sizeof(Unit); // 8 elements
+static const size_t U = 4; // num of Unit of Fr
+static const size_t E = M * U; // num of Unit of 8 elements
+
+struct Param {
+	Vec mask;
+	Vec rp; // -1/p mod 2^52
+	Vec ap[N]; // p
+	Vec idx[4]; // for transpose
+};
+
+static Param g_;
+
+inline void vaddPre(Vec *z, const Vec *x, const Vec *y)
+{
+	Vec t = vpaddq(x[0], y[0]);
+	Vec c = vpsrlq(t, W);
+	z[0] = vpandq(t, g_.mask);
+	for (size_t i = 1; i < N; i++) {
+		t = vpaddq(x[i], y[i]);
+		t = vpaddq(t, c);
+		if (i == N-1) {
+			z[i] = t;
+			return;
+		}
+		c = vpsrlq(t, W);
+		z[i] = vpandq(t, g_.mask);
+	}
+}
+
+inline Vmask vsubPre(Vec *z, const Vec *x, const Vec *y)
+{
+	Vec t = vpsubq(x[0], y[0]);
+	Vec c = vpsrlq(t, S);
+	z[0] = vpandq(t, g_.mask);
+	for (size_t i = 1; i < N; i++) {
+		t = vpsubq(x[i], y[i]);
+		t = vpsubq(t, c);
+		c = vpsrlq(t, S);
+		z[i] = vpandq(t, g_.mask);
+	}
+	return vpcmpneqq(c, vzero());
+}
+
+inline void uvselect(Vec *z, const Vmask& c, const Vec *a, const Vec *b)
+{
+	for (size_t i = 0; i < N; i++) {
+		z[i] = vselect(c, a[i], b[i]);
+	}
+}
+
+inline void vadd(Vec *z, const Vec *x, const Vec *y)
+{
+	Vec sN[N], tN[N];
+	vaddPre(sN, x, y);
+	Vmask c = vsubPre(tN, sN, g_.ap);
+	uvselect(z, c, sN, tN);
+}
+
+inline void vsub(Vec *z, const Vec *x, const Vec *y)
+{
+	Vec sN[N], tN[N];
+	Vmask c = vsubPre(sN, x, y);
+	vaddPre(tN, sN, g_.ap);
+	tN[N-1] = vpandq(tN[N-1], g_.mask);
+	uvselect(z, c, tN, sN);
+}
+
+inline void vmulUnit(Vec *z, const Vec *x, const Vec& y)
+{
+	Vec H;
+	z[0] = vmulL(x[0], y);
+	H = vmulH(x[0], y);
+	for (size_t i = 1; i < N; i++) {
+		z[i] = vmulL(x[i], y, H);
+		H = vmulH(x[i], y);
+	}
+	z[N] = H;
+}
+
+inline Vec vmulUnitAdd(Vec *z, const Vec *x, const Vec& y)
+{
+	Vec H;
+	Vec v = x[0];
+	z[0] = vmulL(v, y, z[0]);
+	H = vmulH(v, y, z[1]);
+	for (size_t i = 1; i < N-1; i++) {
+		v = x[i];
+		z[i] = vmulL(v, y, H);
+		H = vmulH(v, y, z[i+1]);
+	}
+	v = x[N-1];
+	z[N-1] = vmulL(v, y, H);
+	H = vmulH(v, y);
+	return H;
+}
+
+// z = x y / 2^260 mod p for x < 2^260 and y < p
+inline void vmul(Vec *z, const Vec *x, const Vec *y)
+{
+	Vec t[N*2], q;
+	vmulUnit(t, x, y[0]);
+	q = vmulL(t[0], g_.rp);
+	t[N] = vpaddq(t[N], vmulUnitAdd(t, g_.ap, q));
+	for (size_t i = 1; i < N; i++) {
+		t[N+i] = vmulUnitAdd(t+i, x, y[i]);
+		t[i] = vpaddq(t[i], vpsrlq(t[i-1], W));
+		q = vmulL(t[i], g_.rp);
+		t[N+i] = vpaddq(t[N+i], vmulUnitAdd(t+i, g_.ap, q));
+	}
+	for (size_t i = N; i < N*2; i++) {
+		t[i] = vpaddq(t[i], vpsrlq(t[i-1], W));
+		t[i-1] = vpandq(t[i-1], g_.mask);
+	}
+	Vmask c = vsubPre(z, t+N, g_.ap);
+	uvselect(z, c, t+N, z);
+}
+
+/*
+	load x[0..8) and set y[i] = the i-th 52-bit limbs of (x[j] << sh) for j = 0, ..., 7
+	sh = 0 or 4
+*/
+template<size_t sh>
+inline void load(Vec y[N], const Unit *x)
+{
+	Vec a = vmovdqu64(x);
+	Vec b = vmovdqu64(x + 8);
+	Vec c = vmovdqu64(x + 16);
+	Vec d = vmovdqu64(x + 24);
+	// (x[0][0], x[1][0], x[2][0], x[3][0], x[0][1], x[1][1], x[2][1], x[3][1])
+	Vec t0 = vperm2tq(a, g_.idx[0], b);
+	Vec t1 = vperm2tq(a, g_.idx[1], b);
+	Vec t2 = vperm2tq(c, g_.idx[0], d);
+	Vec t3 = vperm2tq(c, g_.idx[1], d);
+	Vec v0 = vperm2tq(t0, g_.idx[2], t2);
+	Vec v1 = vperm2tq(t0, g_.idx[3], t2);
+	Vec v2 = vperm2tq(t1, g_.idx[2], t3);
+	Vec v3 = vperm2tq(t1, g_.idx[3], t3);
+	y[0] = vpandq(vpsllq(v0, sh), g_.mask);
+	y[1] = vpandq(vporq(vpsrlq(v0, 52 - sh), vpsllq(v1, 12 + sh)), g_.mask);
+	y[2] = vpandq(vporq(vpsrlq(v1, 40 - sh), vpsllq(v2, 24 + sh)), g_.mask);
+	y[3] = vpandq(vporq(vpsrlq(v2, 28 - sh), vpsllq(v3, 36 + sh)), g_.mask);
+	y[4] = vpsrlq(v3, 16 - sh);
+}
+
+// inverse of load<0>
+inline void store(Unit *x, const Vec y[N])
+{
+	Vec v0 = vporq(y[0], vpsllq(y[1], 52));
+	Vec v1 = vporq(vpsrlq(y[1], 12), vpsllq(y[2], 40));
+	Vec v2 = vporq(vpsrlq(y[2], 24), vpsllq(y[3], 28));
+	Vec v3 = vporq(vpsrlq(y[3], 36), vpsllq(y[4], 16));
+	Vec t0 = vperm2tq(v0, g_.idx[2], v1);
+	Vec t2 = vperm2tq(v0, g_.idx[3], v1);
+	Vec t1 = vperm2tq(v2, g_.idx[2], v3);
+	Vec t3 = vperm2tq(v2, g_.idx[3], v3);
+	_mm512_storeu_si512(x, vperm2tq(t0, g_.idx[0], t1));
+	_mm512_storeu_si512(x + 8, vperm2tq(t0, g_.idx[1], t1));
+	_mm512_storeu_si512(x + 16, vperm2tq(t2, g_.idx[0], t3));
+	_mm512_storeu_si512(x + 24, vperm2tq(t2, g_.idx[1], t3));
+}
+
+inline void broadcast(Vec y[N], const Unit *x, size_t sh)
+{
+	Unit t[M*U];
+	for (size_t i = 0; i < M; i++) {
+		for (size_t j = 0; j < U; j++) t[i*U+j] = x[j];
+	}
+	if (sh == 0) {
+		load<0>(y, t);
+	} else {
+		load<4>(y, t);
+	}
+}
+
+struct AddF {
+	void operator()(Unit *z, const Unit *x, const Unit *y, const Unit *) const
+	{
+		Vec a[N], b[N];
+		load<0>(a, x);
+		load<0>(b, y);
+		vadd(a, a, b);
+		store(z, a);
+	}
+};
+
+struct SubF {
+	void operator()(Unit *z, const Unit *x, const Unit *y, const Unit *) const
+	{
+		Vec a[N], b[N];
+		load<0>(a, x);
+		load<0>(b, y);
+		vsub(a, a, b);
+		store(z, a);
+	}
+};
+
+struct MulF {
+	void operator()(Unit *z, const Unit *x, const Unit *y, const Unit *) const
+	{
+		Vec a[N], b[N];
+		load<4>(a, x);
+		load<0>(b, y);
+		vmul(a, a, b);
+		store(z, a);
+	}
+};
+
+struct FmaF {
+	void operator()(Unit *z, const Unit *x, const Unit *y, const Unit *w) const
+	{
+		Vec a[N], b[N];
+		load<4>(a, x);
+		load<0>(b, y);
+		vmul(a, a, b);
+		load<0>(b, w);
+		vadd(a, a, b);
+		store(z, a);
+	}
+};
+
+struct MulScalarF {
+	Vec y_[N];
+	explicit MulScalarF(const Unit *y) { broadcast(y_, y, 4); }
+	void operator()(Unit *z, const Unit *x, const Unit *, const Unit *) const
+	{
+		Vec a[N];
+		load<0>(a, x);
+		vmul(a, y_, a);
+		store(z, a);
+	}
+};
+
+/*
+	call f for each 8 elements of z, x, y, w
+	y is not incremented if yStep = 0, w is not used if w = 0
+	the remaining elements are processed with a zero-padded buffer
+*/
+template<class F>
+void execVec(const F& f, Unit *z, const Unit *x, const Unit *y, const Unit *w, size_t n, size_t yStep = E)
+{
+	const size_t q = n / M;
+	for (size_t i = 0; i < q; i++) {
+		f(z, x, y, w);
+		z += E;
+		x += E;
+		y += yStep;
+		if (w) w += E;
+	}
+	const size_t r = (n % M) * U;
+	if (r == 0) return;
+	Unit bx[E] = {}, by[E] = {}, bw[E] = {}, bz[E];
+	for (size_t i = 0; i < r; i++) {
+		bx[i] = x[i];
+		if (yStep) by[i] = y[i];
+		if (w) bw[i] = w[i];
+	}
+	f(bz, bx, yStep ? by : y, w ? bw : 0);
+	for (size_t i = 0; i < r; i++) {
+		z[i] = bz[i];
+	}
+}
+
+void addVec(Unit *z, const Unit *x, const Unit *y, size_t n)
+{
+	execVec(AddF(), z, x, y, 0, n);
+}
+
+void subVec(Unit *z, const Unit *x, const Unit *y, size_t n)
+{
+	execVec(SubF(), z, x, y, 0, n);
+}
+
+void mulVec(Unit *z, const Unit *x, const Unit *y, size_t n)
+{
+	execVec(MulF(), z, x, y, 0, n);
+}
+
+void mulScalarVec(Unit *z, const Unit *x, const Unit *y, size_t n)
+{
+	execVec(MulScalarF(y), z, x, y, 0, n, 0);
+}
+
+void fmaVec(Unit *z, const Unit *x, const Unit *y, const Unit *w, size_t n)
+{
+	execVec(FmaF(), z, x, y, w, n);
+}
+
+/*
+	radix-4 butterflies of Ntt::nttSmall for j in [0, L) where L % 8 = 0
+	(x[j], x[j+L], x[j+2L], x[j+3L]) with tw1[j], tw2[j], tw2[j+L]
+	x[j] and x[j+2L] are multiplied by *s if s is not null
+*/
+void radix4Vec(Unit *x, size_t L, const Unit *tw1, const Unit *tw2, const Unit *s)
+{
+	Vec vs[N];
+	if (s) broadcast(vs, s, 4);
+	Unit *p0 = x;
+	Unit *p1 = p0 + L * U;
+	Unit *p2 = p1 + L * U;
+	Unit *p3 = p2 + L * U;
+	for (size_t j = 0; j < L * U; j += E) {
+		Vec a0[N], a1[N], a2[N], a3[N], t[N], w[N];
+		if (s) {
+			load<0>(t, p0 + j);
+			vmul(a0, vs, t);
+			load<0>(t, p2 + j);
+			vmul(a2, vs, t);
+		} else {
+			load<0>(a0, p0 + j);
+			load<0>(a2, p2 + j);
+		}
+		load<4>(w, tw1 + j);
+		load<0>(a1, p1 + j);
+		vmul(t, w, a1);
+		vsub(a1, a0, t);
+		vadd(a0, a0, t);
+		load<0>(a3, p3 + j);
+		vmul(t, w, a3);
+		vsub(a3, a2, t);
+		vadd(a2, a2, t);
+		load<4>(w, tw2 + j);
+		vmul(t, w, a2);
+		vadd(a2, a0, t);
+		vsub(a0, a0, t);
+		store(p0 + j, a2);
+		store(p2 + j, a0);
+		load<4>(w, tw2 + L * U + j);
+		vmul(t, w, a3);
+		vadd(a3, a1, t);
+		vsub(a1, a1, t);
+		store(p1 + j, a3);
+		store(p3 + j, a1);
+	}
+}
+
+} // namespace
+
+namespace mcl { namespace msm {
+
+bool initFrVecAVX512(mcl::fp::Op& op)
+{
+	if ((mcl::bint::g_cpuType & mcl::bint::tAVX512_IFMA) == 0) return false;
+	if (op.N != U || !op.isMont) return false;
+	const uint64_t mask = (uint64_t(1) << W) - 1;
+	// inv = 1/p mod 2^64
+	const uint64_t p0 = op.p[0];
+	uint64_t inv = p0;
+	for (int i = 0; i < 5; i++) inv *= 2 - p0 * inv;
+	g_.mask = vpbroadcastq(mask);
+	g_.rp = vpbroadcastq((0 - inv) & mask);
+	static const CYBOZU_ALIGN(64) uint64_t idxTbl[4][8] = {
+		{ 0, 4, 8, 12, 1, 5, 9, 13 },
+		{ 2, 6, 10, 14, 3, 7, 11, 15 },
+		{ 0, 1, 2, 3, 8, 9, 10, 11 },
+		{ 4, 5, 6, 7, 12, 13, 14, 15 },
+	};
+	for (size_t i = 0; i < 4; i++) g_.idx[i] = vmovdqu64(idxTbl[i]);
+	broadcast(g_.ap, op.p, 0);
+	op.fp_addVec = addVec;
+	op.fp_subVec = subVec;
+	op.fp_mulVec = mulVec;
+	op.fp_mulScalarVec = mulScalarVec;
+	op.fp_fmaVec = fmaVec;
+	op.fp_radix4Vec = radix4Vec;
+	return true;
+}
+
+} } // mcl::msm
@@ -302,6 +302,16 @@ void mapToInit(const mpz_class& cofactor, const mpz_class &z, int curveType)
 	mapTo.init(cofactor, z, curveType);
 }
 
+#if MCL_MSM == 1 && !defined(MCL_MSM_BLS12_377)
+// use AVX-512 for FpToG1Vec (call it if msm::initMsm returns true)
+void mapTo_WB19_initAVX512()
+{
+	MapTo_WB19& m = mapTo.mapTo_WB19_;
+	msm::initFpToG1AVX512(MapTo_WB19::E1::a_, MapTo_WB19::E1::b_, m.g1c2, m.g1Z, m.g1xnum, m.g1xden, m.g1ynum, m.g1yden);
+	m.FpToG1VecOpti = msm::FpToG1VecAVX512;
+}
+#endif
+
 MCL_DLL_API bool setMapToMode(int mode)
 {
 	return mapTo.setMapToMode(mode);
@@ -354,6 +364,70 @@ MCL_DLL_API void hashAndMapToG2(G2& P, const void *buf, size_t bufSize, const ch
 {
 	mapTo.mapTo_WB19_.msgToG2(P, buf, bufSize, dst, dstSize);
 }
+MCL_DLL_API void hashAndMapToG1Vec(G1 *P, const void *const *msgVec, const size_t *msgSizeVec, size_t n)
+{
+	if (getMapToMode() == MCL_MAP_TO_MODE_HASH_TO_CURVE_07) {
+		mapTo.mapTo_WB19_.msgToG1Vec(P, msgVec, msgSizeVec, n);
+	} else {
+		for (size_t i = 0; i < n; i++) {
+			hashAndMapToG1(P[i], msgVec[i], msgSizeVec[i]);
+		}
+	}
+	G1::normalizeVec(P, P, n);
+}
+MCL_DLL_API void hashAndMapToG2Vec(G2 *P, const void *const *msgVec, const size_t *msgSizeVec, size_t n)
+{
+	int mode = getMapToMode();
+	if (mode == MCL_MAP_TO_MODE_WB19 || mode >= MCL_MAP_TO_MODE_HASH_TO_CURVE_06) {
+		mapTo.mapTo_WB19_.msgToG2Vec(P, msgVec, msgSizeVec, n);
+	} else {
+		for (size_t i = 0; i < n; i++) {
+			hashAndMapToG2(P[i], msgVec[i], msgSizeVec[i]);
+		}
+	}
+	G2::normalizeVec(P, P, n);
+}
+
+namespace local {
+
+template<class G>
+void hashAndMapToVecMT(void (*f)(G *, const void *const *, const size_t *, size_t), G *P, const void *const *msgVec, const size_t *msgSizeVec, size_t n, size_t cpuN)
+{
+#ifdef MCL_USE_OMP
+	const size_t minN = 16;
+	if (cpuN == 0) {
+		cpuN = omp_get_num_procs();
+		if (n < minN * cpuN) {
+			cpuN = (n + minN - 1) / minN;
+		}
+	}
+	if (cpuN <= 1 || n <= cpuN) {
+		f(P, msgVec, msgSizeVec, n);
+		return;
+	}
+	size_t q = n / cpuN;
+	size_t r = n % cpuN;
+	#pragma omp parallel for
+	for (size_t i = 0; i < cpuN; i++) {
+		size_t adj = q * i + fp::min_(i, r);
+		f(P + adj, msgVec + adj, msgSizeVec + adj, q + (i < r));
+	}
+#else
+	(void)cpuN;
+	f(P, msgVec, msgSizeVec, n);
+#endif
+}
+
+} // mcl::local
+
+MCL_DLL_API void hashAndMapToG1VecMT(G1 *P, const void *const *msgVec, const size_t *msgSizeVec, size_t n, size_t cpuN)
+{
+	local::hashAndMapToVecMT<G1>(hashAndMapToG1Vec, P, msgVec, msgSizeVec, n, cpuN);
+}
+MCL_DLL_API void hashAndMapToG2VecMT(G2 *P, const void *const *msgVec, const size_t *msgSizeVec, size_t n, size_t cpuN)
+{
+	local::hashAndMapToVecMT<G2>(hashAndMapToG2Vec, P, msgVec, msgSizeVec, n, cpuN);
+}
 // set the default dst for G1
 // return 0 if success else -1
 MCL_DLL_API bool setDstG1(const char *dst, size_t dstSize)
@@ -70,10 +70,15 @@ struct MapTo_WB19 {
 	Fp g1ynum[16];
 	Fp g1yden[16];
 	mpz_class g1cofactor;
+	mpz_class g1c1mpz; // g1c1 for Fp::powVec
 	int g1Z;
+	static const size_t maxVecN = 16; // the number of messages hashed at once in msgToG1Vec/msgToG2Vec
+	typedef void (*FpToG1VecFunc)(G1 *out, const Fp *u, size_t n);
+	FpToG1VecFunc FpToG1VecOpti; // optimized FpToG1Vec (set after init)
 	void init()
 	{
 		bool b;
+		FpToG1VecOpti = 0;
 		E2::a_.a = 0;
 		E2::a_.b = 240;
 		E2::b_.a = 1012;
@@ -124,6 +129,8 @@ struct MapTo_WB19 {
 			assert(b); (void)b;
 			g1c1.setStr(&b, c1);
 			assert(b); (void)b;
+			g1c1.getMpz(&b, g1c1mpz);
+			assert(b); (void)b;
 			g1c2.setStr(&b, c2);
 			assert(b); (void)b;
 			g1Z = 11;
@@ -316,6 +323,11 @@ struct MapTo_WB19 {
 	// refer (g1xnum, g1xden, g1ynum, g1yden)
 	void iso11(G1& Q, E1& P) const
 	{
+		// P = -P' if u1 = -u0 in FpToG1
+		if (P.z.isZero()) {
+			Q.clear();
+			return;
+		}
 		ec::normalizeJacobi(P);
 		Fp xn, xd, yn, yd;
 		xn = evalPoly2(P.x, g1xnum);
@@ -360,17 +372,16 @@ struct MapTo_WB19 {
 		return sign0 || (zero0 & sign1);
 	}
 	// https://tools.ietf.org/html/draft-irtf-cfrg-hash-to-curve-07#appendix-D.3.5
-	void sswuG1(Fp& xn, Fp& xd, Fp& y, const Fp& u) const
+	// the former part of sswuG1 before y = y^c1
+	void sswuG1Pre(Fp& xn, Fp& xd, Fp& y, Fp& t, Fp& t2, Fp& t3, const Fp& u) const
 	{
 		const Fp& A = E1::a_;
 		const Fp& B = E1::b_;
-		const Fp& c1 = g1c1;
-		const Fp& c2 = g1c2;
 		const int Z = g1Z;
-		Fp u2, u2Z, t, t2, t3;
+		Fp u2Z;
 
-		Fp::sqr(u2, u);
-		Fp::mulUnit(u2Z, u2, Z);
+		Fp::sqr(u2Z, u);
+		Fp::mulUnit(u2Z, u2Z, Z);
 		Fp::sqr(t, u2Z);
 		Fp::add(xd, t, u2Z);
 		if (xd.isZero()) {
@@ -393,20 +404,35 @@ struct MapTo_WB19 {
 		Fp::sqr(y, t2);
 		Fp::mul(t, t3, t2);
 		y *= t;
-		Fp::pow(y, y, c1);
+	}
+	// the latter part of sswuG1 after y = y^c1
+	void sswuG1Post(Fp& xn, Fp& y, const Fp& t, const Fp& t2, const Fp& t3, const Fp& u) const
+	{
+		const Fp& c2 = g1c2;
+		const int Z = g1Z;
+		Fp u2, s;
 		y *= t;
-		Fp::sqr(t, y);
-		t *= t2;
-		if (t != t3) {
-			xn *= u2Z;
+		Fp::sqr(s, y);
+		s *= t2;
+		if (s != t3) {
+			Fp::sqr(u2, u);
 			y *= c2;
 			y *= u2;
 			y *= u;
+			Fp::mulUnit(u2, u2, Z);
+			xn *= u2;
 		}
 		if (isNegSign(u) != isNegSign(y)) {
 			Fp::neg(y, y);
 		}
 	}
+	void sswuG1(Fp& xn, Fp& xd, Fp& y, const Fp& u) const
+	{
+		Fp t, t2, t3;
+		sswuG1Pre(xn, xd, y, t, t2, t3, u);
+		Fp::pow(y, y, g1c1);
+		sswuG1Post(xn, y, t, t2, t3, u);
+	}
 	void sswuG1(E1& pt, const Fp& u) const
 	{
 		Fp xn, y;
@@ -417,10 +443,12 @@ struct MapTo_WB19 {
 		pt.y *= xd;
 		pt.y *= y;
 	}
-	// https://github.com/algorand/bls_sigs_ref
-	void sswuG2(E2& P, const Fp2& t) const
+	/*
+		the former part of sswuG2
+		x0 = x0_num / x0_den, gx0 = x0^3 + a x0 + b = gx0_num / gx0_den where gx0_den = x0_den^3
+	*/
+	void sswuG2Pre(Fp2& t2, Fp2& t2xi, Fp2& x0_num, Fp2& x0_den, Fp2& gx0_num, Fp2& gx0_den, const Fp2& t) const
 	{
-		Fp2 t2, t2xi;
 		Fp2::sqr(t2, t);
 		Fp2 den, den2;
 		mul_xi(t2xi, t2);
@@ -428,7 +456,6 @@ struct MapTo_WB19 {
 		Fp2::sqr(den2, den);
 		// (t^2 * xi)^2 + (t^2 * xi)
 		den += den2;
-		Fp2 x0_num, x0_den;
 		Fp2::add(x0_num, den, 1);
 		x0_num *= E2::b_;
 		if (den.isZero()) {
@@ -436,20 +463,26 @@ struct MapTo_WB19 {
 		} else {
 			Fp2::mul(x0_den, -E2::a_, den);
 		}
-		Fp2 x0_den2, x0_den3, gx0_den, gx0_num;
+		Fp2 x0_den2;
 		Fp2::sqr(x0_den2, x0_den);
-		Fp2::mul(x0_den3, x0_den2, x0_den);
-		gx0_den = x0_den3;
+		Fp2::mul(gx0_den, x0_den2, x0_den);
 
 		Fp2::mul(gx0_num, E2::b_, gx0_den);
-		Fp2 tmp, tmp1, tmp2;
+		Fp2 tmp;
 		Fp2::mul(tmp, E2::a_, x0_num);
 		tmp *= x0_den2;
 		gx0_num += tmp;
 		Fp2::sqr(tmp, x0_num);
 		tmp *= x0_num;
 		gx0_num += tmp;
-
+	}
+	// https://github.com/algorand/bls_sigs_ref
+	void sswuG2(E2& P, const Fp2& t) const
+	{
+		Fp2 t2, t2xi, x0_num, x0_den, gx0_num, gx0_den;
+		sswuG2Pre(t2, t2xi, x0_num, x0_den, gx0_num, gx0_den, t);
+		const Fp2& x0_den3 = gx0_den;
+		Fp2 tmp, tmp1, tmp2;
 		Fp2::sqr(tmp1, gx0_den); // x^2
 		Fp2::sqr(tmp2, tmp1); // x^4
 		tmp1 *= tmp2;
@@ -478,7 +511,8 @@ struct MapTo_WB19 {
 		Fp2 x1_num, x1_den, gx1_num, gx1_den;
 		Fp2::mul(x1_num, t2xi, x0_num);
 		x1_den = x0_den;
-		Fp2::mul(gx1_num, den2, t2xi);
+		Fp2::sqr(gx1_num, t2xi);
+		gx1_num *= t2xi;
 		gx1_num *= gx0_num;
 		gx1_den = gx0_den;
 		candi *= t2;
@@ -540,7 +574,88 @@ struct MapTo_WB19 {
 	}
 	void msgToG2(G2& out, const void *msg, size_t msgSize) const
 	{
-		msgToG2(out, msg, msgSize, dstG2.dst, dstG1.len);
+		msgToG2(out, msg, msgSize, dstG2.dst, dstG2.len);
+	}
+	/*
+		out[i] = Fp2ToG2(t[i * 2], &t[i * 2 + 1]) for i < n (n <= maxVecN)
+		gx0 and gx1 of sswuG2 are inverted and square-rooted at once
+	*/
+	void Fp2ToG2Vec(G2 *out, const Fp2 *t, size_t n) const
+	{
+		assert(n <= maxVecN);
+		const size_t m = n * 2;
+		Fp2 t2[maxVecN * 2], t2xi[maxVecN * 2], xNum[maxVecN * 2], xDen[maxVecN * 2], gx[maxVecN * 2], gxDen[maxVecN * 2];
+		for (size_t i = 0; i < m; i++) {
+			sswuG2Pre(t2[i], t2xi[i], xNum[i], xDen[i], gx[i], gxDen[i], t[i]);
+		}
+		invVec(gxDen, gxDen, m);
+		for (size_t i = 0; i < m; i++) {
+			gx[i] *= gxDen[i];
+		}
+		Fp2 *y = t2;
+		bool isSquare[maxVecN * 2];
+		Fp2::squareRootVec(y, gx, m, isSquare);
+		// x1 = t2xi x0, gx1 = t2xi^3 gx0 if gx0 is not a square
+		size_t idx[maxVecN * 2];
+		size_t retryN = 0;
+		for (size_t i = 0; i < m; i++) {
+			if (isSquare[i]) continue;
+			Fp2 tmp;
+			Fp2::sqr(tmp, t2xi[i]);
+			tmp *= t2xi[i];
+			Fp2::mul(gx[retryN], gx[i], tmp);
+			xNum[i] *= t2xi[i];
+			idx[retryN++] = i;
+		}
+		bool ok = Fp2::squareRootVec(gx, gx, retryN);
+		assert(ok); (void)ok;
+		for (size_t i = 0; i < retryN; i++) {
+			y[idx[i]] = gx[i];
+		}
+		E2 P[maxVecN * 2];
+		for (size_t i = 0; i < m; i++) {
+			if (isNegSign(y[i]) != isNegSign(t[i])) {
+				Fp2::neg(y[i], y[i]);
+			}
+			Fp2 tmp;
+			Fp2::mul(P[i].x, xNum[i], xDen[i]);
+			Fp2::sqr(tmp, xDen[i]);
+			tmp *= xDen[i];
+			Fp2::mul(P[i].y, y[i], tmp);
+			P[i].z = xDen[i];
+		}
+		for (size_t i = 0; i < n; i++) {
+			ec::addJacobi(P[i], P[i * 2], P[i * 2 + 1]);
+		}
+		for (size_t i = 0; i < n; i++) {
+			iso3(out[i], P[i]);
+			mulByCofactorBLS12fast(out[i], out[i]);
+		}
+	}
+	// out[i] = msgToG2(msgVec[i], msgSizeVec[i]) for i < n
+	void msgToG2Vec(G2 *out, const void *const *msgVec, const size_t *msgSizeVec, size_t n, const char *dst, size_t dstSize) const
+	{
+		Fp2 t[maxVecN * 2];
+		uint8_t md[maxVecN * 256];
+		while (n > 0) {
+			const size_t m = fp::min_(n, maxVecN);
+			fp::expand_message_xmdVec(md, 256, msgVec, msgSizeVec, m, dst, dstSize);
+			Fp *x = t[0].getFp0();
+			for (size_t i = 0; i < m * 4; i++) {
+				bool b;
+				x[i].setBigEndianMod(&b, &md[64 * i], 64);
+				assert(b); (void)b;
+			}
+			Fp2ToG2Vec(out, t, m);
+			out += m;
+			msgVec += m;
+			msgSizeVec += m;
+			n -= m;
+		}
+	}
+	void msgToG2Vec(G2 *out, const void *const *msgVec, const size_t *msgSizeVec, size_t n) const
+	{
+		msgToG2Vec(out, msgVec, msgSizeVec, n, dstG2.dst, dstG2.len);
 	}
 	void FpToG1(G1& out, const Fp& u0, const Fp *u1 = 0) const
 	{
@@ -554,16 +669,20 @@ struct MapTo_WB19 {
 		iso11(out, P1);
 		G1::mulGeneric(out, out, g1cofactor);
 	}
-	void msgToG1(G1& out, const void *msg, size_t msgSize, const char *dst, size_t dstSize) const
+	void hashToFp(Fp out[2], const void *msg, size_t msgSize, const char *dst, size_t dstSize) const
 	{
 		uint8_t md[128];
 		fp::expand_message_xmd(md, sizeof(md), msg, msgSize, dst, dstSize);
-		Fp u[2];
 		for (size_t i = 0; i < 2; i++) {
 			bool b;
-			u[i].setBigEndianMod(&b, &md[64 * i], 64);
+			out[i].setBigEndianMod(&b, &md[64 * i], 64);
 			assert(b); (void)b;
 		}
+	}
+	void msgToG1(G1& out, const void *msg, size_t msgSize, const char *dst, size_t dstSize) const
+	{
+		Fp u[2];
+		hashToFp(u, msg, msgSize, dst, dstSize);
 		FpToG1(out, u[0], &u[1]);
 	}
 
@@ -571,6 +690,67 @@ struct MapTo_WB19 {
 	{
 		msgToG1(out, msg, msgSize, dstG1.dst, dstG1.len);
 	}
+	/*
+		out[i] = FpToG1(u[i * 2], &u[i * 2 + 1]) for i < n (n <= maxVecN)
+		y^c1 of sswuG1 are computed by Fp::powVec and the inversions for iso11 by invVec
+	*/
+	void FpToG1Vec(G1 *out, const Fp *u, size_t n) const
+	{
+		assert(n <= maxVecN);
+		if (FpToG1VecOpti) {
+			FpToG1VecOpti(out, u, n);
+			return;
+		}
+		const size_t m = n * 2;
+		Fp xn[maxVecN * 2], xd[maxVecN * 2], y[maxVecN * 2], t[maxVecN * 2], t2[maxVecN * 2], t3[maxVecN * 2];
+		for (size_t i = 0; i < m; i++) {
+			sswuG1Pre(xn[i], xd[i], y[i], t[i], t2[i], t3[i], u[i]);
+		}
+		Fp::powVec(y, y, g1c1mpz, m);
+		E1 P[maxVecN * 2];
+		for (size_t i = 0; i < m; i++) {
+			sswuG1Post(xn[i], y[i], t[i], t2[i], t3[i], u[i]);
+			Fp::mul(P[i].x, xn[i], xd[i]);
+			Fp::sqr(P[i].y, xd[i]);
+			P[i].y *= xd[i];
+			P[i].y *= y[i];
+			P[i].z = xd[i];
+		}
+		for (size_t i = 0; i < n; i++) {
+			ec::addJacobi(P[i], P[i * 2], P[i * 2 + 1]);
+			xd[i] = P[i].z;
+		}
+		invVec(xd, xd, n);
+		for (size_t i = 0; i < n; i++) {
+			if (!P[i].z.isZero()) ec::local::_normalizeJacobi(P[i], P[i], xd[i]);
+			iso11(out[i], P[i]);
+			G1::mulGeneric(out[i], out[i], g1cofactor);
+		}
+	}
+	// out[i] = msgToG1(msgVec[i], msgSizeVec[i]) for i < n
+	void msgToG1Vec(G1 *out, const void *const *msgVec, const size_t *msgSizeVec, size_t n, const char *dst, size_t dstSize) const
+	{
+		Fp u[maxVecN * 2];
+		uint8_t md[maxVecN * 128];
+		while (n > 0) {
+			const size_t m = fp::min_(n, maxVecN);
+			fp::expand_message_xmdVec(md, 128, msgVec, msgSizeVec, m, dst, dstSize);
+			for (size_t i = 0; i < m * 2; i++) {
+				bool b;
+				u[i].setBigEndianMod(&b, &md[64 * i], 64);
+				assert(b); (void)b;
+			}
+			FpToG1Vec(out, u, m);
+			out += m;
+			msgVec += m;
+			msgSizeVec += m;
+			n -= m;
+		}
+	}
+	void msgToG1Vec(G1 *out, const void *const *msgVec, const size_t *msgSizeVec, size_t n) const
+	{
+		msgToG1Vec(out, msgVec, msgSizeVec, n, dstG1.dst, dstG1.len);
+	}
 };
 
 } // mcl
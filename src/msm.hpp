@@ -16,6 +16,19 @@ namespace msm {
 bool initMsm(const mcl::CurveParam& cp);
 void mulVecAVX512(G1& P, G1 *x, const Fr *y, size_t n, size_t b);
 void mulEachAVX512(G1 *x, const Fr *y, size_t n);
+// set the vector operations of op if AVX-512 IFMA is available
+bool initFrVecAVX512(mcl::fp::Op& op);
+// set the vector operations of op of Fp (call it if initMsm returns true)
+void initFpVecAVX512(mcl::fp::Op& op);
+// set the parameters A, B, c2, Z of sswuG1 and the coefficients of iso11 in MapTo_WB19
+void initFpToG1AVX512(const Fp& A, const Fp& B, const Fp& c2, int Z, const Fp xnum[12], const Fp xden[11], const Fp ynum[16], const Fp yden[16]);
+// out[i] = FpToG1(u[i * 2], &u[i * 2 + 1]) of MapTo_WB19 for i < n (call initFpToG1AVX512 before)
+void FpToG1VecAVX512(G1 *out, const Fp *u, size_t n);
+/*
+	update the SHA-256 state h[j][i] of the i-th stream (i < 16) with blkN[i] blocks of blk[i]
+	the stream such that blkN[i] = 0 is unchanged
+*/
+void sha256BlockVecAVX512(uint32_t h[8][16], const uint8_t *const blk[16], const size_t blkN[16]);
 
 } // mcl::msm
 #endif
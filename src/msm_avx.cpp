@@ -21,6 +21,7 @@
 #pragma GCC diagnostic ignored "-Wstrict-aliasing"
 #ifndef __clang__
 #pragma GCC diagnostic ignored "-Wmaybe-uninitialized" // false positive
+#pragma GCC diagnostic ignored "-Wuninitialized" // false positive in avx512fintrin.h
 #pragma GCC diagnostic ignored "-Wignored-attributes" // false positive
 #endif
 #endif
@@ -1570,6 +1571,152 @@ void mulVecAVX512T(G1& _P, G1 *_x, const Fr *_y, size_t n, size_t bucket = 0)
 	}
 }
 
+// set x to all the lanes of z
+inline void setBroadcast(FpM& z, const mcl::Fp& x)
+{
+	CYBOZU_ALIGN(64) FpA v[M];
+	for (size_t i = 0; i < M; i++) {
+		memcpy(v[i].v, x.getUnit(), sizeof(FpA));
+	}
+	z.setFpA(v);
+}
+
+/*
+	the parameters of sswuG1 and iso11 of MapTo_WB19 in FpM
+	E' : y^2 = x^3 + A x + B is 11-isogenous to E : y^2 = x^3 + 4
+*/
+struct MapToG1M {
+	FpM A, B, c2, Z, ZA;
+	Vec c1[6]; // (p - 3) / 4
+	FpM xnum[12], xden[11], ynum[16], yden[16];
+	static const uint64_t cofactor = 0xd201000000010001; // h_eff of G1
+	template<size_t n>
+	static void evalPoly(FpM& z, const FpM& x, const FpM (&c)[n])
+	{
+		z = c[n - 1];
+		for (size_t i = 1; i < n; i++) {
+			FpM::mul(z, z, x);
+			FpM::add(z, z, c[n - 1 - i]);
+		}
+	}
+	// (xn/xd, y) = sswuG1(u) (see MapTo_WB19::sswuG1)
+	void sswu(FpM& xn, FpM& xd, FpM& y, const FpM& u) const
+	{
+		FpM u2, u2Z, t, t2, t3;
+		FpM::sqr(u2, u);
+		FpM::mul(u2Z, u2, Z);
+		FpM::sqr(t, u2Z);
+		FpM::add(xd, t, u2Z);
+		const Vmask exc = xd.isZero();
+		FpM::add(xn, xd, FpM::one());
+		FpM::mul(xn, xn, B);
+		FpM::mul(xd, xd, A);
+		FpM::neg(xd, xd);
+		xn = FpM::select(exc, B, xn);
+		xd = FpM::select(exc, ZA, xd);
+		FpM::sqr(t, xd);
+		FpM::mul(t2, t, xd);
+		FpM::mul(t, t, A);
+		FpM::sqr(t3, xn);
+		FpM::add(t3, t3, t);
+		FpM::mul(t3, t3, xn);
+		FpM::mul(t, t2, B);
+		FpM::add(t3, t3, t);
+		FpM::sqr(y, t2);
+		FpM::mul(t, t3, t2);
+		FpM::mul(y, y, t);
+		FpM::pow(y, y, c1, 6);
+		FpM::mul(y, y, t);
+		FpM::sqr(t, y);
+		FpM::mul(t, t, t2);
+		const Vmask isSquare = t.isEqualAll(t3);
+		FpM::mul(t, y, c2);
+		FpM::mul(t, t, u2);
+		FpM::mul(t, t, u);
+		y = FpM::select(isSquare, y, t);
+		FpM::mul(t, xn, u2Z);
+		xn = FpM::select(isSquare, xn, t);
+		// sgn0(u) == sgn0(y)
+		FpM a, b;
+		FpM::mul(a, u, FpM::rawOne());
+		FpM::mul(b, y, FpM::rawOne());
+		const Vmask neg = vpcmpneqq(vpandq(vpxorq(a.v[0], b.v[0]), vpbroadcastq(1)), vzero());
+		y = FpM::select(neg, y.neg(), y);
+	}
+	// P = FpToG1(u0, &u1) of MapTo_WB19 in the projective coordinates
+	void FpToG1(EcM& P, const FpM& u0, const FpM& u1) const
+	{
+		FpM xn0, xd0, y0, xn1, xd1, y1;
+		sswu(xn0, xd0, y0, u0);
+		sswu(xn1, xd1, y1, u1);
+		/*
+			(x2, y2) = (xn0/xd0, y0) + (xn1/xd1, y1) on E' with lambda = num/den
+			add : num = (y1 - y0) xd0 xd1, den = xn1 xd0 - xn0 xd1
+			dbl : num = 3 xn0^2 + A xd0^2, den = 2 y0 xd0^2
+		*/
+		FpM num, den, d01, t, s;
+		FpM::mul(d01, xd0, xd1);
+		FpM::sub(num, y1, y0);
+		FpM::mul(num, num, d01);
+		FpM::mul(t, xn1, xd0);
+		FpM::mul(s, xn0, xd1);
+		FpM::sub(den, t, s);
+		const Vmask isDbl = den.isZero() & y0.isEqualAll(y1);
+		FpM::sqr(s, xd0);
+		FpM::sqr(t, xn0);
+		FpM dnum, dden;
+		FpM::add(dnum, t, t);
+		FpM::add(dnum, dnum, t);
+		FpM::mul(t, s, A);
+		FpM::add(dnum, dnum, t);
+		FpM::add(dden, y0, y0);
+		FpM::mul(dden, dden, s);
+		num = FpM::select(isDbl, dnum, num);
+		den = FpM::select(isDbl, dden, den);
+		// P0 = -P1 or y0 = 0 for dbl
+		const Vmask isZero = den.isZero();
+		// 1/den, 1/xd0, 1/xd1 by one inversion
+		FpM inv, x0, x1, L;
+		FpM::mul(t, d01, den);
+		FpM::inv(inv, t);
+		FpM::mul(L, inv, d01);
+		FpM::mul(L, L, num);
+		FpM::mul(t, inv, den);
+		FpM::mul(x0, t, xd1);
+		FpM::mul(x0, x0, xn0);
+		FpM::mul(x1, t, xd0);
+		FpM::mul(x1, x1, xn1);
+		FpM x2, y2;
+		FpM::sqr(x2, L);
+		FpM::sub(x2, x2, x0);
+		FpM::sub(x2, x2, x1);
+		FpM::sub(y2, x0, x2);
+		FpM::mul(y2, y2, L);
+		FpM::sub(y2, y2, y0);
+		/*
+			iso11 : (x, y) -> (xn/xd, y yn/yd) = [xn yd:y yn xd:xd yd] in the projective coordinates
+		*/
+		FpM xn, xd, yn, yd;
+		evalPoly(xn, x2, xnum);
+		evalPoly(xd, x2, xden);
+		evalPoly(yn, x2, ynum);
+		evalPoly(yd, x2, yden);
+		FpM::mul(P.x, xn, yd);
+		FpM::mul(P.y, y2, yn);
+		FpM::mul(P.y, P.y, xd);
+		FpM::mul(P.z, xd, yd);
+		P = EcM::select(isZero, EcM::zeroProj_, P);
+		// P = cofactor * P by the complete formulas
+		const EcM Q = P;
+		for (int i = 62; i >= 0; i--) {
+			EcM::dbl(P, P);
+			if ((cofactor >> i) & 1) EcM::add(P, P, Q);
+		}
+	}
+};
+
+MapToG1M g_mapToG1;
+
 } // namespace
 
 namespace mcl { namespace msm {
@@ -1620,6 +1767,90 @@ void mulEachAVX512(G1 *_x, const Fr *_y, size_t n)
 	}
 }
 
+/*
+	y[i] = x[i]^e for i < n (y may be equal to x)
+	x[i] and y[i] are in Montgomery form of Fp
+	8 elements share one exponentiation ladder in the lanes of FpM
+*/
+void powVecAVX512(Unit *y, const Unit *x, size_t n, const Unit *e, size_t en)
+{
+	const size_t U = sizeof(FpA) / sizeof(Unit);
+	assert(en <= N);
+	Vec ev[N];
+	for (size_t i = 0; i < N; i++) {
+		ev[i] = vpbroadcastq(i < en ? e[i] : 0);
+	}
+	for (size_t i = 0; i < n; i += M) {
+		const size_t m = fp::min_(M, n - i);
+		const FpA *src = (const FpA*)(x + i * U);
+		FpA *dst = (FpA*)(y + i * U);
+		CYBOZU_ALIGN(64) FpA t[M];
+		if (m < M) {
+			memset(t, 0, sizeof(t));
+			memcpy(t, src, sizeof(FpA) * m);
+			src = t;
+		}
+		FpM a, b;
+		a.setFpA(src);
+		FpM::pow(b, a, ev, en);
+		if (m < M) {
+			b.getFpA(t);
+			memcpy(dst, t, sizeof(FpA) * m);
+		} else {
+			b.getFpA(dst);
+		}
+	}
+}
+
+void initFpVecAVX512(mcl::fp::Op& op)
+{
+	op.fp_powVec = powVecAVX512;
+}
+
+void initFpToG1AVX512(const Fp& A, const Fp& B, const Fp& c2, int Z, const Fp xnum[12], const Fp xden[11], const Fp ynum[16], const Fp yden[16])
+{
+	MapToG1M& c = g_mapToG1;
+	setBroadcast(c.A, A);
+	setBroadcast(c.B, B);
+	setBroadcast(c.c2, c2);
+	setBroadcast(c.Z, Fp(Z));
+	FpM::mul(c.ZA, c.Z, c.A);
+	mpz_class e = (Fp::getOp().mp - 3) / 4;
+	Unit eu[6];
+	bool b;
+	mcl::gmp::getArray(&b, eu, 6, e);
+	assert(b); (void)b;
+	for (size_t i = 0; i < 6; i++) {
+		c.c1[i] = vpbroadcastq(eu[i]);
+	}
+	for (size_t i = 0; i < 12; i++) setBroadcast(c.xnum[i], xnum[i]);
+	for (size_t i = 0; i < 11; i++) setBroadcast(c.xden[i], xden[i]);
+	for (size_t i = 0; i < 16; i++) setBroadcast(c.ynum[i], ynum[i]);
+	for (size_t i = 0; i < 16; i++) setBroadcast(c.yden[i], yden[i]);
+}
+
+void FpToG1VecAVX512(G1 *out, const Fp *u, size_t n)
+{
+	for (size_t i = 0; i < n; i += M) {
+		const size_t m = fp::min_(M, n - i);
+		CYBOZU_ALIGN(64) FpA a[M], b[M];
+		memset(a, 0, sizeof(a));
+		memset(b, 0, sizeof(b));
+		for (size_t j = 0; j < m; j++) {
+			memcpy(a[j].v, u[(i + j) * 2 + 0].getUnit(), sizeof(FpA));
+			memcpy(b[j].v, u[(i + j) * 2 + 1].getUnit(), sizeof(FpA));
+		}
+		FpM u0, u1;
+		u0.setFpA(a);
+		u1.setFpA(b);
+		EcM P;
+		g_mapToG1.FpToG1(P, u0, u1);
+		CYBOZU_ALIGN(64) G1A t[M];
+		P.getG1A(t);
+		memcpy((G1A*)out + i, t, sizeof(G1A) * m);
+	}
+}
+
 bool initMsm(const mcl::CurveParam& cp)
 {
 	assert(EcM::a_ == 0);
@@ -23,6 +23,9 @@ namespace mcl {
 
 // mapTo
 void mapToInit(const mpz_class& cofactor, const mpz_class &z, int curveType);
+#if MCL_MSM == 1 && !defined(MCL_MSM_BLS12_377)
+void mapTo_WB19_initAVX512();
+#endif
 
 typedef mcl::FixedArray<int8_t, 128> Int8Vec;
 
@@ -97,6 +100,7 @@ struct Param {
 
 	// for initG1only
 	G1 basePoint;
+	mcl::fp::SignedWindowMethod<G1> basePointCT;
 
 	void init(bool *pb, const mcl::CurveParam& cp)
 	{
@@ -184,6 +188,10 @@ struct Param {
 	void initG1only(bool *pb, const mcl::EcParam& para)
 	{
 		mcl::initCurve<G1>(pb, para.curveType, &basePoint);
+		if (!*pb) return;
+		// the cost of the masked scan of mulCT is linear in 2^winSize
+		basePointCT.init(pb, basePoint, Fr::getBitSize(), 5);
+		if (!*pb) return;
 		mapToInit(0, 0, para.curveType);
 	}
 };
@@ -448,6 +456,11 @@ inline void mulFp6cb_by_G1xy(Fp6& y, const Fp6& x, const G1& P)
 */
 inline void Fp6mul_01(Fp6& z, const Fp6& x, const Fp2& d, const Fp2& e)
 {
+	const mcl::fp::Op& op = Fp::getOp();
+	if (op.fp6_mul01A_) {
+		op.fp6_mul01A_(reinterpret_cast<Unit*>(&z), x.getFp0()->getUnit(), d.getUnit(), e.getUnit());
+		return;
+	}
 	const Fp2& a = x.a;
 	const Fp2& b = x.b;
 	const Fp2& c = x.c;
@@ -1205,7 +1218,12 @@ MCL_DLL_API void init(bool *pb, const mcl::CurveParam& cp)
 	if (mcl::msm::initMsm(cp)) {
 		G1::setMulVecOpti(mcl::msm::mulVecAVX512);
 		G1::setMulEachOpti(mcl::msm::mulEachAVX512);
+		mcl::msm::initFpVecAVX512(Fp::getOpNonConst());
+#ifndef MCL_MSM_BLS12_377
+		mapTo_WB19_initAVX512();
+#endif
 	}
+	mcl::msm::initFrVecAVX512(Fr::getOpNonConst());
 #endif
 	Fp12::setPowVecGLV(powVecGLV);
 	G1::setCompressedExpression();
@@ -1242,6 +1260,15 @@ MCL_DLL_API const G1& getG1basePoint()
 	return s_param.basePoint;
 }
 
+MCL_DLL_API void mulG1basePointCT(G1& Q, const Fr& y)
+{
+	if (s_param.basePoint.isZero()) {
+		Q.clear();
+		return;
+	}
+	s_param.basePointCT.mulCT(Q, y);
+}
+
 MCL_DLL_API bool isValidGT(const GT& x)
 {
 	GT y;
@@ -0,0 +1,137 @@
+/**
+	@file
+	@brief multi-buffer SHA-256 compression with AVX-512
+	@author MITSUNARI Shigeo(@herumi)
+	@license modified new BSD license
+	http://opensource.org/licenses/BSD-3-Clause
+*/
+#define MCL_DLL_EXPORT
+#include <mcl/bls12_381.hpp>
+#include <stdint.h>
+#include "avx512.hpp"
+#include "msm.hpp"
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic ignored "-Wunused-function"
+#ifndef __clang__
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized" // false positive in avx512fintrin.h
+#pragma GCC diagnostic ignored "-Wuninitialized" // false positive in avx512fintrin.h
+#endif
+#endif
+
+/*
+	16 independent SHA-256 streams are processed at once
+	the i-th 32-bit element of a register belongs to the i-th stream
+*/
+namespace {
+
+typedef __m512i V;
+
+const uint32_t K[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+inline V add(const V& a, const V& b) { return _mm512_add_epi32(a, b); }
+// a ^ b ^ c
+inline V xor3(const V& a, const V& b, const V& c) { return _mm512_ternarylogic_epi32(a, b, c, 0x96); }
+// e ? f : g
+inline V ch(const V& e, const V& f, const V& g) { return _mm512_ternarylogic_epi32(e, f, g, 0xca); }
+// majority of a, b, c
+inline V maj(const V& a, const V& b, const V& c) { return _mm512_ternarylogic_epi32(a, b, c, 0xe8); }
+
+inline V S0(const V& a)
+{
+	return xor3(_mm512_ror_epi32(a, 2), _mm512_ror_epi32(a, 13), _mm512_ror_epi32(a, 22));
+}
+inline V S1(const V& e)
+{
+	return xor3(_mm512_ror_epi32(e, 6), _mm512_ror_epi32(e, 11), _mm512_ror_epi32(e, 25));
+}
+inline V s0(const V& w)
+{
+	return xor3(_mm512_ror_epi32(w, 7), _mm512_ror_epi32(w, 18), _mm512_srli_epi32(w, 3));
+}
+inline V s1(const V& w)
+{
+	return xor3(_mm512_ror_epi32(w, 17), _mm512_ror_epi32(w, 19), _mm512_srli_epi32(w, 10));
+}
+
+inline uint32_t load32BE(const uint8_t *p)
+{
+	return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+
+} // anonymous
+
+namespace mcl { namespace msm {
+
+void sha256BlockVecAVX512(uint32_t h[8][16], const uint8_t *const blk[16], const size_t blkN[16])
+{
+	size_t maxN = 0;
+	for (size_t i = 0; i < 16; i++) {
+		if (blkN[i] > maxN) maxN = blkN[i];
+	}
+	V s[8];
+	for (int i = 0; i < 8; i++) {
+		s[i] = _mm512_loadu_si512(h[i]);
+	}
+	for (size_t b = 0; b < maxN; b++) {
+		// transpose the b-th block of each stream
+		uint32_t tmp[16][16];
+		__mmask16 m = 0;
+		for (size_t i = 0; i < 16; i++) {
+			if (b < blkN[i]) {
+				m |= __mmask16(1u << i);
+				const uint8_t *p = blk[i] + b * 64;
+				for (int t = 0; t < 16; t++) {
+					tmp[t][i] = load32BE(p + t * 4);
+				}
+			} else {
+				for (int t = 0; t < 16; t++) {
+					tmp[t][i] = 0;
+				}
+			}
+		}
+		V w[16];
+		for (int t = 0; t < 16; t++) {
+			w[t] = _mm512_loadu_si512(tmp[t]);
+		}
+		V a = s[0], bb = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], hh = s[7];
+		for (int t = 0; t < 64; t++) {
+			if (t >= 16) {
+				w[t & 15] = add(add(w[t & 15], s0(w[(t - 15) & 15])), add(w[(t - 7) & 15], s1(w[(t - 2) & 15])));
+			}
+			V t1 = add(add(hh, S1(e)), add(ch(e, f, g), add(_mm512_set1_epi32(int(K[t])), w[t & 15])));
+			V t2 = add(S0(a), maj(a, bb, c));
+			hh = g;
+			g = f;
+			f = e;
+			e = add(d, t1);
+			d = c;
+			c = bb;
+			bb = a;
+			a = add(t1, t2);
+		}
+		// streams without the b-th block are unchanged
+		s[0] = _mm512_mask_add_epi32(s[0], m, s[0], a);
+		s[1] = _mm512_mask_add_epi32(s[1], m, s[1], bb);
+		s[2] = _mm512_mask_add_epi32(s[2], m, s[2], c);
+		s[3] = _mm512_mask_add_epi32(s[3], m, s[3], d);
+		s[4] = _mm512_mask_add_epi32(s[4], m, s[4], e);
+		s[5] = _mm512_mask_add_epi32(s[5], m, s[5], f);
+		s[6] = _mm512_mask_add_epi32(s[6], m, s[6], g);
+		s[7] = _mm512_mask_add_epi32(s[7], m, s[7], hh);
+	}
+	for (int i = 0; i < 8; i++) {
+		_mm512_storeu_si512(h[i], s[i]);
+	}
+}
+
+} } // mcl::msm
@@ -337,6 +337,76 @@ int sheEncIntVecGT(sheCipherTextGT *c, const shePublicKey *pub, const void *buf,
 	return encIntVecT(c, pub, buf, bufSize);
 }
 
+template<class CT, class PK>
+int encVecT(CT *c, const PK *pub, const mclInt *m, mclSize n, mclSize cpuN)
+	try
+{
+	cast(pub)->encVecMT(cast(c), m, n, cpuN);
+	return 0;
+} catch (std::exception&) {
+	return -1;
+}
+
+int sheEncG1Vec(sheCipherTextG1 *c, const shePublicKey *pub, const mclInt *m, mclSize n)
+{
+	return encVecT(c, pub, m, n, 1);
+}
+
+int sheEncG2Vec(sheCipherTextG2 *c, const shePublicKey *pub, const mclInt *m, mclSize n)
+{
+	return encVecT(c, pub, m, n, 1);
+}
+
+int sheEncGTVec(sheCipherTextGT *c, const shePublicKey *pub, const mclInt *m, mclSize n)
+{
+	return encVecT(c, pub, m, n, 1);
+}
+
+int shePrecomputedPublicKeyEncG1Vec(sheCipherTextG1 *c, const shePrecomputedPublicKey *ppub, const mclInt *m, mclSize n)
+{
+	return encVecT(c, ppub, m, n, 1);
+}
+
+int shePrecomputedPublicKeyEncG2Vec(sheCipherTextG2 *c, const shePrecomputedPublicKey *ppub, const mclInt *m, mclSize n)
+{
+	return encVecT(c, ppub, m, n, 1);
+}
+
+int shePrecomputedPublicKeyEncGTVec(sheCipherTextGT *c, const shePrecomputedPublicKey *ppub, const mclInt *m, mclSize n)
+{
+	return encVecT(c, ppub, m, n, 1);
+}
+
+int sheEncG1VecMT(sheCipherTextG1 *c, const shePublicKey *pub, const mclInt *m, mclSize n, mclSize cpuN)
+{
+	return encVecT(c, pub, m, n, cpuN);
+}
+
+int sheEncG2VecMT(sheCipherTextG2 *c, const shePublicKey *pub, const mclInt *m, mclSize n, mclSize cpuN)
+{
+	return encVecT(c, pub, m, n, cpuN);
+}
+
+int sheEncGTVecMT(sheCipherTextGT *c, const shePublicKey *pub, const mclInt *m, mclSize n, mclSize cpuN)
+{
+	return encVecT(c, pub, m, n, cpuN);
+}
+
+int shePrecomputedPublicKeyEncG1VecMT(sheCipherTextG1 *c, const shePrecomputedPublicKey *ppub, const mclInt *m, mclSize n, mclSize cpuN)
+{
+	return encVecT(c, ppub, m, n, cpuN);
+}
+
+int shePrecomputedPublicKeyEncG2VecMT(sheCipherTextG2 *c, const shePrecomputedPublicKey *ppub, const mclInt *m, mclSize n, mclSize cpuN)
+{
+	return encVecT(c, ppub, m, n, cpuN);
+}
+
+int shePrecomputedPublicKeyEncGTVecMT(sheCipherTextGT *c, const shePrecomputedPublicKey *ppub, const mclInt *m, mclSize n, mclSize cpuN)
+{
+	return encVecT(c, ppub, m, n, cpuN);
+}
+
 template<class CT, class PK>
 int encWithZkpBinT(CT *c, sheZkpBin *zkp, const PK *pub, int m)
 {
@@ -547,6 +617,86 @@ int sheAddGT(sheCipherTextGT *z, const sheCipherTextGT *x, const sheCipherTextGT
 	return addT(*cast(z), *cast(x), *cast(y));
 }
 
+template<class CT>
+int addVecT(CT *z, const CT *x, const CT *y, mclSize n, mclSize cpuN)
+	try
+{
+	CT::addVecMT(z, x, y, n, cpuN);
+	return 0;
+} catch (std::exception&) {
+	return -1;
+}
+
+int sheAddG1Vec(sheCipherTextG1 *z, const sheCipherTextG1 *x, const sheCipherTextG1 *y, mclSize n)
+{
+	return addVecT(cast(z), cast(x), cast(y), n, 1);
+}
+
+int sheAddG2Vec(sheCipherTextG2 *z, const sheCipherTextG2 *x, const sheCipherTextG2 *y, mclSize n)
+{
+	return addVecT(cast(z), cast(x), cast(y), n, 1);
+}
+
+int sheAddGTVec(sheCipherTextGT *z, const sheCipherTextGT *x, const sheCipherTextGT *y, mclSize n)
+{
+	return addVecT(cast(z), cast(x), cast(y), n, 1);
+}
+
+int sheAddG1VecMT(sheCipherTextG1 *z, const sheCipherTextG1 *x, const sheCipherTextG1 *y, mclSize n, mclSize cpuN)
+{
+	return addVecT(cast(z), cast(x), cast(y), n, cpuN);
+}
+
+int sheAddG2VecMT(sheCipherTextG2 *z, const sheCipherTextG2 *x, const sheCipherTextG2 *y, mclSize n, mclSize cpuN)
+{
+	return addVecT(cast(z), cast(x), cast(y), n, cpuN);
+}
+
+int sheAddGTVecMT(sheCipherTextGT *z, const sheCipherTextGT *x, const sheCipherTextGT *y, mclSize n, mclSize cpuN)
+{
+	return addVecT(cast(z), cast(x), cast(y), n, cpuN);
+}
+
+template<class CT>
+int sumVecT(CT& z, const CT *x, mclSize n, mclSize cpuN)
+	try
+{
+	CT::sumVecMT(z, x, n, cpuN);
+	return 0;
+} catch (std::exception&) {
+	return -1;
+}
+
+int sheSumG1Vec(sheCipherTextG1 *z, const sheCipherTextG1 *x, mclSize n)
+{
+	return sumVecT(*cast(z), cast(x), n, 1);
+}
+
+int sheSumG2Vec(sheCipherTextG2 *z, const sheCipherTextG2 *x, mclSize n)
+{
+	return sumVecT(*cast(z), cast(x), n, 1);
+}
+
+int sheSumGTVec(sheCipherTextGT *z, const sheCipherTextGT *x, mclSize n)
+{
+	return sumVecT(*cast(z), cast(x), n, 1);
+}
+
+int sheSumG1VecMT(sheCipherTextG1 *z, const sheCipherTextG1 *x, mclSize n, mclSize cpuN)
+{
+	return sumVecT(*cast(z), cast(x), n, cpuN);
+}
+
+int sheSumG2VecMT(sheCipherTextG2 *z, const sheCipherTextG2 *x, mclSize n, mclSize cpuN)
+{
+	return sumVecT(*cast(z), cast(x), n, cpuN);
+}
+
+int sheSumGTVecMT(sheCipherTextGT *z, const sheCipherTextGT *x, mclSize n, mclSize cpuN)
+{
+	return sumVecT(*cast(z), cast(x), n, cpuN);
+}
+
 template<class CT>
 int subT(CT& z, const CT& x, const CT& y)
 {
@@ -635,6 +785,20 @@ int sheFinalExpGT(sheCipherTextGT *y, const sheCipherTextGT *x)
 	return 0;
 }
 
+int sheMulVec(sheCipherTextGT *z, const sheCipherTextG1 *x, const sheCipherTextG2 *y, mclSize n)
+{
+	return sheMulVecMT(z, x, y, n, 1);
+}
+
+int sheMulVecMT(sheCipherTextGT *z, const sheCipherTextG1 *x, const sheCipherTextG2 *y, mclSize n, mclSize cpuN)
+	try
+{
+	CipherTextGT::mulVecMT(*cast(z), cast(x), cast(y), n, cpuN);
+	return 0;
+} catch (std::exception&) {
+	return -1;
+}
+
 template<class CT>
 int reRandT(CT& c, const shePublicKey *pub)
 {
@@ -657,6 +821,76 @@ int sheReRandGT(sheCipherTextGT *c, const shePublicKey *pub)
 	return reRandT(*cast(c), pub);
 }
 
+template<class PK, class CT>
+int reRandVecT(CT *c, const PK *pub, mclSize n, mclSize cpuN)
+	try
+{
+	pub->reRandVecMT(c, n, cpuN);
+	return 0;
+} catch (std::exception&) {
+	return -1;
+}
+
+int sheReRandG1Vec(sheCipherTextG1 *c, const shePublicKey *pub, mclSize n)
+{
+	return reRandVecT(cast(c), cast(pub), n, 1);
+}
+
+int sheReRandG2Vec(sheCipherTextG2 *c, const shePublicKey *pub, mclSize n)
+{
+	return reRandVecT(cast(c), cast(pub), n, 1);
+}
+
+int sheReRandGTVec(sheCipherTextGT *c, const shePublicKey *pub, mclSize n)
+{
+	return reRandVecT(cast(c), cast(pub), n, 1);
+}
+
+int shePrecomputedPublicKeyReRandG1Vec(sheCipherTextG1 *c, const shePrecomputedPublicKey *ppub, mclSize n)
+{
+	return reRandVecT(cast(c), cast(ppub), n, 1);
+}
+
+int shePrecomputedPublicKeyReRandG2Vec(sheCipherTextG2 *c, const shePrecomputedPublicKey *ppub, mclSize n)
+{
+	return reRandVecT(cast(c), cast(ppub), n, 1);
+}
+
+int shePrecomputedPublicKeyReRandGTVec(sheCipherTextGT *c, const shePrecomputedPublicKey *ppub, mclSize n)
+{
+	return reRandVecT(cast(c), cast(ppub), n, 1);
+}
+
+int sheReRandG1VecMT(sheCipherTextG1 *c, const shePublicKey *pub, mclSize n, mclSize cpuN)
+{
+	return reRandVecT(cast(c), cast(pub), n, cpuN);
+}
+
+int sheReRandG2VecMT(sheCipherTextG2 *c, const shePublicKey *pub, mclSize n, mclSize cpuN)
+{
+	return reRandVecT(cast(c), cast(pub), n, cpuN);
+}
+
+int sheReRandGTVecMT(sheCipherTextGT *c, const shePublicKey *pub, mclSize n, mclSize cpuN)
+{
+	return reRandVecT(cast(c), cast(pub), n, cpuN);
+}
+
+int shePrecomputedPublicKeyReRandG1VecMT(sheCipherTextG1 *c, const shePrecomputedPublicKey *ppub, mclSize n, mclSize cpuN)
+{
+	return reRandVecT(cast(c), cast(ppub), n, cpuN);
+}
+
+int shePrecomputedPublicKeyReRandG2VecMT(sheCipherTextG2 *c, const shePrecomputedPublicKey *ppub, mclSize n, mclSize cpuN)
+{
+	return reRandVecT(cast(c), cast(ppub), n, cpuN);
+}
+
+int shePrecomputedPublicKeyReRandGTVecMT(sheCipherTextGT *c, const shePrecomputedPublicKey *ppub, mclSize n, mclSize cpuN)
+{
+	return reRandVecT(cast(c), cast(ppub), n, cpuN);
+}
+
 template<class CT>
 int convert(sheCipherTextGT *y, const shePublicKey *pub, const CT *x)
 {
@@ -674,6 +908,36 @@ int sheConvertG2(sheCipherTextGT *y, const shePublicKey *pub, const sheCipherTex
 	return convert(y, pub, x);
 }
 
+template<class CT>
+int convertVecT(sheCipherTextGT *y, const shePublicKey *pub, const CT *x, mclSize n, mclSize cpuN)
+	try
+{
+	cast(pub)->convertVecMT(cast(y), cast(x), n, cpuN);
+	return 0;
+} catch (std::exception&) {
+	return -1;
+}
+
+int sheConvertG1Vec(sheCipherTextGT *y, const shePublicKey *pub, const sheCipherTextG1 *x, mclSize n)
+{
+	return convertVecT(y, pub, x, n, 1);
+}
+
+int sheConvertG2Vec(sheCipherTextGT *y, const shePublicKey *pub, const sheCipherTextG2 *x, mclSize n)
+{
+	return convertVecT(y, pub, x, n, 1);
+}
+
+int sheConvertG1VecMT(sheCipherTextGT *y, const shePublicKey *pub, const sheCipherTextG1 *x, mclSize n, mclSize cpuN)
+{
+	return convertVecT(y, pub, x, n, cpuN);
+}
+
+int sheConvertG2VecMT(sheCipherTextGT *y, const shePublicKey *pub, const sheCipherTextG2 *x, mclSize n, mclSize cpuN)
+{
+	return convertVecT(y, pub, x, n, cpuN);
+}
+
 shePrecomputedPublicKey *shePrecomputedPublicKeyCreate()
 	try
 {
@@ -800,6 +1064,146 @@ int shePrecomputedPublicKeyVerifyZkpBinEq(const shePrecomputedPublicKey *ppub, c
 	return verifyT(*cast(ppub), *cast(c1), *cast(c2), *cast(zkp));
 }
 
+/*
+	bool buffer for verifyVecMT
+	okVec[i] = ok[i] ? 1 : 0 if okVec is not null
+*/
+struct VerifyVecResult {
+	int *okVec;
+	mcl::Array<bool> ok;
+	explicit VerifyVecResult(int *okVec) : okVec(okVec) {}
+	bool *get(mclSize n)
+	{
+		if (okVec == 0 || n == 0) return 0;
+		if (!ok.resize(n)) throw cybozu::Exception("she:VerifyVecResult:resize") << n;
+		return ok.data();
+	}
+	int set(bool ret, mclSize n) const
+	{
+		if (okVec && n > 0) {
+			for (mclSize i = 0; i < n; i++) {
+				okVec[i] = ok[i] ? 1 : 0;
+			}
+		}
+		return ret ? 1 : 0;
+	}
+};
+
+template<class PK, class CT>
+int verifyVecT(const PK *pub, const CT *c, const ZkpBin *zkp, mclSize n, int *okVec, mclSize cpuN)
+	try
+{
+	VerifyVecResult r(okVec);
+	bool *ok = r.get(n);
+	return r.set(pub->verifyVecMT(c, zkp, n, ok, cpuN), n);
+} catch (std::exception&) {
+	return 0;
+}
+
+template<class PK, class Zkp>
+int verifyVecT(const PK *pub, const CipherTextG1 *c1, const CipherTextG2 *c2, const Zkp *zkp, mclSize n, int *okVec, mclSize cpuN)
+	try
+{
+	VerifyVecResult r(okVec);
+	bool *ok = r.get(n);
+	return r.set(pub->verifyVecMT(c1, c2, zkp, n, ok, cpuN), n);
+} catch (std::exception&) {
+	return 0;
+}
+
+template<class PK>
+int verifyVecT(const PK *pub, const CipherTextG1 *c, const Fr *zkp, const int *mVec, mclSize mSize, mclSize n, int *okVec, mclSize cpuN)
+	try
+{
+	VerifyVecResult r(okVec);
+	bool *ok = r.get(n);
+	return r.set(pub->verifyVecMT(c, zkp, mVec, mSize, n, ok, cpuN), n);
+} catch (std::exception&) {
+	return 0;
+}
+
+int sheVerifyZkpBinG1Vec(const shePublicKey *pub, const sheCipherTextG1 *c, const sheZkpBin *zkp, mclSize n, int *okVec)
+{
+	return verifyVecT(cast(pub), cast(c), cast(zkp), n, okVec, 1);
+}
+int sheVerifyZkpBinG2Vec(const shePublicKey *pub, const sheCipherTextG2 *c, const sheZkpBin *zkp, mclSize n, int *okVec)
+{
+	return verifyVecT(cast(pub), cast(c), cast(zkp), n, okVec, 1);
+}
+int sheVerifyZkpSetG1Vec(const shePublicKey *pub, const sheCipherTextG1 *c, const mclBnFr *zkp, const int *mVec, mclSize mSize, mclSize n, int *okVec)
+{
+	return verifyVecT(cast(pub), cast(c), cast2(zkp), mVec, mSize, n, okVec, 1);
+}
+int sheVerifyZkpEqVec(const shePublicKey *pub, const sheCipherTextG1 *c1, const sheCipherTextG2 *c2, const sheZkpEq *zkp, mclSize n, int *okVec)
+{
+	return verifyVecT(cast(pub), cast(c1), cast(c2), cast(zkp), n, okVec, 1);
+}
+int sheVerifyZkpBinEqVec(const shePublicKey *pub, const sheCipherTextG1 *c1, const sheCipherTextG2 *c2, const sheZkpBinEq *zkp, mclSize n, int *okVec)
+{
+	return verifyVecT(cast(pub), cast(c1), cast(c2), cast(zkp), n, okVec, 1);
+}
+int shePrecomputedPublicKeyVerifyZkpBinG1Vec(const shePrecomputedPublicKey *ppub, const sheCipherTextG1 *c, const sheZkpBin *zkp, mclSize n, int *okVec)
+{
+	return verifyVecT(cast(ppub), cast(c), cast(zkp), n, okVec, 1);
+}
+int shePrecomputedPublicKeyVerifyZkpBinG2Vec(const shePrecomputedPublicKey *ppub, const sheCipherTextG2 *c, const sheZkpBin *zkp, mclSize n, int *okVec)
+{
+	return verifyVecT(cast(ppub), cast(c), cast(zkp), n, okVec, 1);
+}
+int shePrecomputedPublicKeyVerifyZkpSetG1Vec(const shePrecomputedPublicKey *ppub, const sheCipherTextG1 *c, const mclBnFr *zkp, const int *mVec, mclSize mSize, mclSize n, int *okVec)
+{
+	return verifyVecT(cast(ppub), cast(c), cast2(zkp), mVec, mSize, n, okVec, 1);
+}
+int shePrecomputedPublicKeyVerifyZkpEqVec(const shePrecomputedPublicKey *ppub, const sheCipherTextG1 *c1, const sheCipherTextG2 *c2, const sheZkpEq *zkp, mclSize n, int *okVec)
+{
+	return verifyVecT(cast(ppub), cast(c1), cast(c2), cast(zkp), n, okVec, 1);
+}
+int shePrecomputedPublicKeyVerifyZkpBinEqVec(const shePrecomputedPublicKey *ppub, const sheCipherTextG1 *c1, const sheCipherTextG2 *c2, const sheZkpBinEq *zkp, mclSize n, int *okVec)
+{
+	return verifyVecT(cast(ppub), cast(c1), cast(c2), cast(zkp), n, okVec, 1);
+}
+
+int sheVerifyZkpBinG1VecMT(const shePublicKey *pub, const sheCipherTextG1 *c, const sheZkpBin *zkp, mclSize n, int *okVec, mclSize cpuN)
+{
+	return verifyVecT(cast(pub), cast(c), cast(zkp), n, okVec, cpuN);
+}
+int sheVerifyZkpBinG2VecMT(const shePublicKey *pub, const sheCipherTextG2 *c, const sheZkpBin *zkp, mclSize n, int *okVec, mclSize cpuN)
+{
+	return verifyVecT(cast(pub), cast(c), cast(zkp), n, okVec, cpuN);
+}
+int sheVerifyZkpSetG1VecMT(const shePublicKey *pub, const sheCipherTextG1 *c, const mclBnFr *zkp, const int *mVec, mclSize mSize, mclSize n, int *okVec, mclSize cpuN)
+{
+	return verifyVecT(cast(pub), cast(c), cast2(zkp), mVec, mSize, n, okVec, cpuN);
+}
+int sheVerifyZkpEqVecMT(const shePublicKey *pub, const sheCipherTextG1 *c1, const sheCipherTextG2 *c2, const sheZkpEq *zkp, mclSize n, int *okVec, mclSize cpuN)
+{
+	return verifyVecT(cast(pub), cast(c1), cast(c2), cast(zkp), n, okVec, cpuN);
+}
+int sheVerifyZkpBinEqVecMT(const shePublicKey *pub, const sheCipherTextG1 *c1, const sheCipherTextG2 *c2, const sheZkpBinEq *zkp, mclSize n, int *okVec, mclSize cpuN)
+{
+	return verifyVecT(cast(pub), cast(c1), cast(c2), cast(zkp), n, okVec, cpuN);
+}
+int shePrecomputedPublicKeyVerifyZkpBinG1VecMT(const shePrecomputedPublicKey *ppub, const sheCipherTextG1 *c, const sheZkpBin *zkp, mclSize n, int *okVec, mclSize cpuN)
+{
+	return verifyVecT(cast(ppub), cast(c), cast(zkp), n, okVec, cpuN);
+}
+int shePrecomputedPublicKeyVerifyZkpBinG2VecMT(const shePrecomputedPublicKey *ppub, const sheCipherTextG2 *c, const sheZkpBin *zkp, mclSize n, int *okVec, mclSize cpuN)
+{
+	return verifyVecT(cast(ppub), cast(c), cast(zkp), n, okVec, cpuN);
+}
+int shePrecomputedPublicKeyVerifyZkpSetG1VecMT(const shePrecomputedPublicKey *ppub, const sheCipherTextG1 *c, const mclBnFr *zkp, const int *mVec, mclSize mSize, mclSize n, int *okVec, mclSize cpuN)
+{
+	return verifyVecT(cast(ppub), cast(c), cast2(zkp), mVec, mSize, n, okVec, cpuN);
+}
+int shePrecomputedPublicKeyVerifyZkpEqVecMT(const shePrecomputedPublicKey *ppub, const sheCipherTextG1 *c1, const sheCipherTextG2 *c2, const sheZkpEq *zkp, mclSize n, int *okVec, mclSize cpuN)
+{
+	return verifyVecT(cast(ppub), cast(c1), cast(c2), cast(zkp), n, okVec, cpuN);
+}
+int shePrecomputedPublicKeyVerifyZkpBinEqVecMT(const shePrecomputedPublicKey *ppub, const sheCipherTextG1 *c1, const sheCipherTextG2 *c2, const sheZkpBinEq *zkp, mclSize n, int *okVec, mclSize cpuN)
+{
+	return verifyVecT(cast(ppub), cast(c1), cast(c2), cast(zkp), n, okVec, cpuN);
+}
+
 int sheDecWithZkpDecG1(mclInt *m, sheZkpDec *zkp, const sheSecretKey *sec, const sheCipherTextG1 *c, const shePublicKey *pub)
 {
 	bool b;
@@ -1,4 +1,4 @@
-#include <mcl/lagrange.hpp>
+#include <mcl/lagrange_cache.hpp>
 
 void benchAddDblG1()
 {
@@ -67,6 +67,13 @@ void invAdd(T& out, const T& x, const T& y)
 	out += y;
 }
 
+template<class T>
+void invCTAdd(T& out, const T& x, const T& y)
+{
+	T::invCT(out, x);
+	out += y;
+}
+
 template<class F>
 void invVecBench(const char *msg)
 {
@@ -163,6 +170,11 @@ void testBench(const G1& P, const G2& Q)
 	CYBOZU_BENCH_C("Fp::mul       ", C3, Fp::mul, x, x, y);
 	CYBOZU_BENCH_C("Fp::sqr       ", C3, Fp::sqr, x, x);
 	CYBOZU_BENCH_C("Fp::inv       ", C3, invAdd, x, x, y);
+	CYBOZU_BENCH_C("Fp::invCT     ", C3, invCTAdd, x, x, y);
+	{
+		const mpz_class e = Fp::getOp().mp - 2;
+		CYBOZU_BENCH_C("Fp::invFermat ", C3, Fp::pow, x, x, e);
+	}
 	CYBOZU_BENCH_C("Fp::pow       ", C3, Fp::pow, x, x, y);
 	sqrBench(x, "Fp");
 	invVecBench<Fp>("Fp:invVec");
@@ -181,6 +193,9 @@ void testBench(const G1& P, const G2& Q)
 		CYBOZU_BENCH_C("Fr::mul       ", C3, Fr::mul, a, a, b);
 		CYBOZU_BENCH_C("Fr::sqr       ", C3, Fr::sqr, a, a);
 		CYBOZU_BENCH_C("Fr::inv       ", C3, invAdd, a, a, b);
+		CYBOZU_BENCH_C("Fr::invCT     ", C3, invCTAdd, a, a, b);
+		const mpz_class e = Fr::getOp().mp - 2;
+		CYBOZU_BENCH_C("Fr::invFermat ", C3, Fr::pow, a, a, e);
 		CYBOZU_BENCH_C("Fr::pow       ", C3, Fr::pow, a, a, b);
 		sqrBench(a, "Fr");
 	}
@@ -302,6 +317,108 @@ void testLagrange()
 			}
 		}
 	}
+	{
+		// the product tree is used if k >= 300 for BLS12-381
+		const size_t k = 300;
+		std::vector<Fr> c(k), x(k), y(k), coeff(k);
+		std::vector<G1> P(k);
+		cybozu::XorShift rg;
+		for (size_t i = 0; i < k; i++) {
+			c[i].setByCSPRNG(rg);
+			x[i] = int(i + 1);
+		}
+		G1 P0;
+		hashAndMapToG1(P0, "abc", 3);
+		for (size_t i = 0; i < k; i++) {
+			mcl::evaluatePolynomial(y[i], &c[0], k, x[i]);
+			G1::mul(P[i], P0, y[i]);
+		}
+		bool b;
+		mcl::LagrangeCoeff(&b, &coeff[0], &x[0], k);
+		CYBOZU_TEST_ASSERT(b);
+		Fr a = 1;
+		for (size_t i = 0; i < k; i++) a *= x[i];
+		for (size_t i = 0; i < k; i++) {
+			Fr d = x[i];
+			for (size_t j = 0; j < k; j++) {
+				if (j != i) d *= x[j] - x[i];
+			}
+			CYBOZU_TEST_EQUAL(coeff[i] * d, a);
+		}
+		Fr s;
+		mcl::LagrangeInterpolation(&b, s, &x[0], &y[0], k);
+		CYBOZU_TEST_ASSERT(b);
+		CYBOZU_TEST_EQUAL(s, c[0]);
+		G1 Q;
+		mcl::LagrangeInterpolation(&b, Q, &x[0], &P[0], k);
+		CYBOZU_TEST_ASSERT(b);
+		CYBOZU_TEST_EQUAL(Q, P0 * c[0]);
+		mcl::LagrangeCoeffCache<Fr> cache;
+		for (int i = 0; i < 2; i++) {
+			Q.clear();
+			mcl::LagrangeInterpolation(&b, Q, cache, &x[0], &P[0], k);
+			CYBOZU_TEST_ASSERT(b);
+			CYBOZU_TEST_EQUAL(Q, P0 * c[0]);
+			CYBOZU_TEST_EQUAL(cache.size(), 1u);
+		}
+		{
+			// the coefficients are copied, so they remain valid after the entries are removed
+			mcl::LagrangeCoeffCache<Fr> cache1(1);
+			std::vector<Fr> c1(k), c2(k), x2(x);
+			x2[0] = int(k + 1);
+			CYBOZU_TEST_ASSERT(cache1.get(&c1[0], &x[0], k));
+			CYBOZU_TEST_ASSERT(cache1.get(&c2[0], &x2[0], k));
+			CYBOZU_TEST_EQUAL(cache1.size(), 1u);
+			CYBOZU_TEST_ASSERT(c1 == coeff);
+			CYBOZU_TEST_ASSERT(c2 != coeff);
+		}
+		x[1] = x[0];
+		mcl::LagrangeInterpolation(&b, Q, &x[0], &P[0], k);
+		CYBOZU_TEST_ASSERT(!b);
+		mcl::LagrangeInterpolation(&b, Q, cache, &x[0], &P[0], k);
+		CYBOZU_TEST_ASSERT(!b);
+		x[1] = 2;
+#ifdef NDEBUG
+		CYBOZU_BENCH_C("LagrangeCoeff k=300", 10, mcl::LagrangeCoeff, &b, &coeff[0], &x[0], k);
+#endif
+	}
+	{
+		// evaluatePolynomialVec with mulVec (n < 256) and the tables of the coefficients (n >= 256)
+		const size_t t = 5;
+		const size_t nTbl[] = { 1, 10, 256 };
+		G1 c[t];
+		Fr cFr[t];
+		for (size_t i = 0; i < t; i++) {
+			cFr[i].setByCSPRNG();
+			hashAndMapToG1(c[i], &i, sizeof(i));
+		}
+		for (size_t k = 0; k < CYBOZU_NUM_OF_ARRAY(nTbl); k++) {
+			const size_t n = nTbl[k];
+			std::vector<Fr> x(n), yFr(n);
+			std::vector<G1> y(n);
+			for (size_t j = 0; j < n; j++) {
+				x[j].setByCSPRNG();
+			}
+			x[0] = 0;
+			bool b;
+			mcl::evaluatePolynomialVec(&b, &y[0], c, t, &x[0], n);
+			CYBOZU_TEST_ASSERT(b);
+			mcl::evaluatePolynomialVecMT(&b, &yFr[0], cFr, t, &x[0], n);
+			CYBOZU_TEST_ASSERT(b);
+			for (size_t j = 0; j < n; j++) {
+				G1 z;
+				mcl::evaluatePolynomial(z, c, t, x[j]);
+				CYBOZU_TEST_EQUAL(y[j], z);
+				Fr zFr;
+				mcl::evaluatePolynomial(zFr, cFr, t, x[j]);
+				CYBOZU_TEST_EQUAL(yFr[j], zFr);
+			}
+			std::vector<G1> y2(n);
+			mcl::evaluatePolynomialVecMT(&b, &y2[0], c, t, &x[0], n);
+			CYBOZU_TEST_ASSERT(b);
+			CYBOZU_TEST_ASSERT(y == y2);
+		}
+	}
 	{
 		const int n = 50;
 		cybozu::XorShift rg;
@@ -509,9 +509,32 @@ const char *eStr =
 	CYBOZU_TEST_EQUAL(e1, e2);
 }
 
+void testFp6mul()
+{
+	Fp6 x, y, z1, z2;
+	for (int i = 0; i < 100; i++) {
+		for (int j = 0; j < 6; j++) {
+			x.getFp0()[j].setByCSPRNG();
+			y.getFp0()[j].setByCSPRNG();
+		}
+		if (i == 1) Fp::neg(x.getFp0()[0], 1);
+		Fp6Dbl d;
+		Fp6Dbl::mulPreT<true>(d, x, y);
+		Fp6Dbl::mod(z2, d);
+		Fp6Dbl::mulPre(d, x, y);
+		Fp6Dbl::mod(z1, d);
+		CYBOZU_TEST_EQUAL(z1, z2);
+		Fp6::mul(z1, x, y);
+		CYBOZU_TEST_EQUAL(z1, z2);
+		Fp6::mul(x, x, y);
+		CYBOZU_TEST_EQUAL(x, z2);
+	}
+}
+
 void testCurve(const mcl::CurveParam& cp)
 {
 	initPairing(cp);
+	testFp6mul();
 	G1 P;
 	G2 Q;
 	mapToG1(P, 1);
@@ -541,7 +564,7 @@ CYBOZU_TEST_AUTO(multi)
 	G2 Q;
 	int i;
 
-#ifndef MCL_STATIC_CODE
+#if !defined(MCL_STATIC_CODE) && !defined(MCL_FIXED_CURVE)
 	puts("BN254");
 	testCurve(mcl::BN254);
 	i = 1;
@@ -588,6 +611,146 @@ CYBOZU_TEST_AUTO(deserialize)
 	}
 }
 
+CYBOZU_TEST_AUTO(squareRootVec)
+{
+	const size_t n = 70;
+	Fp2 x[n], y[n];
+	bool isSquare[n];
+	for (int i = 0; i < int(n); i++) {
+		Fp2& t = x[i];
+		t.a.setHashOf(&i, sizeof(i));
+		t.b = i;
+		if (i % 2) Fp2::sqr(t, t);
+	}
+	x[3].b = 0;
+	x[5] = 0;
+	Fp2::squareRootVec(y, x, n, isSquare);
+	for (size_t i = 0; i < n; i++) {
+		Fp2 t;
+		bool b = Fp2::squareRoot(t, x[i]);
+		CYBOZU_TEST_EQUAL(isSquare[i], b);
+		if (b) {
+			Fp2::sqr(t, y[i]);
+			CYBOZU_TEST_EQUAL(t, x[i]);
+		}
+	}
+}
+
+void hashAndMapTo(G1& P, const void *buf, size_t bufSize) { hashAndMapToG1(P, buf, bufSize); }
+void hashAndMapTo(G2& Q, const void *buf, size_t bufSize) { hashAndMapToG2(Q, buf, bufSize); }
+
+template<class G>
+void deserializeLoop(G *P, size_t n, const char *buf, size_t n1)
+{
+	for (size_t i = 0; i < n; i++) P[i].deserialize(buf + i * n1, n1);
+}
+
+template<class G>
+void deserializeVecTest(const char *name)
+{
+	const size_t n = 70;
+	std::vector<G> P(n), Q(n);
+	const size_t n1 = G::getSerializedByteSize();
+	std::vector<char> buf(n * n1);
+	for (size_t i = 0; i < n; i++) {
+		if (i == 3) {
+			P[i].clear();
+		} else {
+			hashAndMapTo(P[i], &i, sizeof(i));
+		}
+		CYBOZU_TEST_EQUAL(P[i].serialize(&buf[i * n1], n1), n1);
+	}
+	CYBOZU_TEST_EQUAL(G::deserializeVec(&Q[0], n, &buf[0], buf.size()), buf.size());
+	CYBOZU_TEST_ASSERT(P == Q);
+	CYBOZU_TEST_EQUAL(G::deserializeVec(&Q[0], n, &buf[0], buf.size() - 1), 0u);
+	buf[5 * n1 + n1 / 2] ^= 1;
+	CYBOZU_TEST_EQUAL(G::deserializeVec(&Q[0], n, &buf[0], buf.size()), 0u);
+	buf[5 * n1 + n1 / 2] ^= 1;
+#ifdef NDEBUG
+	std::string s1 = std::string(name) + "::deserialize";
+	std::string s2 = std::string(name) + "::deserializeVec";
+	CYBOZU_BENCH_C(s1.c_str(), 10, deserializeLoop<G>, &Q[0], n, &buf[0], n1);
+	CYBOZU_BENCH_C(s2.c_str(), 10, G::deserializeVec, &Q[0], n, &buf[0], buf.size());
+#else
+	(void)name;
+#endif
+}
+
+CYBOZU_TEST_AUTO(deserializeVec)
+{
+	if (getCurveType() != MCL_BLS12_381) return;
+	for (int i = 0; i < 2; i++) {
+		Fp::setETHserialization(i == 1);
+		deserializeVecTest<G1>("G1");
+		deserializeVecTest<G2>("G2");
+	}
+	Fp::setETHserialization(false);
+}
+
+template<class G>
+void rawVecTest(const char *name)
+{
+	const size_t n = 3000;
+	std::vector<G> P(n), Q(n);
+	for (size_t i = 0; i < n; i++) {
+		if (i == 3) {
+			P[i].clear();
+		} else {
+			hashAndMapTo(P[i], &i, sizeof(i));
+			if (i & 1) P[i] += P[i]; // not normalized
+		}
+	}
+	std::vector<uint8_t> buf(G::getRawVecByteSize(n));
+	CYBOZU_TEST_EQUAL(G::serializeRawVec(&buf[0], buf.size() - 1, &P[0], n), 0u);
+	CYBOZU_TEST_EQUAL(G::serializeRawVec(&buf[0], buf.size(), &P[0], n), buf.size());
+	CYBOZU_TEST_EQUAL(G::getRawVecN(&buf[0], buf.size()), n);
+	CYBOZU_TEST_EQUAL(G::getRawVecN(&buf[0], buf.size() - 1), 0u);
+	CYBOZU_TEST_EQUAL(G::deserializeRawVec(&Q[0], n, &buf[0], buf.size()), buf.size());
+	CYBOZU_TEST_ASSERT(P == Q);
+	for (size_t i = 0; i < n; i++) Q[i].clear();
+	CYBOZU_TEST_EQUAL(G::deserializeRawVecMT(&Q[0], n, &buf[0], buf.size(), true), buf.size());
+	CYBOZU_TEST_ASSERT(P == Q);
+	CYBOZU_TEST_EQUAL(G::deserializeRawVec(&Q[0], n - 1, &buf[0], buf.size()), 0u);
+	// checksum error
+	const size_t pos = G::rawVecHeaderSize + 5 * sizeof(Fp) + 7;
+	buf[pos] ^= 1;
+	CYBOZU_TEST_EQUAL(G::deserializeRawVec(&Q[0], n, &buf[0], buf.size()), 0u);
+	buf[pos] ^= 1;
+	// wrong parameters
+	buf[40] ^= 1;
+	CYBOZU_TEST_EQUAL(G::getRawVecN(&buf[0], buf.size()), 0u);
+	buf[40] ^= 1;
+	// a point not on the curve with the valid checksum
+	G R = P[5];
+	R.normalize();
+	R.y += 1;
+	G::serializeRawVec(&buf[0], buf.size(), &R, 1);
+	CYBOZU_TEST_EQUAL(G::deserializeRawVec(&Q[0], 1, &buf[0], buf.size()), G::getRawVecByteSize(1));
+	CYBOZU_TEST_EQUAL(G::deserializeRawVec(&Q[0], 1, &buf[0], buf.size(), true), 0u);
+#ifdef NDEBUG
+	G::serializeRawVec(&buf[0], buf.size(), &P[0], n);
+	std::vector<char> buf3(n * G::getSerializedByteSize());
+	for (size_t i = 0; i < n; i++) P[i].serialize(&buf3[i * G::getSerializedByteSize()], G::getSerializedByteSize());
+	std::string s1 = std::string(name) + "::deserializeVec   ";
+	std::string s2 = std::string(name) + "::deserializeRawVec";
+	CYBOZU_BENCH_C(s1.c_str(), 3, G::deserializeVec, &Q[0], n, &buf3[0], buf3.size());
+	CYBOZU_BENCH_C(s2.c_str(), 3, G::deserializeRawVec, &Q[0], n, &buf[0], buf.size(), false);
+#else
+	(void)name;
+#endif
+}
+
+CYBOZU_TEST_AUTO(rawVec)
+{
+	rawVecTest<G1>("G1");
+	rawVecTest<G2>("G2");
+	// the header of G1 is not valid for G2
+	uint8_t header[G1::rawVecHeaderSize];
+	CYBOZU_TEST_EQUAL(G1::serializeRawVec(header, sizeof(header), 0, 0), sizeof(header));
+	CYBOZU_TEST_EQUAL(G1::deserializeRawVec(0, 0, header, sizeof(header)), sizeof(header));
+	CYBOZU_TEST_EQUAL(G2::deserializeRawVec(0, 0, header, sizeof(header)), 0u);
+}
+
 CYBOZU_TEST_AUTO(verifyG1)
 {
 	const char *ok_x = "ad50e39253e0de4fad89440f01f1874c8bc91fdcd59ad66162984b10690e51ccf4d95e4222df14549d745d8b971199";
@@ -743,8 +906,10 @@ void f(FpVec& zv, const FpVec& xv, const FpVec& yv)
 int main(int argc, char *argv[])
 	try
 {
-#ifdef MCL_STATIC_CODE
+#if defined(MCL_STATIC_CODE)
 	printf("static code for BLS12-381\n");
+#elif defined(MCL_FIXED_CURVE)
+	printf("fixed modulus for curveType=%d\n", MCL_FIXED_CURVE);
 #else
 	printf("JIT %d\n", mcl::fp::isEnableJIT());
 #endif
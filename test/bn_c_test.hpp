@@ -468,6 +468,59 @@ void Fr_invVecTest()
 	CYBOZU_TEST_EQUAL(doneN, n-c);
 }
 
+void Fr_opVecTest()
+{
+	const size_t maxN = 37;
+	mclBnFr x[maxN], y[maxN], w[maxN], z[maxN], t;
+	for (size_t i = 0; i < maxN; i++) {
+		mclBnFr_setByCSPRNG(&x[i]);
+		mclBnFr_setByCSPRNG(&y[i]);
+		mclBnFr_setByCSPRNG(&w[i]);
+	}
+	mclBnFr_setInt(&x[0], 0);
+	mclBnFr_setInt(&x[1], -1);
+	mclBnFr_setInt(&y[1], -1);
+	const size_t nTbl[] = { 0, 1, 7, 8, 9, 16, maxN };
+	for (size_t k = 0; k < CYBOZU_NUM_OF_ARRAY(nTbl); k++) {
+		const size_t n = nTbl[k];
+		mclBnFr_addVec(z, x, y, n);
+		for (size_t i = 0; i < n; i++) {
+			mclBnFr_add(&t, &x[i], &y[i]);
+			CYBOZU_TEST_ASSERT(mclBnFr_isEqual(&z[i], &t));
+		}
+		mclBnFr_subVec(z, x, y, n);
+		for (size_t i = 0; i < n; i++) {
+			mclBnFr_sub(&t, &x[i], &y[i]);
+			CYBOZU_TEST_ASSERT(mclBnFr_isEqual(&z[i], &t));
+		}
+		mclBnFr_mulVec(z, x, y, n);
+		for (size_t i = 0; i < n; i++) {
+			mclBnFr_mul(&t, &x[i], &y[i]);
+			CYBOZU_TEST_ASSERT(mclBnFr_isEqual(&z[i], &t));
+		}
+		mclBnFr_mulScalarVec(z, x, &y[1], n);
+		for (size_t i = 0; i < n; i++) {
+			mclBnFr_mul(&t, &x[i], &y[1]);
+			CYBOZU_TEST_ASSERT(mclBnFr_isEqual(&z[i], &t));
+		}
+		mclBnFr_fmaVec(z, x, y, w, n);
+		for (size_t i = 0; i < n; i++) {
+			mclBnFr_mul(&t, &x[i], &y[i]);
+			mclBnFr_add(&t, &t, &w[i]);
+			CYBOZU_TEST_ASSERT(mclBnFr_isEqual(&z[i], &t));
+		}
+	}
+	// same addr
+	for (size_t i = 0; i < maxN; i++) {
+		mclBnFr_mul(&t, &x[i], &y[i]);
+		mclBnFr_add(&w[i], &t, &x[i]);
+	}
+	mclBnFr_fmaVec(x, x, y, x, maxN);
+	for (size_t i = 0; i < maxN; i++) {
+		CYBOZU_TEST_ASSERT(mclBnFr_isEqual(&x[i], &w[i]));
+	}
+}
+
 void Fr_isNegativeTest()
 {
 	mclBnFr a, half, one;
@@ -1280,6 +1333,7 @@ void testAll(int curveType)
 	GT_invTest();
 	Fp_invVecTest();
 	Fr_invVecTest();
+	Fr_opVecTest();
 	Fr_isNegativeTest();
 	Fp_isNegativeTest();
 	Fr_isOddTest();
@@ -1343,6 +1397,20 @@ void G1onlyTest(int curve)
 	size_t n = mclBnG1_getStr(buf, sizeof(buf), &P0, 16);
 	CYBOZU_TEST_ASSERT(n > 0);
 	printf("basePoint=%s\n", buf);
+	{
+		mclBnFr y;
+		mclBnG1 Q, R;
+		for (int i = 0; i < 10; i++) {
+			if (i < 3) {
+				mclBnFr_setInt(&y, i - 1);
+			} else {
+				mclBnFr_setByCSPRNG(&y);
+			}
+			mclBnG1_mulCT(&Q, &P0, &y);
+			mclBnG1_mul(&R, &P0, &y);
+			CYBOZU_TEST_ASSERT(mclBnG1_isEqual(&Q, &R));
+		}
+	}
 	G1Test();
 }
 
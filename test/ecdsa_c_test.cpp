@@ -55,3 +55,42 @@ CYBOZU_TEST_AUTO(ecdsa)
 
 	ecdsaPrecomputedPublicKeyDestroy(ppub);
 }
+
+CYBOZU_TEST_AUTO(verifyBatchAndRecover)
+{
+	const size_t n = 5;
+	ecdsaSecretKey sec;
+	ecdsaPublicKey pubVec[n];
+	ecdsaSignature sigVec[n];
+	uint8_t recIdVec[n];
+	const char *msgTbl[n] = { "a", "bc", "def", "ghij", "klmno" };
+	const void *msgVec[n];
+	mclSize msgSizeVec[n];
+	int okVec[n];
+	for (size_t i = 0; i < n; i++) {
+		CYBOZU_TEST_EQUAL(ecdsaSecretKeySetByCSPRNG(&sec), 0);
+		ecdsaGetPublicKey(&pubVec[i], &sec);
+		msgVec[i] = msgTbl[i];
+		msgSizeVec[i] = strlen(msgTbl[i]);
+		ecdsaSignWithRecId(&sigVec[i], &recIdVec[i], &sec, msgVec[i], msgSizeVec[i]);
+	}
+	CYBOZU_TEST_EQUAL(ecdsaVerifyBatch(sigVec, recIdVec, pubVec, msgVec, msgSizeVec, n, okVec), 1);
+	for (size_t i = 0; i < n; i++) {
+		CYBOZU_TEST_EQUAL(okVec[i], 1);
+	}
+	ecdsaPublicKey pubVec2[n];
+	CYBOZU_TEST_EQUAL(ecdsaRecoverPublicKeyVec(pubVec2, sigVec, recIdVec, msgVec, msgSizeVec, n, okVec), 0);
+	for (size_t i = 0; i < n; i++) {
+		CYBOZU_TEST_EQUAL(okVec[i], 1);
+		CYBOZU_TEST_EQUAL_ARRAY(pubVec2[i].d, pubVec[i].d, 12);
+		ecdsaPublicKey pub;
+		CYBOZU_TEST_EQUAL(ecdsaRecoverPublicKey(&pub, &sigVec[i], recIdVec[i], msgVec[i], msgSizeVec[i]), 0);
+		CYBOZU_TEST_EQUAL_ARRAY(pub.d, pubVec[i].d, 12);
+	}
+	msgSizeVec[2]--;
+	CYBOZU_TEST_EQUAL(ecdsaVerifyBatch(sigVec, recIdVec, pubVec, msgVec, msgSizeVec, n, 0), 0);
+	CYBOZU_TEST_EQUAL(ecdsaVerifyBatch(sigVec, recIdVec, pubVec, msgVec, msgSizeVec, n, okVec), 0);
+	for (size_t i = 0; i < n; i++) {
+		CYBOZU_TEST_EQUAL(okVec[i], i != 2);
+	}
+}
@@ -10,8 +10,15 @@ void put(const void *buf, size_t bufSize)
 	printf("\n");
 }
 #include <mcl/ecdsa.hpp>
+#include <mcl/ecdsa_pool.hpp>
 #include <cybozu/test.hpp>
 #include <cybozu/benchmark.hpp>
+#include <cybozu/itoa.hpp>
+#include <vector>
+#if CYBOZU_CPP_VERSION >= CYBOZU_CPP_VERSION_CPP11
+#include <thread>
+#include <algorithm>
+#endif
 
 using namespace mcl::ecdsa;
 
@@ -28,8 +35,286 @@ CYBOZU_TEST_AUTO(ecdsa)
 	CYBOZU_TEST_ASSERT(verify(sig, pub, msg.c_str(), msg.size()));
 	sig.s += 1;
 	CYBOZU_TEST_ASSERT(!verify(sig, pub, msg.c_str(), msg.size()));
+	// constant-time table
+	const Zn tbl[] = { 0, 1, 2, 15, 16, 17, -1, -2, -16 };
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(tbl) + 10; i++) {
+		if (i < CYBOZU_NUM_OF_ARRAY(tbl)) {
+			sec = tbl[i];
+		} else {
+			sec.setByCSPRNG();
+		}
+		getPublicKey(pub, sec);
+		Ec Q;
+		Ec::mul(Q, param.P, sec);
+		CYBOZU_TEST_EQUAL(pub, Q);
+	}
+}
+
+CYBOZU_TEST_AUTO(mul2)
+{
+	SecretKey sec;
+	PublicKey pub;
+	PrecomputedPublicKey ppub;
+	sec.setByCSPRNG();
+	getPublicKey(pub, sec);
+	ppub.init(pub);
+	const Zn tbl[] = { 0, 1, 2, -1, -2 };
+	for (size_t i = 0; i < 40; i++) {
+		Zn u1, u2;
+		if (i < 25) {
+			u1 = tbl[i % 5];
+			u2 = tbl[i / 5];
+		} else {
+			u1.setByCSPRNG();
+			u2.setByCSPRNG();
+		}
+		Ec Q1, Q2, T;
+		Ec::mul(Q1, param.P, u1);
+		Ec::mul(T, pub, u2);
+		Q1 += T;
+		local::mul2(Q2, u1, pub, u2);
+		CYBOZU_TEST_EQUAL(Q1, Q2);
+		local::mul2(Q2, u1, ppub, u2);
+		CYBOZU_TEST_EQUAL(Q1, Q2);
+	}
+}
+
+CYBOZU_TEST_AUTO(isEqualX)
+{
+	const mpz_class& n = Zn::getOp().mp;
+	Fp x, y;
+	// find a point whose x-coordinate is larger than n
+	x.setMpz(n);
+	for (;;) {
+		if (Ec::getYfromX(y, x, false)) break;
+		x += 1;
+	}
+	Ec Q(x, y);
+	Zn r;
+	local::FpToZn(r, x);
+	// (X, Y, Z) = (x z^2, y z^3, z)
+	Fp z = 123, z2;
+	Fp::sqr(z2, z);
+	Q.x *= z2;
+	Q.y *= z2 * z;
+	Q.z = z;
+	CYBOZU_TEST_ASSERT(local::isEqualX(Q, r));
+	CYBOZU_TEST_ASSERT(!local::isEqualX(Q, r + 1));
+	Q.normalize();
+	CYBOZU_TEST_ASSERT(local::isEqualX(Q, r));
+	CYBOZU_TEST_ASSERT(!local::isEqualX(Q, r - 1));
+}
+
+CYBOZU_TEST_AUTO(verifyVec)
+{
+	const size_t N = 70;
+	SecretKey sec;
+	PublicKey pubVec[N];
+	Signature sigVec[N];
+	uint8_t recIdVec[N];
+	std::string msgTbl[N];
+	const void *msgVec[N];
+	size_t msgSizeVec[N];
+	bool okVec[N];
+	for (size_t i = 0; i < N; i++) {
+		sec.setByCSPRNG();
+		getPublicKey(pubVec[i], sec);
+		msgTbl[i] = cybozu::itoa(i);
+		msgVec[i] = msgTbl[i].c_str();
+		msgSizeVec[i] = msgTbl[i].size();
+		sign(sigVec[i], sec, msgVec[i], msgSizeVec[i], &recIdVec[i]);
+		CYBOZU_TEST_ASSERT(recIdVec[i] < 2);
+	}
+	const size_t nTbl[] = { 0, 1, 2, 5, 64, N };
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(nTbl); i++) {
+		const size_t n = nTbl[i];
+		CYBOZU_TEST_ASSERT(verifyVec(sigVec, recIdVec, pubVec, msgVec, msgSizeVec, n));
+		CYBOZU_TEST_ASSERT(verifyVec(sigVec, recIdVec, pubVec, msgVec, msgSizeVec, n, okVec));
+		for (size_t j = 0; j < n; j++) {
+			CYBOZU_TEST_ASSERT(okVec[j]);
+		}
+	}
+	// a wrong recId falls back to verify
+	recIdVec[1] ^= 1;
+	CYBOZU_TEST_ASSERT(verifyVec(sigVec, recIdVec, pubVec, msgVec, msgSizeVec, N));
+	CYBOZU_TEST_ASSERT(verifyVec(sigVec, recIdVec, pubVec, msgVec, msgSizeVec, N, okVec));
+	recIdVec[2] ^= 2;
+	CYBOZU_TEST_ASSERT(verifyVec(sigVec, recIdVec, pubVec, msgVec, msgSizeVec, N));
+	CYBOZU_TEST_ASSERT(verifyVec(sigVec, recIdVec, pubVec, msgVec, msgSizeVec, N, okVec));
+	for (size_t i = 0; i < N; i++) {
+		CYBOZU_TEST_ASSERT(okVec[i]);
+	}
+	// a wrong recId with an invalid signature
+	sigVec[1].s += 1;
+	CYBOZU_TEST_ASSERT(!verifyVec(sigVec, recIdVec, pubVec, msgVec, msgSizeVec, N));
+	CYBOZU_TEST_ASSERT(!verifyVec(sigVec, recIdVec, pubVec, msgVec, msgSizeVec, N, okVec));
+	CYBOZU_TEST_ASSERT(!okVec[1]);
+	sigVec[1].s -= 1;
+	// invalid signatures
+	sigVec[3].s += 1;
+	msgSizeVec[40] = 0;
+	pubVec[69] = pubVec[68];
+	sigVec[50].s = -sigVec[50].s;
+	CYBOZU_TEST_ASSERT(!verifyVec(sigVec, recIdVec, pubVec, msgVec, msgSizeVec, N));
+	CYBOZU_TEST_ASSERT(!verifyVec(sigVec, recIdVec, pubVec, msgVec, msgSizeVec, N, okVec));
+	for (size_t i = 0; i < N; i++) {
+		CYBOZU_TEST_EQUAL(okVec[i], i != 3 && i != 40 && i != 50 && i != 69);
+	}
+}
+
+CYBOZU_TEST_AUTO(recoverPublicKey)
+{
+	const size_t N = 70;
+	SecretKey sec;
+	PublicKey pubVec[N], pubVec2[N];
+	Signature sigVec[N];
+	uint8_t recIdVec[N];
+	const std::string msg = "hello";
+	const void *msgVec[N];
+	size_t msgSizeVec[N];
+	bool okVec[N];
+	for (size_t i = 0; i < N; i++) {
+		sec.setByCSPRNG();
+		getPublicKey(pubVec[i], sec);
+		msgVec[i] = msg.c_str();
+		msgSizeVec[i] = msg.size();
+		sign(sigVec[i], sec, msg.c_str(), msg.size(), &recIdVec[i]);
+		PublicKey pub;
+		CYBOZU_TEST_ASSERT(recoverPublicKey(pub, sigVec[i], recIdVec[i], msg.c_str(), msg.size()));
+		CYBOZU_TEST_EQUAL(pub, pubVec[i]);
+		// the other parity gives another key
+		CYBOZU_TEST_ASSERT(recoverPublicKey(pub, sigVec[i], recIdVec[i] ^ 1, msg.c_str(), msg.size()));
+		CYBOZU_TEST_ASSERT(pub != pubVec[i]);
+	}
+	CYBOZU_TEST_ASSERT(recoverPublicKeyVec(pubVec2, sigVec, recIdVec, msgVec, msgSizeVec, N, okVec));
+	for (size_t i = 0; i < N; i++) {
+		CYBOZU_TEST_ASSERT(okVec[i]);
+		CYBOZU_TEST_EQUAL(pubVec2[i], pubVec[i]);
+		CYBOZU_TEST_ASSERT(pubVec2[i].isNormalized());
+	}
+	sigVec[5].r = 0;
+	recIdVec[6] = 4;
+	recIdVec[7] |= 2;
+	CYBOZU_TEST_ASSERT(!recoverPublicKeyVec(pubVec2, sigVec, recIdVec, msgVec, msgSizeVec, N, okVec));
+	for (size_t i = 0; i < N; i++) {
+		PublicKey pub;
+		bool ok = recoverPublicKey(pub, sigVec[i], recIdVec[i], msg.c_str(), msg.size());
+		CYBOZU_TEST_EQUAL(okVec[i], ok);
+		CYBOZU_TEST_EQUAL(ok, i < 5 || i > 7);
+		if (ok) {
+			CYBOZU_TEST_EQUAL(pubVec2[i], pubVec[i]);
+		} else {
+			CYBOZU_TEST_ASSERT(pubVec2[i].isZero());
+		}
+	}
 }
 
+CYBOZU_TEST_AUTO(noncePool)
+{
+	SecretKey sec;
+	PublicKey pub;
+	sec.setByCSPRNG();
+	getPublicKey(pub, sec);
+	NoncePool pool;
+	CYBOZU_TEST_ASSERT(pool.init(100));
+	CYBOZU_TEST_EQUAL(pool.size(), 0);
+	CYBOZU_TEST_EQUAL(pool.fill(70), 70);
+	CYBOZU_TEST_EQUAL(pool.size(), 70);
+	CYBOZU_TEST_EQUAL(pool.fill(), 30);
+	CYBOZU_TEST_EQUAL(pool.fill(), 0);
+	const std::string msg = "hello";
+	Zn prevR = 0;
+	// the last 10 signatures are made by ecdsa::sign
+	for (size_t i = 0; i < 160; i++) {
+		if (i == 50) {
+			// wrap around the ring buffer
+			CYBOZU_TEST_EQUAL(pool.fill(), 50);
+			CYBOZU_TEST_EQUAL(pool.size(), 100);
+		}
+		Signature sig;
+		uint8_t recId;
+		pool.sign(sig, sec, msg.c_str(), msg.size(), &recId);
+		CYBOZU_TEST_ASSERT(sig.r != prevR);
+		prevR = sig.r;
+		CYBOZU_TEST_ASSERT(verify(sig, pub, msg.c_str(), msg.size()));
+		PublicKey pub2;
+		CYBOZU_TEST_ASSERT(recoverPublicKey(pub2, sig, recId, msg.c_str(), msg.size()));
+		CYBOZU_TEST_EQUAL(pub, pub2);
+	}
+	CYBOZU_TEST_EQUAL(pool.size(), 0);
+}
+
+#if CYBOZU_CPP_VERSION >= CYBOZU_CPP_VERSION_CPP11
+struct PoolConsumer {
+	NoncePool *pool;
+	size_t n;
+	std::vector<Zn> kInvVec, rVec;
+	std::vector<uint8_t> recIdVec;
+	void operator()()
+	{
+		while (rVec.size() < n) {
+			Zn kInv, r;
+			uint8_t recId;
+			if (!pool->pop(kInv, r, recId)) {
+				std::this_thread::yield();
+				continue;
+			}
+			kInvVec.push_back(kInv);
+			rVec.push_back(r);
+			recIdVec.push_back(recId);
+		}
+	}
+};
+
+CYBOZU_TEST_AUTO(noncePoolThread)
+{
+	const size_t consumerN = 3;
+	const size_t n = 300; // per consumer
+	const size_t total = consumerN * n;
+	NoncePool pool;
+	CYBOZU_TEST_ASSERT(pool.init(50));
+	PoolConsumer c[consumerN];
+	std::thread th[consumerN];
+	for (size_t i = 0; i < consumerN; i++) {
+		c[i].pool = &pool;
+		c[i].n = n;
+		th[i] = std::thread(std::ref(c[i]));
+	}
+	// the producer refills the pool while the consumers pop from it
+	size_t made = 0;
+	while (made < total) {
+		size_t m = pool.fill(mcl::fp::min_<size_t>(17, total - made));
+		if (m == 0) std::this_thread::yield();
+		made += m;
+	}
+	for (size_t i = 0; i < consumerN; i++) {
+		th[i].join();
+	}
+	CYBOZU_TEST_EQUAL(pool.size(), 0);
+	// each nonce is consumed exactly once and is consistent
+	std::vector<std::string> rStrVec;
+	for (size_t i = 0; i < consumerN; i++) {
+		CYBOZU_TEST_EQUAL(c[i].rVec.size(), n);
+		for (size_t j = 0; j < n; j++) {
+			const Zn& r = c[i].rVec[j];
+			CYBOZU_TEST_ASSERT(!r.isZero());
+			Zn k;
+			Zn::inv(k, c[i].kInvVec[j]);
+			Ec Q;
+			Ec::mul(Q, param.P, k);
+			Q.normalize();
+			Zn x;
+			mcl::ecdsa::local::FpToZn(x, Q.x);
+			CYBOZU_TEST_EQUAL(x, r);
+			CYBOZU_TEST_EQUAL(c[i].recIdVec[j], mcl::ecdsa::local::getRecId(Q, r, false));
+			rStrVec.push_back(r.getStr(16));
+		}
+	}
+	std::sort(rStrVec.begin(), rStrVec.end());
+	CYBOZU_TEST_ASSERT(std::unique(rStrVec.begin(), rStrVec.end()) == rStrVec.end());
+}
+#endif
+
 CYBOZU_TEST_AUTO(mul)
 {
 	mcl::ecdsa::Fp x = -3, y;
@@ -326,8 +611,34 @@ CYBOZU_TEST_AUTO(bench)
 	getPublicKey(pub, sec);
 	ppub.init(pub);
 	Signature sig;
+	CYBOZU_BENCH_C("getPublicKey", 1000, getPublicKey, pub, sec);
 	CYBOZU_BENCH_C("sign", 1000, sign, sig, sec, msg.c_str(), msg.size());
 	CYBOZU_BENCH_C("pub.verify ", 1000, verify, sig, pub, msg.c_str(), msg.size());
 	CYBOZU_BENCH_C("ppub.verify", 1000, verify, sig, ppub, msg.c_str(), msg.size());
+	{
+		NoncePool pool;
+		pool.init(1000);
+		CYBOZU_BENCH_C("pool.fill(1000)", 1, pool.fill, 0);
+		CYBOZU_BENCH_C("pool.sign", 1000, pool.sign, sig, sec, msg.c_str(), msg.size(), 0);
+	}
+	{
+		const size_t n = 1000;
+		std::vector<PublicKey> pubVec(n);
+		std::vector<Signature> sigVec(n);
+		std::vector<uint8_t> recIdVec(n);
+		std::vector<const void*> msgVec(n);
+		std::vector<size_t> msgSizeVec(n);
+		for (size_t i = 0; i < n; i++) {
+			sec.setByCSPRNG();
+			getPublicKey(pubVec[i], sec);
+			msgVec[i] = msg.c_str();
+			msgSizeVec[i] = msg.size();
+			sign(sigVec[i], sec, msg.c_str(), msg.size(), &recIdVec[i]);
+		}
+		CYBOZU_BENCH_C("verifyVec(1000)", 10, verifyVec, &sigVec[0], &recIdVec[0], &pubVec[0], &msgVec[0], &msgSizeVec[0], n, 0);
+		PublicKey pub2;
+		CYBOZU_BENCH_C("recoverPublicKey", 1000, recoverPublicKey, pub2, sigVec[0], recIdVec[0], msg.c_str(), msg.size());
+		CYBOZU_BENCH_C("recoverPublicKeyVec(1000)", 10, recoverPublicKeyVec, &pubVec[0], &sigVec[0], &recIdVec[0], &msgVec[0], &msgSizeVec[0], n, 0);
+	}
 }
 #endif
@@ -905,6 +905,31 @@ void mul2Test()
 	}
 }
 
+void invCTTest()
+{
+	Fp x, y, z;
+	Fp::invCT(y, 0);
+	CYBOZU_TEST_ASSERT(y.isZero());
+	Fp::invCT(y, 1);
+	CYBOZU_TEST_ASSERT(y.isOne());
+	x = -1;
+	Fp::invCT(y, x);
+	CYBOZU_TEST_EQUAL(y, x);
+	x = 2;
+	Fp::invCT(y, x);
+	CYBOZU_TEST_EQUAL(y * x, 1);
+	cybozu::XorShift rg;
+	for (int i = 0; i < 100; i++) {
+		x.setByCSPRNG(rg);
+		if (x.isZero()) continue;
+		Fp::inv(y, x);
+		Fp::invCT(z, x);
+		CYBOZU_TEST_EQUAL(y, z);
+		Fp::invCT(x, x); // same addr
+		CYBOZU_TEST_EQUAL(x, y);
+	}
+}
+
 void invVecTest()
 {
 	const size_t maxN = 10;
@@ -931,10 +956,58 @@ void invVecTest()
 					CYBOZU_TEST_EQUAL(y[i], 1 / x[i]);
 				}
 			}
+			Fp z[maxN];
+			CYBOZU_TEST_EQUAL(invVecMT(z, x, n, 2), retN);
+			CYBOZU_TEST_EQUAL_ARRAY(y, z, n);
 			invVec(x, x, n); // same addr
 			CYBOZU_TEST_EQUAL_ARRAY(y, x, n);
 		}
 	}
+	{
+		const size_t n = 3000;
+		std::vector<Fp> v(n), w(n), z(n);
+		for (size_t i = 0; i < n; i++) {
+			v[i].setByCSPRNG(rg);
+		}
+		v[0] = 0;
+		v[1500] = 1;
+		size_t ret = invVec(&w[0], &v[0], n);
+		CYBOZU_TEST_EQUAL(ret, n - 2);
+		CYBOZU_TEST_EQUAL(invVecMT(&z[0], &v[0], n), ret);
+		CYBOZU_TEST_ASSERT(w == z);
+	}
+}
+
+void squareRootVecTest()
+{
+	const size_t n = 80;
+	Fp x[n], y[n];
+	bool isSquare[n];
+	cybozu::XorShift rg;
+	for (size_t i = 0; i < n; i++) {
+		x[i].setByCSPRNG(rg);
+		if (i % 3 == 0) Fp::sqr(x[i], x[i]);
+	}
+	x[1] = 0;
+	CYBOZU_TEST_ASSERT(!Fp::squareRootVec(y, x, n, isSquare));
+	for (size_t i = 0; i < n; i++) {
+		Fp t;
+		bool b = Fp::squareRoot(t, x[i]);
+		CYBOZU_TEST_EQUAL(isSquare[i], b);
+		if (b) {
+			Fp::sqr(t, y[i]);
+			CYBOZU_TEST_EQUAL(t, x[i]);
+		}
+	}
+	for (size_t i = 0; i < n; i++) {
+		Fp::sqr(x[i], x[i]);
+		y[i] = x[i];
+	}
+	CYBOZU_TEST_ASSERT(Fp::squareRootVec(x, x, n)); // same addr
+	for (size_t i = 0; i < n; i++) {
+		Fp::sqr(x[i], x[i]);
+	}
+	CYBOZU_TEST_EQUAL_ARRAY(x, y, n);
 }
 
 void getMontgomeryCoeffTest()
@@ -1018,7 +1091,9 @@ void mainTest()
 		printf("prime=%s\n", pStr);
 		Fp::init(pStr);
 		getMontgomeryCoeffTest();
+		invCTTest();
 		invVecTest();
+		squareRootVecTest();
 		mul2Test();
 		cstrTest();
 		setStrTest();
@@ -7,7 +7,9 @@
 #include <cybozu/atoi.hpp>
 #include <cybozu/file.hpp>
 #include <cybozu/benchmark.hpp>
+#include <cybozu/xorshift.hpp>
 #include "../src/mapto_wb19.hpp"
+#include "../src/msm.hpp"
 
 using namespace mcl;
 using namespace mcl::bn;
@@ -358,6 +360,26 @@ void testHashToFp2v7(const MapTo& mapto)
 			mcl::fp::expand_message_xmd(md, mdSize, msg, msgSize, dst, dstSize);
 			CYBOZU_TEST_EQUAL(toHexStr(md, mdSize), expect);
 		}
+		// hash the messages with the same dst and mdSize at once
+		for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(tbl); i++) {
+			const void *msgVec[CYBOZU_NUM_OF_ARRAY(tbl)];
+			size_t msgSizeVec[CYBOZU_NUM_OF_ARRAY(tbl)];
+			size_t idx[CYBOZU_NUM_OF_ARRAY(tbl)];
+			size_t n = 0;
+			for (size_t j = 0; j < CYBOZU_NUM_OF_ARRAY(tbl); j++) {
+				if (strcmp(tbl[i].dst, tbl[j].dst) != 0 || tbl[i].mdSize != tbl[j].mdSize) continue;
+				msgVec[n] = tbl[j].msg;
+				msgSizeVec[n] = strlen(tbl[j].msg);
+				idx[n] = j;
+				n++;
+			}
+			const size_t mdSize = tbl[i].mdSize;
+			uint8_t md[CYBOZU_NUM_OF_ARRAY(tbl) * 256];
+			mcl::fp::expand_message_xmdVec(md, mdSize, msgVec, msgSizeVec, n, tbl[i].dst, strlen(tbl[i].dst));
+			for (size_t j = 0; j < n; j++) {
+				CYBOZU_TEST_EQUAL(toHexStr(md + mdSize * j, mdSize), tbl[idx[j]].expect);
+			}
+		}
 	}
 	{
 		const uint8_t largeMsg[] = {
@@ -848,6 +870,165 @@ void testSameUV(const MapTo& mapto)
 	}
 }
 
+void testFpToG1VecOpti(const MapTo& mapto)
+{
+#if MCL_MSM == 1
+	if ((mcl::bint::g_cpuType & mcl::bint::tAVX512_IFMA) == 0) return;
+	MapTo m = mapto;
+	m.FpToG1VecOpti = mcl::msm::FpToG1VecAVX512;
+	const size_t n = 13; // not a multiple of 8
+	Fp u[n * 2];
+	for (size_t i = 0; i < n * 2; i++) {
+		u[i].setByCSPRNG();
+	}
+	// u = v, u = -v, u = v = 0, u = v = 1
+	u[3] = u[2];
+	Fp::neg(u[5], u[4]);
+	u[6] = 0;
+	u[7] = 0;
+	u[8] = 1;
+	u[9] = 1;
+	G1 P[n], Q;
+	m.FpToG1Vec(P, u, n);
+	for (size_t i = 0; i < n; i++) {
+		mapto.FpToG1(Q, u[i * 2], &u[i * 2 + 1]);
+		CYBOZU_TEST_EQUAL(P[i], Q);
+	}
+	CYBOZU_TEST_ASSERT(P[2].isZero());
+#ifdef NDEBUG
+	CYBOZU_BENCH_C("FpToG1Vec  ", 100, mapto.FpToG1Vec, P, u, 8);
+	CYBOZU_BENCH_C("FpToG1Vec M", 100, m.FpToG1Vec, P, u, 8);
+#endif
+#else
+	(void)mapto;
+#endif
+}
+
+void testMsgToVec(const MapTo& mapto)
+{
+	const size_t n = 40; // > MapTo::maxVecN
+	std::string msgs[n];
+	const void *msgVec[n];
+	size_t msgSizeVec[n];
+	for (size_t i = 0; i < n; i++) {
+		msgs[i] = cybozu::itoa(i * i) + "abc";
+		msgVec[i] = msgs[i].c_str();
+		msgSizeVec[i] = msgs[i].size();
+	}
+	msgSizeVec[3] = 0;
+	G1 P[n], P2[n];
+	G2 Q[n], Q2[n];
+	mapto.msgToG1Vec(P, msgVec, msgSizeVec, n);
+	mapto.msgToG2Vec(Q, msgVec, msgSizeVec, n);
+	for (size_t i = 0; i < n; i++) {
+		mapto.msgToG1(P2[i], msgVec[i], msgSizeVec[i]);
+		mapto.msgToG2(Q2[i], msgVec[i], msgSizeVec[i]);
+		CYBOZU_TEST_EQUAL(P[i], P2[i]);
+		CYBOZU_TEST_EQUAL(Q[i], Q2[i]);
+	}
+	hashAndMapToG1Vec(P, msgVec, msgSizeVec, n);
+	hashAndMapToG2Vec(Q, msgVec, msgSizeVec, n);
+	for (size_t i = 0; i < n; i++) {
+		CYBOZU_TEST_ASSERT(P[i].z.isOne());
+		CYBOZU_TEST_ASSERT(Q[i].z.isOne());
+		CYBOZU_TEST_EQUAL(P[i], P2[i]);
+		CYBOZU_TEST_EQUAL(Q[i], Q2[i]);
+	}
+	hashAndMapToG1VecMT(P, msgVec, msgSizeVec, n, 3);
+	hashAndMapToG2VecMT(Q, msgVec, msgSizeVec, n, 3);
+	CYBOZU_TEST_EQUAL_ARRAY(P, P2, n);
+	CYBOZU_TEST_EQUAL_ARRAY(Q, Q2, n);
+#ifdef NDEBUG
+	CYBOZU_BENCH_C("msgToG1   ", 100, mapto.msgToG1, P[0], msgVec[0], msgSizeVec[0]);
+	CYBOZU_BENCH_C("msgToG1Vec", 100, mapto.msgToG1Vec, P, msgVec, msgSizeVec, 1);
+	CYBOZU_BENCH_C("msgToG1Vec", 10, mapto.msgToG1Vec, P, msgVec, msgSizeVec, n);
+	CYBOZU_BENCH_C("msgToG2   ", 100, mapto.msgToG2, Q[0], msgVec[0], msgSizeVec[0]);
+	CYBOZU_BENCH_C("msgToG2Vec", 10, mapto.msgToG2Vec, Q, msgVec, msgSizeVec, n);
+#endif
+}
+
+/*
+	hashAndMapToG2 uses the length of dstG2
+	even if dstG1 has a different length
+*/
+void testDstG2()
+{
+	const char *dst1 = "abc";
+	const char *dst2 = "QUUX-V01-CS02-with-BLS12381G2_XMD:SHA-256_SSWU_RO_";
+	CYBOZU_TEST_ASSERT(setDstG1(dst1, strlen(dst1)));
+	CYBOZU_TEST_ASSERT(setDstG2(dst2, strlen(dst2)));
+	// https://www.ietf.org/id/draft-irtf-cfrg-hash-to-curve-09.html#name-bls12381g2_xmdsha-256_sswu_
+	const PointStr ps = {
+		{
+			"0x02c2d18e033b960562aae3cab37a27ce00d80ccd5ba4b7fe0e7a210245129dbec7780ccc7954725f4168aff2787776e6",
+			"0x139cddbccdc5e91b9623efd38c49f81a6f83f175e80b06fc374de9eb4b41dfe4ca3a230ed250fbe3a2acf73a41177fd8",
+		},
+		{
+			"0x1787327b68159716a37440985269cf584bcb1e621d3a7202be6ea05c4cfe244aeb197642555a0645fb87bf7466b2ba48",
+			"0x00aa65dae3c8d732d10ecd2c50f8a1baf3001578f71c694e03866e9f3d49ac1e1ce70dd94a733534f106d4cec0eddd16",
+		},
+		{ "1", "0" },
+	};
+	G2 P1, P2;
+	set(P1, ps);
+	const char *msg = "abc";
+	hashAndMapToG2(P2, msg, strlen(msg));
+	CYBOZU_TEST_EQUAL(P1, P2);
+	const void *msgVec[] = { msg };
+	const size_t msgSizeVec[] = { strlen(msg) };
+	hashAndMapToG2Vec(&P2, msgVec, msgSizeVec, 1);
+	CYBOZU_TEST_EQUAL(P1, P2);
+	// restore the default
+	dst1 = "BLS_SIG_BLS12381G1_XMD:SHA-256_SSWU_RO_POP_";
+	dst2 = "BLS_SIG_BLS12381G2_XMD:SHA-256_SSWU_RO_POP_";
+	CYBOZU_TEST_ASSERT(setDstG1(dst1, strlen(dst1)));
+	CYBOZU_TEST_ASSERT(setDstG2(dst2, strlen(dst2)));
+}
+
+void testExpandMsgVec()
+{
+	const size_t n = 40;
+	std::string msgs[n];
+	const void *msgVec[n];
+	size_t msgSizeVec[n];
+	cybozu::XorShift rg;
+	for (size_t i = 0; i < n; i++) {
+		// some messages are too long to be hashed at once
+		msgs[i].resize(i * 17 + (i % 5 == 4 ? 600 : 0));
+		for (size_t j = 0; j < msgs[i].size(); j++) {
+			msgs[i][j] = char(rg.get32());
+		}
+		msgVec[i] = msgs[i].data();
+		msgSizeVec[i] = msgs[i].size();
+	}
+	const std::string dstTbl[] = {
+		"",
+		"QUUX-V01-CS02-with-expander",
+		std::string(255, 'a'),
+		std::string(300, 'b'), // oversize dst
+	};
+	const size_t outSizeTbl[] = { 32, 128, 256 };
+	std::vector<uint8_t> md(n * 256), md2(256);
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(dstTbl); i++) {
+		const std::string& dst = dstTbl[i];
+		for (size_t j = 0; j < CYBOZU_NUM_OF_ARRAY(outSizeTbl); j++) {
+			const size_t outSize = outSizeTbl[j];
+			mcl::fp::expand_message_xmdVec(&md[0], outSize, msgVec, msgSizeVec, n, dst.data(), dst.size());
+			for (size_t k = 0; k < n; k++) {
+				mcl::fp::expand_message_xmd(&md2[0], outSize, msgVec[k], msgSizeVec[k], dst.data(), dst.size());
+				CYBOZU_TEST_EQUAL_ARRAY(&md[outSize * k], &md2[0], outSize);
+			}
+		}
+	}
+#ifdef NDEBUG
+	const char *dst = "QUUX-V01-CS02-with-BLS12381G2_XMD:SHA-256_SSWU_RO_";
+	const size_t dstSize = strlen(dst);
+	for (size_t i = 0; i < n; i++) msgSizeVec[i] = 32;
+	CYBOZU_BENCH_C("expand_message_xmd    ", 1000, mcl::fp::expand_message_xmd, &md[0], 256, msgVec[0], 32, dst, dstSize);
+	CYBOZU_BENCH_C("expand_message_xmdVec ", 100, mcl::fp::expand_message_xmdVec, &md[0], 256, msgVec, msgSizeVec, 16, dst, dstSize);
+#endif
+}
+
 void testSetDst(MapTo& mapto)
 {
 	const char *dst = "abc";
@@ -878,11 +1059,15 @@ CYBOZU_TEST_AUTO(test)
 	iso3Test(mapto);
 	testHMAC();
 	testHashToFp2v7(mapto);
+	testExpandMsgVec();
 	testEth2phase0();
 	testSswuG1(mapto);
 	testMsgToG1(mapto);
 	testFpToG1(mapto);
 	testSameUV(mapto);
+	testFpToG1VecOpti(mapto);
+	testMsgToVec(mapto);
+	testDstG2();
 	// this test should be last
 	testSetDst(mapto);
 }
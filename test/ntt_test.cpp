@@ -1,7 +1,11 @@
 #include <mcl/bls12_381.hpp>
 #include <mcl/ntt.hpp>
+#include <mcl/poly.hpp>
 #include <cybozu/test.hpp>
 #include <cybozu/xorshift.hpp>
+#include <cybozu/benchmark.hpp>
+#include <vector>
+#include <algorithm>
 
 using namespace mcl::bls12;
 using namespace mcl;
@@ -123,3 +127,304 @@ CYBOZU_TEST_AUTO(generic)
 	puts("G1");
 	test<NTT, G1>(ntt, inG1, maxBitN);
 }
+
+CYBOZU_TEST_AUTO(fastFr)
+{
+	typedef mcl::Ntt<Fr> NTT;
+	const size_t maxBitN = NTT::maxDirectBitN + 2; // use the four-step method for bitN > NTT::maxDirectBitN
+	const size_t maxN = size_t(1) << maxBitN;
+	std::vector<Fr> in(maxN), x(maxN), y(maxN);
+	cybozu::XorShift rg;
+	for (size_t i = 0; i < maxN; i++) {
+		in[i].setByCSPRNG(rg);
+	}
+	for (size_t bitN = 1; bitN <= maxBitN; bitN++) {
+		const size_t n = size_t(1) << bitN;
+		NTT ntt;
+		CYBOZU_TEST_ASSERT(ntt.init(n));
+		// compare with the generic version
+		copy(&x[0], &in[0], n);
+		copy(&y[0], &in[0], n);
+		ntt.ntt(&x[0]);
+		ntt._ntt(&y[0], ntt.getWs(), false);
+		CYBOZU_TEST_ASSERT(std::equal(x.begin(), x.begin() + n, y.begin()));
+		ntt.intt(&x[0]);
+		CYBOZU_TEST_ASSERT(std::equal(x.begin(), x.begin() + n, in.begin()));
+		copy(&x[0], &in[0], n);
+		ntt.nttMT(&x[0], 3);
+		CYBOZU_TEST_ASSERT(std::equal(x.begin(), x.begin() + n, y.begin()));
+		ntt.inttMT(&x[0], 3);
+		CYBOZU_TEST_ASSERT(std::equal(x.begin(), x.begin() + n, in.begin()));
+	}
+}
+
+template<class G>
+void nttEcTest(const G *in, size_t maxBitN)
+{
+	typedef mcl::Ntt<Fr> NTT;
+	const size_t maxN = size_t(1) << maxBitN;
+	std::vector<G> src(maxN), x(maxN), y(maxN);
+	for (size_t bitN = 1; bitN <= maxBitN; bitN++) {
+		const size_t n = size_t(1) << bitN;
+		NTT ntt;
+		CYBOZU_TEST_ASSERT(ntt.init(n));
+		copy(&src[0], in, n);
+		// dbl, zero and P + (-P) in the first stage
+		src[n / 2] = src[0];
+		if (n >= 4) {
+			G::neg(src[n / 4 * 3], src[n / 4]);
+			src[1].clear();
+		}
+		copy(&x[0], &src[0], n);
+		copy(&y[0], &src[0], n);
+		ntt.nttEc(&x[0]);
+		ntt._ntt(&y[0], ntt.getWs(), false);
+		CYBOZU_TEST_ASSERT(std::equal(x.begin(), x.begin() + n, y.begin()));
+		for (size_t i = 0; i < n; i++) {
+			CYBOZU_TEST_ASSERT(x[i].isNormalized());
+		}
+		ntt.inttEcMT(&x[0], 3);
+		CYBOZU_TEST_ASSERT(std::equal(x.begin(), x.begin() + n, src.begin()));
+		ntt.nttEcMT(&x[0], 3);
+		CYBOZU_TEST_ASSERT(std::equal(x.begin(), x.begin() + n, y.begin()));
+		ntt.inttEc(&x[0]);
+		CYBOZU_TEST_ASSERT(std::equal(x.begin(), x.begin() + n, src.begin()));
+	}
+}
+
+CYBOZU_TEST_AUTO(nttEc)
+{
+	const size_t maxBitN = 9;
+	const size_t maxN = size_t(1) << maxBitN;
+	std::vector<G1> inG1(maxN);
+	std::vector<G2> inG2(maxN);
+	cybozu::XorShift rg;
+	for (size_t i = 0; i < maxN; i++) {
+		Fr r;
+		r.setByCSPRNG(rg);
+		G1::mul(inG1[i], getG1basePoint(), r);
+		hashAndMapToG2(inG2[i], &i, sizeof(i));
+	}
+	puts("G1");
+	nttEcTest(&inG1[0], maxBitN);
+	puts("G2");
+	nttEcTest(&inG2[0], 6);
+
+	// convert a KZG setup [tau^i]P to the Lagrange basis [L_i(tau)]P
+	typedef mcl::Ntt<Fr> NTT;
+	const size_t n = 16;
+	NTT ntt;
+	ntt.init(n);
+	const G1& P = getG1basePoint();
+	Fr tau, t;
+	tau.setByCSPRNG(rg);
+	G1 srs[n];
+	t = 1;
+	for (size_t i = 0; i < n; i++) {
+		G1::mul(srs[i], P, t);
+		t *= tau;
+	}
+	ntt.inttEc(srs);
+	Fr invN;
+	Fr::inv(invN, n);
+	for (size_t i = 0; i < n; i++) {
+		// L_i(tau) = (1/n) sum_j w^(-ij) tau^j
+		Fr L = 0;
+		t = 1;
+		for (size_t j = 0; j < n; j++) {
+			L += ntt.getWs()[n - (i * j) % n] * t;
+			t *= tau;
+		}
+		L *= invN;
+		CYBOZU_TEST_EQUAL(srs[i], P * L);
+	}
+}
+
+typedef std::vector<Fr> FrVec;
+
+void mulNaive(FrVec& z, const FrVec& x, const FrVec& y)
+{
+	z.assign(x.size() + y.size() - 1, 0);
+	for (size_t i = 0; i < x.size(); i++) {
+		for (size_t j = 0; j < y.size(); j++) {
+			z[i + j] += x[i] * y[j];
+		}
+	}
+}
+
+Fr evalNaive(const FrVec& f, const Fr& x)
+{
+	Fr y = 0;
+	for (size_t i = f.size(); i > 0; i--) {
+		y = y * x + f[i - 1];
+	}
+	return y;
+}
+
+void setRand(FrVec& x, size_t n, cybozu::XorShift& rg)
+{
+	x.resize(n);
+	for (size_t i = 0; i < n; i++) {
+		x[i].setByCSPRNG(rg);
+	}
+}
+
+CYBOZU_TEST_AUTO(poly)
+{
+	typedef mcl::PolyT<Fr> Poly;
+	const size_t maxN = 1024;
+	Poly poly;
+	CYBOZU_TEST_ASSERT(poly.init(maxN));
+	cybozu::XorShift rg;
+	FrVec x, y, z, w;
+	const size_t tbl[] = { 1, 2, 5, 32, 33, 100, 255, 512 };
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(tbl); i++) {
+		const size_t n = tbl[i];
+		// mul
+		setRand(x, n, rg);
+		setRand(y, n / 2 + 1, rg);
+		mulNaive(w, x, y);
+		z.resize(w.size());
+		CYBOZU_TEST_ASSERT(poly.mul(&z[0], &x[0], x.size(), &y[0], y.size()));
+		CYBOZU_TEST_ASSERT(z == w);
+		// inv
+		z.resize(n);
+		CYBOZU_TEST_ASSERT(poly.inv(&z[0], n, &x[0], n));
+		mulNaive(w, x, z);
+		CYBOZU_TEST_ASSERT(w[0] == 1);
+		for (size_t j = 1; j < n; j++) {
+			CYBOZU_TEST_ASSERT(w[j].isZero());
+		}
+		// divmod : x = q y + r
+		FrVec q(x.size() - y.size() + 1), r(y.size() - 1 + 1);
+		CYBOZU_TEST_ASSERT(poly.divmod(&q[0], &r[0], &x[0], x.size(), &y[0], y.size()));
+		mulNaive(w, q, y);
+		for (size_t j = 0; j + 1 < y.size(); j++) w[j] += r[j];
+		CYBOZU_TEST_ASSERT(w == x);
+		// evaluate
+		const size_t m = n + 3;
+		FrVec pts, vals(m);
+		setRand(pts, m, rg);
+		CYBOZU_TEST_ASSERT(poly.evaluate(&vals[0], &x[0], x.size(), &pts[0], m));
+		for (size_t j = 0; j < m; j++) {
+			CYBOZU_TEST_EQUAL(vals[j], evalNaive(x, pts[j]));
+		}
+		if (n >= 4) {
+			// f of n coefficients at n / 4 points
+			CYBOZU_TEST_ASSERT(poly.evaluate(&vals[0], &x[0], x.size(), &pts[0], n / 4));
+			for (size_t j = 0; j < n / 4; j++) {
+				CYBOZU_TEST_EQUAL(vals[j], evalNaive(x, pts[j]));
+			}
+		}
+		// interpolate
+		setRand(pts, n, rg);
+		setRand(vals, n, rg);
+		z.resize(n);
+		CYBOZU_TEST_ASSERT(poly.interpolate(&z[0], &pts[0], &vals[0], n));
+		for (size_t j = 0; j < n; j++) {
+			CYBOZU_TEST_EQUAL(evalNaive(z, pts[j]), vals[j]);
+		}
+	}
+	// the same points
+	{
+		Fr pts[3] = { 1, 2, 1 };
+		Fr vals[3] = { 4, 5, 6 };
+		Fr f[3];
+		CYBOZU_TEST_ASSERT(!poly.interpolate(f, pts, vals, 3));
+	}
+	// divXnMinus1, divLinear
+	{
+		const size_t n = 16;
+		setRand(x, n * 3 + 5, rg);
+		FrVec q(x.size() - n), r(n);
+		Poly::divXnMinus1(&q[0], &r[0], &x[0], x.size(), n);
+		FrVec d(n + 1, Fr(0));
+		d[0] = -1;
+		d[n] = 1;
+		mulNaive(w, q, d);
+		for (size_t j = 0; j < n; j++) w[j] += r[j];
+		CYBOZU_TEST_ASSERT(w == x);
+		Fr a, rem;
+		a.setByCSPRNG(rg);
+		q.resize(x.size() - 1);
+		Poly::divLinear(&q[0], rem, &x[0], x.size(), a);
+		CYBOZU_TEST_EQUAL(rem, evalNaive(x, a));
+		d.resize(2);
+		d[0] = -a;
+		d[1] = 1;
+		mulNaive(w, q, d);
+		w[0] += rem;
+		CYBOZU_TEST_ASSERT(w == x);
+	}
+	// quotient by X^n - 1 on a coset : (f g - h) / (X^n - 1) where f g = h on H
+	{
+		const size_t bitN = 5;
+		const size_t n = size_t(1) << bitN;
+		FrVec f, g;
+		setRand(f, n, rg);
+		setRand(g, n, rg);
+		mulNaive(w, f, g);
+		FrVec q0(n - 1), h(n);
+		Poly::divXnMinus1(&q0[0], &h[0], &w[0], w.size(), n);
+		const Fr s = 7; // a generator of Fr^*
+		FrVec a(n * 2, Fr(0)), b(n * 2, Fr(0)), c(n * 2, Fr(0));
+		std::copy(f.begin(), f.end(), a.begin());
+		std::copy(g.begin(), g.end(), b.begin());
+		std::copy(h.begin(), h.end(), c.begin());
+		CYBOZU_TEST_ASSERT(poly.cosetNtt(&a[0], bitN + 1, s));
+		CYBOZU_TEST_ASSERT(poly.cosetNtt(&b[0], bitN + 1, s));
+		CYBOZU_TEST_ASSERT(poly.cosetNtt(&c[0], bitN + 1, s));
+		// Z(s w^i) = s^n w^(ni) - 1 = s^n (-1)^i - 1
+		Fr sn, z0, z1, inv0, inv1;
+		Fr::pow(sn, s, n);
+		z0 = sn - 1;
+		z1 = -sn - 1;
+		Fr::inv(inv0, z0);
+		Fr::inv(inv1, z1);
+		for (size_t i = 0; i < n * 2; i++) {
+			a[i] = (a[i] * b[i] - c[i]) * ((i & 1) ? inv1 : inv0);
+		}
+		CYBOZU_TEST_ASSERT(poly.cosetIntt(&a[0], bitN + 1, s));
+		for (size_t i = 0; i < n * 2; i++) {
+			CYBOZU_TEST_EQUAL(a[i], i < n - 1 ? q0[i] : Fr(0));
+		}
+	}
+}
+
+#ifdef NDEBUG
+CYBOZU_TEST_AUTO(bench)
+{
+	typedef mcl::Ntt<Fr> NTT;
+	const size_t tbl[] = { 10, 14, 18, 20 };
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(tbl); i++) {
+		const size_t bitN = tbl[i];
+		const size_t n = size_t(1) << bitN;
+		std::vector<Fr> x(n);
+		for (size_t j = 0; j < n; j++) {
+			x[j] = int(j + 1);
+		}
+		NTT ntt;
+		ntt.init(n);
+		const int C = bitN < 16 ? 10 : 1;
+		printf("bitN=%zd\n", bitN);
+		CYBOZU_BENCH_C("_ntt  ", C, ntt._ntt, &x[0], ntt.getWs(), false);
+		CYBOZU_BENCH_C("ntt   ", C, ntt.ntt, &x[0]);
+		CYBOZU_BENCH_C("_intt ", C, ntt._ntt, &x[0], ntt.getWs(), true);
+		CYBOZU_BENCH_C("intt  ", C, ntt.intt, &x[0]);
+		CYBOZU_BENCH_C("nttMT ", C, ntt.nttMT, &x[0], 0);
+	}
+	{
+		const size_t bitN = 10;
+		const size_t n = size_t(1) << bitN;
+		std::vector<G1> x(n);
+		for (size_t j = 0; j < n; j++) {
+			hashAndMapToG1(x[j], &j, sizeof(j));
+		}
+		NTT ntt;
+		ntt.init(n);
+		printf("G1 bitN=%zd\n", bitN);
+		CYBOZU_BENCH_C("_ntt  ", 1, ntt._ntt, &x[0], ntt.getWs(), false);
+		CYBOZU_BENCH_C("nttEc ", 1, ntt.nttEc, &x[0]);
+	}
+}
+#endif
@@ -94,6 +94,61 @@ CYBOZU_TEST_AUTO(encDec)
 	}
 }
 
+CYBOZU_TEST_AUTO(encVec)
+{
+	sheSecretKey sec;
+	sheSecretKeySetByCSPRNG(&sec);
+	shePublicKey pub;
+	sheGetPublicKey(&pub, &sec);
+	shePrecomputedPublicKey *ppub = shePrecomputedPublicKeyCreate();
+	CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyInit(ppub, &pub), 0);
+
+	const size_t n = 10;
+	mclInt m[n];
+	for (size_t i = 0; i < n; i++) {
+		m[i] = mclInt(i) * 3 - 12;
+	}
+	sheCipherTextG1 c1[n];
+	sheCipherTextG2 c2[n];
+	sheCipherTextGT ct[n];
+	for (int mode = 0; mode < 4; mode++) {
+		switch (mode) {
+		case 0:
+			CYBOZU_TEST_EQUAL(sheEncG1Vec(c1, &pub, m, n), 0);
+			CYBOZU_TEST_EQUAL(sheEncG2Vec(c2, &pub, m, n), 0);
+			CYBOZU_TEST_EQUAL(sheEncGTVec(ct, &pub, m, n), 0);
+			break;
+		case 1:
+			CYBOZU_TEST_EQUAL(sheEncG1VecMT(c1, &pub, m, n, 0), 0);
+			CYBOZU_TEST_EQUAL(sheEncG2VecMT(c2, &pub, m, n, 0), 0);
+			CYBOZU_TEST_EQUAL(sheEncGTVecMT(ct, &pub, m, n, 0), 0);
+			break;
+		case 2:
+			CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyEncG1Vec(c1, ppub, m, n), 0);
+			CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyEncG2Vec(c2, ppub, m, n), 0);
+			CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyEncGTVec(ct, ppub, m, n), 0);
+			break;
+		default:
+			CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyEncG1VecMT(c1, ppub, m, n, 0), 0);
+			CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyEncG2VecMT(c2, ppub, m, n, 0), 0);
+			CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyEncGTVecMT(ct, ppub, m, n, 0), 0);
+			break;
+		}
+		for (size_t i = 0; i < n; i++) {
+			mclInt dec = 0;
+			CYBOZU_TEST_EQUAL(sheDecG1(&dec, &sec, &c1[i]), 0);
+			CYBOZU_TEST_EQUAL(dec, m[i]);
+			dec = 0;
+			CYBOZU_TEST_EQUAL(sheDecG2(&dec, &sec, &c2[i]), 0);
+			CYBOZU_TEST_EQUAL(dec, m[i]);
+			dec = 0;
+			CYBOZU_TEST_EQUAL(sheDecGT(&dec, &sec, &ct[i]), 0);
+			CYBOZU_TEST_EQUAL(dec, m[i]);
+		}
+	}
+	shePrecomputedPublicKeyDestroy(ppub);
+}
+
 CYBOZU_TEST_AUTO(addMul)
 {
 	sheSecretKey sec;
@@ -115,6 +170,64 @@ CYBOZU_TEST_AUTO(addMul)
 	CYBOZU_TEST_EQUAL(dec, m1 * m2);
 }
 
+CYBOZU_TEST_AUTO(addSumVec)
+{
+	sheSecretKey sec;
+	sheSecretKeySetByCSPRNG(&sec);
+	shePublicKey pub;
+	sheGetPublicKey(&pub, &sec);
+
+	const size_t n = 10;
+	mclInt m1[n], m2[n];
+	mclInt sum = 0;
+	for (size_t i = 0; i < n; i++) {
+		m1[i] = mclInt(i) * 3 - 12;
+		m2[i] = 5 - mclInt(i);
+		sum += m1[i];
+	}
+	sheCipherTextG1 x1[n], y1[n], z1[n], s1;
+	sheCipherTextG2 x2[n], y2[n], z2[n], s2;
+	sheCipherTextGT xt[n], yt[n], zt[n], st;
+	CYBOZU_TEST_EQUAL(sheEncG1Vec(x1, &pub, m1, n), 0);
+	CYBOZU_TEST_EQUAL(sheEncG2Vec(x2, &pub, m1, n), 0);
+	CYBOZU_TEST_EQUAL(sheEncGTVec(xt, &pub, m1, n), 0);
+	CYBOZU_TEST_EQUAL(sheEncG1Vec(y1, &pub, m2, n), 0);
+	CYBOZU_TEST_EQUAL(sheEncG2Vec(y2, &pub, m2, n), 0);
+	CYBOZU_TEST_EQUAL(sheEncGTVec(yt, &pub, m2, n), 0);
+	for (int mode = 0; mode < 2; mode++) {
+		if (mode == 0) {
+			CYBOZU_TEST_EQUAL(sheAddG1Vec(z1, x1, y1, n), 0);
+			CYBOZU_TEST_EQUAL(sheAddG2Vec(z2, x2, y2, n), 0);
+			CYBOZU_TEST_EQUAL(sheAddGTVec(zt, xt, yt, n), 0);
+			CYBOZU_TEST_EQUAL(sheSumG1Vec(&s1, x1, n), 0);
+			CYBOZU_TEST_EQUAL(sheSumG2Vec(&s2, x2, n), 0);
+			CYBOZU_TEST_EQUAL(sheSumGTVec(&st, xt, n), 0);
+		} else {
+			CYBOZU_TEST_EQUAL(sheAddG1VecMT(z1, x1, y1, n, 0), 0);
+			CYBOZU_TEST_EQUAL(sheAddG2VecMT(z2, x2, y2, n, 0), 0);
+			CYBOZU_TEST_EQUAL(sheAddGTVecMT(zt, xt, yt, n, 0), 0);
+			CYBOZU_TEST_EQUAL(sheSumG1VecMT(&s1, x1, n, 0), 0);
+			CYBOZU_TEST_EQUAL(sheSumG2VecMT(&s2, x2, n, 0), 0);
+			CYBOZU_TEST_EQUAL(sheSumGTVecMT(&st, xt, n, 0), 0);
+		}
+		mclInt dec;
+		for (size_t i = 0; i < n; i++) {
+			CYBOZU_TEST_EQUAL(sheDecG1(&dec, &sec, &z1[i]), 0);
+			CYBOZU_TEST_EQUAL(dec, m1[i] + m2[i]);
+			CYBOZU_TEST_EQUAL(sheDecG2(&dec, &sec, &z2[i]), 0);
+			CYBOZU_TEST_EQUAL(dec, m1[i] + m2[i]);
+			CYBOZU_TEST_EQUAL(sheDecGT(&dec, &sec, &zt[i]), 0);
+			CYBOZU_TEST_EQUAL(dec, m1[i] + m2[i]);
+		}
+		CYBOZU_TEST_EQUAL(sheDecG1(&dec, &sec, &s1), 0);
+		CYBOZU_TEST_EQUAL(dec, sum);
+		CYBOZU_TEST_EQUAL(sheDecG2(&dec, &sec, &s2), 0);
+		CYBOZU_TEST_EQUAL(dec, sum);
+		CYBOZU_TEST_EQUAL(sheDecGT(&dec, &sec, &st), 0);
+		CYBOZU_TEST_EQUAL(dec, sum);
+	}
+}
+
 CYBOZU_TEST_AUTO(allOp)
 {
 	sheSecretKey sec;
@@ -192,6 +305,52 @@ CYBOZU_TEST_AUTO(rerand)
 	CYBOZU_TEST_EQUAL(dec, m1 * m2 + m3);
 }
 
+CYBOZU_TEST_AUTO(reRandVec)
+{
+	sheSecretKey sec;
+	sheSecretKeySetByCSPRNG(&sec);
+	shePublicKey pub;
+	sheGetPublicKey(&pub, &sec);
+	shePrecomputedPublicKey *ppub = shePrecomputedPublicKeyCreate();
+	CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyInit(ppub, &pub), 0);
+
+	const size_t n = 5;
+	mclInt m[n];
+	for (size_t i = 0; i < n; i++) {
+		m[i] = mclInt(i) * 7 - 10;
+	}
+	sheCipherTextG1 c1[n];
+	sheCipherTextG2 c2[n];
+	sheCipherTextGT ct[n];
+	CYBOZU_TEST_EQUAL(sheEncG1Vec(c1, &pub, m, n), 0);
+	CYBOZU_TEST_EQUAL(sheEncG2Vec(c2, &pub, m, n), 0);
+	CYBOZU_TEST_EQUAL(sheEncGTVec(ct, &pub, m, n), 0);
+	CYBOZU_TEST_EQUAL(sheReRandG1Vec(c1, &pub, n), 0);
+	CYBOZU_TEST_EQUAL(sheReRandG2Vec(c2, &pub, n), 0);
+	CYBOZU_TEST_EQUAL(sheReRandGTVec(ct, &pub, n), 0);
+	CYBOZU_TEST_EQUAL(sheReRandG1VecMT(c1, &pub, n, 0), 0);
+	CYBOZU_TEST_EQUAL(sheReRandG2VecMT(c2, &pub, n, 0), 0);
+	CYBOZU_TEST_EQUAL(sheReRandGTVecMT(ct, &pub, n, 0), 0);
+	CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyReRandG1Vec(c1, ppub, n), 0);
+	CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyReRandG2Vec(c2, ppub, n), 0);
+	CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyReRandGTVec(ct, ppub, n), 0);
+	CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyReRandG1VecMT(c1, ppub, n, 0), 0);
+	CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyReRandG2VecMT(c2, ppub, n, 0), 0);
+	CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyReRandGTVecMT(ct, ppub, n, 0), 0);
+	for (size_t i = 0; i < n; i++) {
+		mclInt dec = 0;
+		CYBOZU_TEST_EQUAL(sheDecG1(&dec, &sec, &c1[i]), 0);
+		CYBOZU_TEST_EQUAL(dec, m[i]);
+		dec = 0;
+		CYBOZU_TEST_EQUAL(sheDecG2(&dec, &sec, &c2[i]), 0);
+		CYBOZU_TEST_EQUAL(dec, m[i]);
+		dec = 0;
+		CYBOZU_TEST_EQUAL(sheDecGT(&dec, &sec, &ct[i]), 0);
+		CYBOZU_TEST_EQUAL(dec, m[i]);
+	}
+	shePrecomputedPublicKeyDestroy(ppub);
+}
+
 CYBOZU_TEST_AUTO(serialize)
 {
 	sheSecretKey sec1, sec2;
@@ -285,6 +444,27 @@ CYBOZU_TEST_AUTO(convert)
 	dec = 0;
 	CYBOZU_TEST_EQUAL(sheDecGT(&dec, &sec, &ct), 0);
 	CYBOZU_TEST_EQUAL(dec, 123);
+
+	const size_t n = 3;
+	const mclInt mVec[n] = { 5, 0, -7 };
+	sheCipherTextG1 c1Vec[n];
+	sheCipherTextG2 c2Vec[n];
+	sheCipherTextGT ctVec[n];
+	CYBOZU_TEST_EQUAL(sheEncG1Vec(c1Vec, &pub, mVec, n), 0);
+	CYBOZU_TEST_EQUAL(sheEncG2Vec(c2Vec, &pub, mVec, n), 0);
+	for (int mode = 0; mode < 4; mode++) {
+		switch (mode) {
+		case 0: CYBOZU_TEST_EQUAL(sheConvertG1Vec(ctVec, &pub, c1Vec, n), 0); break;
+		case 1: CYBOZU_TEST_EQUAL(sheConvertG1VecMT(ctVec, &pub, c1Vec, n, 0), 0); break;
+		case 2: CYBOZU_TEST_EQUAL(sheConvertG2Vec(ctVec, &pub, c2Vec, n), 0); break;
+		default: CYBOZU_TEST_EQUAL(sheConvertG2VecMT(ctVec, &pub, c2Vec, n, 0), 0); break;
+		}
+		for (size_t i = 0; i < n; i++) {
+			dec = 0;
+			CYBOZU_TEST_EQUAL(sheDecGT(&dec, &sec, &ctVec[i]), 0);
+			CYBOZU_TEST_EQUAL(dec, mVec[i]);
+		}
+	}
 }
 
 CYBOZU_TEST_AUTO(precomputed)
@@ -464,6 +644,81 @@ CYBOZU_TEST_AUTO(ZkpBinEq)
 	shePrecomputedPublicKeyDestroy(ppub);
 }
 
+CYBOZU_TEST_AUTO(verifyVec)
+{
+	sheSecretKey sec;
+	sheSecretKeySetByCSPRNG(&sec);
+	shePublicKey pub;
+	sheGetPublicKey(&pub, &sec);
+	shePrecomputedPublicKey *ppub = shePrecomputedPublicKeyCreate();
+	CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyInit(ppub, &pub), 0);
+
+	const size_t n = 5;
+	const int mVec[] = { 0, 1, 2 };
+	const size_t mSize = CYBOZU_NUM_OF_ARRAY(mVec);
+	sheCipherTextG1 c1[n], c3[n], c5[n], cs[n];
+	sheCipherTextG2 c2[n], c4[n], c6[n];
+	sheZkpBin zkp1[n], zkp2[n];
+	sheZkpEq zkpEq[n];
+	sheZkpBinEq zkpBinEq[n];
+	mclBnFr zkpSet[n * mSize * 2];
+	int okVec[n];
+	for (int mode = 0; mode < 2; mode++) {
+		for (size_t i = 0; i < n; i++) {
+			const int m = int(i % 2);
+			if (mode == 0) {
+				CYBOZU_TEST_EQUAL(sheEncWithZkpBinG1(&c1[i], &zkp1[i], &pub, m), 0);
+				CYBOZU_TEST_EQUAL(sheEncWithZkpBinG2(&c2[i], &zkp2[i], &pub, m), 0);
+				CYBOZU_TEST_EQUAL(sheEncWithZkpEq(&c3[i], &c4[i], &zkpEq[i], &pub, i), 0);
+				CYBOZU_TEST_EQUAL(sheEncWithZkpBinEq(&c5[i], &c6[i], &zkpBinEq[i], &pub, m), 0);
+				CYBOZU_TEST_EQUAL(sheEncWithZkpSetG1(&cs[i], &zkpSet[i * mSize * 2], &pub, int(i % mSize), mVec, mSize), 0);
+			} else {
+				CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyEncWithZkpBinG1(&c1[i], &zkp1[i], ppub, m), 0);
+				CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyEncWithZkpBinG2(&c2[i], &zkp2[i], ppub, m), 0);
+				CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyEncWithZkpEq(&c3[i], &c4[i], &zkpEq[i], ppub, i), 0);
+				CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyEncWithZkpBinEq(&c5[i], &c6[i], &zkpBinEq[i], ppub, m), 0);
+				CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyEncWithZkpSetG1(&cs[i], &zkpSet[i * mSize * 2], ppub, int(i % mSize), mVec, mSize), 0);
+			}
+		}
+		zkpEq[0].d[0].d[0]++;
+		zkp1[2].d[0].d[0]++;
+		if (mode == 0) {
+			CYBOZU_TEST_EQUAL(sheVerifyZkpBinG1Vec(&pub, c1, zkp1, n, okVec), 0);
+			for (size_t i = 0; i < n; i++) {
+				CYBOZU_TEST_EQUAL(okVec[i], i == 2 ? 0 : 1);
+			}
+			CYBOZU_TEST_EQUAL(sheVerifyZkpBinG1VecMT(&pub, c1, zkp1, n, 0, 0), 0);
+			CYBOZU_TEST_EQUAL(sheVerifyZkpBinG2Vec(&pub, c2, zkp2, n, okVec), 1);
+			CYBOZU_TEST_EQUAL(sheVerifyZkpBinG2VecMT(&pub, c2, zkp2, n, okVec, 0), 1);
+			CYBOZU_TEST_EQUAL(sheVerifyZkpSetG1Vec(&pub, cs, zkpSet, mVec, mSize, n, okVec), 1);
+			CYBOZU_TEST_EQUAL(sheVerifyZkpSetG1VecMT(&pub, cs, zkpSet, mVec, mSize, n, okVec, 0), 1);
+			CYBOZU_TEST_EQUAL(sheVerifyZkpEqVec(&pub, c3, c4, zkpEq, n, okVec), 0);
+			CYBOZU_TEST_EQUAL(okVec[0], 0);
+			CYBOZU_TEST_EQUAL(okVec[1], 1);
+			CYBOZU_TEST_EQUAL(sheVerifyZkpEqVecMT(&pub, c3, c4, zkpEq, n, okVec, 0), 0);
+			CYBOZU_TEST_EQUAL(sheVerifyZkpBinEqVec(&pub, c5, c6, zkpBinEq, n, okVec), 1);
+			CYBOZU_TEST_EQUAL(sheVerifyZkpBinEqVecMT(&pub, c5, c6, zkpBinEq, n, okVec, 0), 1);
+		} else {
+			CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyVerifyZkpBinG1Vec(ppub, c1, zkp1, n, okVec), 0);
+			for (size_t i = 0; i < n; i++) {
+				CYBOZU_TEST_EQUAL(okVec[i], i == 2 ? 0 : 1);
+			}
+			CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyVerifyZkpBinG1VecMT(ppub, c1, zkp1, n, 0, 0), 0);
+			CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyVerifyZkpBinG2Vec(ppub, c2, zkp2, n, okVec), 1);
+			CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyVerifyZkpBinG2VecMT(ppub, c2, zkp2, n, okVec, 0), 1);
+			CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyVerifyZkpSetG1Vec(ppub, cs, zkpSet, mVec, mSize, n, okVec), 1);
+			CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyVerifyZkpSetG1VecMT(ppub, cs, zkpSet, mVec, mSize, n, okVec, 0), 1);
+			CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyVerifyZkpEqVec(ppub, c3, c4, zkpEq, n, okVec), 0);
+			CYBOZU_TEST_EQUAL(okVec[0], 0);
+			CYBOZU_TEST_EQUAL(okVec[1], 1);
+			CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyVerifyZkpEqVecMT(ppub, c3, c4, zkpEq, n, okVec, 0), 0);
+			CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyVerifyZkpBinEqVec(ppub, c5, c6, zkpBinEq, n, okVec), 1);
+			CYBOZU_TEST_EQUAL(shePrecomputedPublicKeyVerifyZkpBinEqVecMT(ppub, c5, c6, zkpBinEq, n, okVec, 0), 1);
+		}
+	}
+	shePrecomputedPublicKeyDestroy(ppub);
+}
+
 template<class PK, class encWithZkpFunc, class verifyFunc>
 void ZkpEqTest(const sheSecretKey *sec, const PK *pub, encWithZkpFunc encWithZkp, verifyFunc verify)
 {
@@ -635,6 +890,16 @@ CYBOZU_TEST_AUTO(finalExp)
 	sheFinalExpGT(&ct, &ct);
 	CYBOZU_TEST_EQUAL(sheDecGT(&dec, &sec, &ct), 0);
 	CYBOZU_TEST_EQUAL(dec, (m11 * m21) + (m12 * m22));
+
+	// sheMulVec = sum of sheMul
+	const sheCipherTextG1 c1[] = { c11, c12 };
+	const sheCipherTextG2 c2[] = { c21, c22 };
+	CYBOZU_TEST_EQUAL(sheMulVec(&ct, c1, c2, 2), 0);
+	CYBOZU_TEST_EQUAL(sheDecGT(&dec, &sec, &ct), 0);
+	CYBOZU_TEST_EQUAL(dec, (m11 * m21) + (m12 * m22));
+	CYBOZU_TEST_EQUAL(sheMulVecMT(&ct, c1, c2, 2, 0), 0);
+	CYBOZU_TEST_EQUAL(sheDecGT(&dec, &sec, &ct), 0);
+	CYBOZU_TEST_EQUAL(dec, (m11 * m21) + (m12 * m22));
 }
 
 int g_hashBitSize = 8;
@@ -386,6 +386,67 @@ CYBOZU_TEST_AUTO(normalizeVec)
 	}
 }
 
+template<class CT, class PK>
+void encEach(const PK& pub, CT *c, const int64_t *m, size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		pub.enc(c[i], m[i]);
+	}
+}
+
+template<class CT, class PK>
+void encVecTest(const SecretKey& sec, const PK& pub, const int64_t *m, size_t n)
+{
+	std::vector<CT> c(n);
+	pub.encVec(c.data(), m, n);
+	for (size_t i = 0; i < n; i++) {
+		CYBOZU_TEST_EQUAL(sec.dec(c[i]), m[i]);
+	}
+	pub.encVecMT(c.data(), m, n);
+	for (size_t i = 0; i < n; i++) {
+		CYBOZU_TEST_EQUAL(sec.dec(c[i]), m[i]);
+	}
+}
+
+CYBOZU_TEST_AUTO(encVec)
+{
+	const SecretKey& sec = g_sec;
+	PublicKey pub;
+	sec.getPublicKey(pub);
+	PrecomputedPublicKey ppub;
+	ppub.init(pub);
+	const size_t N = 150;
+	int64_t m[N];
+	for (size_t i = 0; i < N; i++) {
+		m[i] = int64_t(i * 7 % 23) - 11;
+	}
+	const size_t tbl[] = { 0, 1, 5, 33, N };
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(tbl); i++) {
+		const size_t n = tbl[i];
+		encVecTest<CipherTextG1>(sec, pub, m, n);
+		encVecTest<CipherTextG2>(sec, pub, m, n);
+		encVecTest<CipherTextGT>(sec, pub, m, n);
+		encVecTest<CipherTextG1>(sec, ppub, m, n);
+		encVecTest<CipherTextG2>(sec, ppub, m, n);
+		encVecTest<CipherTextGT>(sec, ppub, m, n);
+	}
+	CipherTextG1 c1[N];
+	pub.encVec(c1, m, N);
+	for (size_t i = 0; i < N; i++) {
+		CYBOZU_TEST_ASSERT(c1[i].getS().z.isOne());
+		CYBOZU_TEST_ASSERT(c1[i].getT().z.isOne());
+	}
+#ifdef NDEBUG
+	const int C = 3;
+	CipherTextG1 c1s[N];
+	CipherTextGT cts[N];
+	CYBOZU_BENCH_C("encG1 each", C, encEach, pub, c1s, m, N);
+	CYBOZU_BENCH_C("encG1Vec  ", C, pub.encVec, c1s, m, N);
+	CYBOZU_BENCH_C("encGT each", C, encEach, pub, cts, m, N);
+	CYBOZU_BENCH_C("encGTVec  ", C, pub.encVec, cts, m, N);
+#endif
+}
+
 template<class CT, class PK>
 void ZkpBinTest(const SecretKey& sec, const PK& pub)
 {
@@ -470,6 +531,105 @@ CYBOZU_TEST_AUTO(ZkpBinEq)
 	ZkpBinEqTest(sec, ppub);
 }
 
+template<class PK>
+bool verifyEach(const PK& pub, const CipherTextG1 *c1, const CipherTextG2 *c2, const ZkpBinEq *zkp, size_t n)
+{
+	bool ok = true;
+	for (size_t i = 0; i < n; i++) {
+		ok &= pub.verify(c1[i], c2[i], zkp[i]);
+	}
+	return ok;
+}
+
+template<class PK>
+void verifyVecTest(const PK& pub, size_t n)
+{
+	std::vector<CipherTextG1> c1(n);
+	std::vector<CipherTextG2> c2(n);
+	std::vector<ZkpBin> zkpBin1(n), zkpBin2(n);
+	std::vector<ZkpEq> zkpEq(n);
+	std::vector<ZkpBinEq> zkpBinEq(n);
+	const int mVec[] = { -3, 0, 5 };
+	const size_t mSize = CYBOZU_NUM_OF_ARRAY(mVec);
+	std::vector<CipherTextG1> cs(n);
+	std::vector<Fr> zkpSet(n * mSize * 2 + 1);
+	std::vector<CipherTextG1> c3(n);
+	std::vector<CipherTextG2> c4(n);
+	for (size_t i = 0; i < n; i++) {
+		const int m = int(i % 2);
+		pub.encWithZkpBin(c1[i], zkpBin1[i], m);
+		pub.encWithZkpBin(c2[i], zkpBin2[i], m);
+		pub.encWithZkpEq(c3[i], c4[i], zkpEq[i], int(i) - 5);
+		pub.encWithZkpSet(cs[i], &zkpSet[i * mSize * 2], mVec[i % mSize], mVec, mSize);
+	}
+	std::vector<CipherTextG1> c5(n);
+	std::vector<CipherTextG2> c6(n);
+	for (size_t i = 0; i < n; i++) {
+		pub.encWithZkpBinEq(c5[i], c6[i], zkpBinEq[i], int(i % 2));
+	}
+	const size_t badN = n / 3; // break the badN-th proof if n > 0
+	for (int mode = 0; mode < 2; mode++) {
+		if (mode == 1 && n > 0) {
+			zkpBin1[badN].d_[0] += 1;
+			zkpBin2[badN].d_[0] += 1;
+			zkpEq[badN].d_[0] += 1;
+			zkpBinEq[badN].d_[0] += 1;
+			zkpSet[badN * mSize * 2] += 1;
+		}
+		const bool expect = mode == 0 || n == 0;
+		bool okVec[256];
+		CYBOZU_TEST_EQUAL(pub.verifyVec(c1.data(), zkpBin1.data(), n, okVec), expect);
+		for (size_t i = 0; i < n; i++) {
+			CYBOZU_TEST_EQUAL(okVec[i], pub.verify(c1[i], zkpBin1[i]));
+		}
+		CYBOZU_TEST_EQUAL(pub.verifyVecMT(c1.data(), zkpBin1.data(), n), expect);
+		CYBOZU_TEST_EQUAL(pub.verifyVec(c2.data(), zkpBin2.data(), n, okVec), expect);
+		for (size_t i = 0; i < n; i++) {
+			CYBOZU_TEST_EQUAL(okVec[i], pub.verify(c2[i], zkpBin2[i]));
+		}
+		CYBOZU_TEST_EQUAL(pub.verifyVecMT(c2.data(), zkpBin2.data(), n), expect);
+		CYBOZU_TEST_EQUAL(pub.verifyVec(cs.data(), zkpSet.data(), mVec, mSize, n, okVec), expect);
+		for (size_t i = 0; i < n; i++) {
+			CYBOZU_TEST_EQUAL(okVec[i], pub.verify(cs[i], &zkpSet[i * mSize * 2], mVec, mSize));
+		}
+		CYBOZU_TEST_EQUAL(pub.verifyVecMT(cs.data(), zkpSet.data(), mVec, mSize, n), expect);
+		CYBOZU_TEST_EQUAL(pub.verifyVec(c3.data(), c4.data(), zkpEq.data(), n, okVec), expect);
+		for (size_t i = 0; i < n; i++) {
+			CYBOZU_TEST_EQUAL(okVec[i], pub.verify(c3[i], c4[i], zkpEq[i]));
+		}
+		CYBOZU_TEST_EQUAL(pub.verifyVecMT(c3.data(), c4.data(), zkpEq.data(), n), expect);
+		CYBOZU_TEST_EQUAL(pub.verifyVec(c5.data(), c6.data(), zkpBinEq.data(), n, okVec), expect);
+		for (size_t i = 0; i < n; i++) {
+			CYBOZU_TEST_EQUAL(okVec[i], pub.verify(c5[i], c6[i], zkpBinEq[i]));
+		}
+		CYBOZU_TEST_EQUAL(pub.verifyVecMT(c5.data(), c6.data(), zkpBinEq.data(), n), expect);
+	}
+	if (n > 0) {
+		const int badVec[] = { 0, 0 };
+		CYBOZU_TEST_ASSERT(!pub.verifyVec(cs.data(), zkpSet.data(), badVec, 2, n));
+	}
+#ifdef NDEBUG
+	if (n < 100) return;
+	const int C = 3;
+	CYBOZU_BENCH_C("ZkpBinEq each", C, verifyEach<PK>, pub, c5.data(), c6.data(), zkpBinEq.data(), n);
+	CYBOZU_BENCH_C("ZkpBinEq Vec ", C, pub.verifyVec, c5.data(), c6.data(), zkpBinEq.data(), n, 0);
+#endif
+}
+
+CYBOZU_TEST_AUTO(verifyVec)
+{
+	const SecretKey& sec = g_sec;
+	PublicKey pub;
+	sec.getPublicKey(pub);
+	PrecomputedPublicKey ppub;
+	ppub.init(pub);
+	const size_t tbl[] = { 0, 1, 7, 150 };
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(tbl); i++) {
+		verifyVecTest(pub, tbl[i]);
+		verifyVecTest(ppub, tbl[i]);
+	}
+}
+
 CYBOZU_TEST_AUTO(ZkpDecG1)
 {
 	const SecretKey& sec = g_sec;
@@ -666,6 +826,254 @@ CYBOZU_TEST_AUTO(innerProduct)
 	CYBOZU_TEST_EQUAL(innerProduct, sec.dec(c));
 }
 
+void mulEach(CipherTextGT& z, const CipherTextG1 *x, const CipherTextG2 *y, size_t n)
+{
+	CipherTextGT t;
+	z.clear();
+	for (size_t i = 0; i < n; i++) {
+		CipherTextGT::mul(t, x[i], y[i]);
+		z.add(t);
+	}
+}
+
+CYBOZU_TEST_AUTO(mulVec)
+{
+	const SecretKey& sec = g_sec;
+	PublicKey pub;
+	sec.getPublicKey(pub);
+	const size_t N = 300;
+	int64_t m1[N], m2[N];
+	for (size_t i = 0; i < N; i++) {
+		m1[i] = int64_t(i % 7) - 3;
+		m2[i] = int64_t(i % 5) - 2;
+	}
+	std::vector<CipherTextG1> c1(N);
+	std::vector<CipherTextG2> c2(N);
+	pub.encVec(c1.data(), m1, N);
+	pub.encVec(c2.data(), m2, N);
+	c1[1].clear(); // Enc(0) with zero points
+	m1[1] = 0;
+	const size_t tbl[] = { 0, 1, 3, 130, N };
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(tbl); i++) {
+		const size_t n = tbl[i];
+		int64_t ip = 0;
+		for (size_t j = 0; j < n; j++) {
+			ip += m1[j] * m2[j];
+		}
+		CipherTextGT z1, z2;
+		CipherTextGT::mulVec(z1, c1.data(), c2.data(), n);
+		CYBOZU_TEST_EQUAL(sec.dec(z1), ip);
+		mulEach(z2, c1.data(), c2.data(), n);
+		CYBOZU_TEST_EQUAL(z1, z2);
+		CipherTextGT::mulVecMT(z1, c1.data(), c2.data(), n);
+		CYBOZU_TEST_EQUAL(z1, z2);
+		CipherTextGT::mulVecMT(z1, c1.data(), c2.data(), n, 3);
+		CYBOZU_TEST_EQUAL(z1, z2);
+	}
+#ifdef NDEBUG
+	const int C = 1;
+	CipherTextGT z;
+	CYBOZU_BENCH_C("mul each", C, mulEach, z, c1.data(), c2.data(), N);
+	CYBOZU_BENCH_C("mulVec  ", C, CipherTextGT::mulVec, z, c1.data(), c2.data(), N);
+#endif
+}
+
+template<class CT>
+void addEach(CT *z, const CT *x, const CT *y, size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		CT::add(z[i], x[i], y[i]);
+	}
+}
+
+template<class CT>
+void sumEach(CT& z, const CT *x, size_t n)
+{
+	z.clear();
+	for (size_t i = 0; i < n; i++) {
+		z.add(x[i]);
+	}
+}
+
+template<class CT>
+void addSumVecTest(const SecretKey& sec, const PublicKey& pub, size_t N)
+{
+	std::vector<int64_t> m(N);
+	for (size_t i = 0; i < N; i++) {
+		m[i] = int64_t(i % 9) - 4;
+	}
+	std::vector<CT> x(N), y(N), z1(N), z2(N);
+	pub.encVec(x.data(), m.data(), N);
+	// Enc(0) with zero points, same points and non-normalized points
+	x[1].clear();
+	m[1] = 0;
+	x[2] = x[3];
+	m[2] = m[3];
+	pub.enc(x[4], m[4]);
+	for (size_t i = 0; i < N; i++) {
+		y[i] = x[N - 1 - i];
+	}
+	y[5] = x[5]; // x + x
+	CT::neg(y[6], x[6]); // x + (-x)
+	y[7].clear();
+	addEach(z2.data(), x.data(), y.data(), N);
+	CT::addVec(z1.data(), x.data(), y.data(), N);
+	CYBOZU_TEST_ASSERT(z1 == z2);
+	for (size_t i = 0; i < 8; i++) {
+		CYBOZU_TEST_EQUAL(sec.dec(z1[i]), sec.dec(x[i]) + sec.dec(y[i]));
+	}
+	CT::addVecMT(z1.data(), x.data(), y.data(), N, 3);
+	CYBOZU_TEST_ASSERT(z1 == z2);
+	z1 = x;
+	CT::addVec(z1.data(), z1.data(), y.data(), N);
+	CYBOZU_TEST_ASSERT(z1 == z2);
+
+	const size_t tbl[] = { 0, 1, 2, 3, 9, N };
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(tbl); i++) {
+		const size_t n = tbl[i];
+		int64_t s = 0;
+		for (size_t j = 0; j < n; j++) {
+			s += m[j];
+		}
+		CT c1, c2;
+		CT::sumVec(c1, x.data(), n);
+		CYBOZU_TEST_EQUAL(sec.dec(c1), s);
+		sumEach(c2, x.data(), n);
+		CYBOZU_TEST_EQUAL(c1, c2);
+		CT::sumVecMT(c1, x.data(), n);
+		CYBOZU_TEST_EQUAL(c1, c2);
+		CT::sumVecMT(c1, x.data(), n, 3);
+		CYBOZU_TEST_EQUAL(c1, c2);
+	}
+	// all the same points and the sum of zero
+	std::vector<CT> v(N, x[0]);
+	CT c, d;
+	CT::sumVec(c, v.data(), N);
+	CT::mul(d, x[0], int64_t(N));
+	CYBOZU_TEST_EQUAL(c, d);
+	for (size_t i = 0; i < N / 2; i++) {
+		CT::neg(v[N - 1 - i], x[i]);
+		v[i] = x[i];
+	}
+	CT::sumVecMT(c, v.data(), N & ~size_t(1), 3);
+	CYBOZU_TEST_ASSERT(sec.isZero(c));
+#ifdef NDEBUG
+	const int C = 10;
+	CYBOZU_BENCH_C("sum each", C, sumEach<CT>, c, x.data(), N);
+	CYBOZU_BENCH_C("sumVec  ", C, CT::sumVec, c, x.data(), N);
+#endif
+}
+
+CYBOZU_TEST_AUTO(addSumVec)
+{
+	const SecretKey& sec = g_sec;
+	PublicKey pub;
+	sec.getPublicKey(pub);
+	addSumVecTest<CipherTextG1>(sec, pub, 2100);
+	addSumVecTest<CipherTextG2>(sec, pub, 2100);
+	addSumVecTest<CipherTextGT>(sec, pub, 300);
+}
+
+template<class CT>
+void reRandEach(const PublicKey& pub, CT *c, size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		pub.reRand(c[i]);
+	}
+}
+
+template<class CT>
+void convertEach(const PublicKey& pub, CipherTextGT *ct, const CT *c, size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		pub.convert(ct[i], c[i]);
+	}
+}
+
+template<class PK, class CT>
+void reRandVecTest(const SecretKey& sec, const PK& pub, size_t n)
+{
+	std::vector<int64_t> m(n);
+	for (size_t i = 0; i < n; i++) {
+		m[i] = int64_t(i % 11) - 5;
+	}
+	std::vector<CT> c(n), d;
+	pub.encVec(c.data(), m.data(), n);
+	if (n > 1) c[1].clear();
+	if (n > 1) m[1] = 0;
+	d = c;
+	pub.reRandVec(d.data(), n);
+	for (size_t i = 0; i < n; i++) {
+		CYBOZU_TEST_EQUAL(sec.dec(d[i]), m[i]);
+		CYBOZU_TEST_ASSERT(d[i] != c[i]);
+	}
+	d = c;
+	pub.reRandVecMT(d.data(), n, 3);
+	for (size_t i = 0; i < n; i++) {
+		CYBOZU_TEST_EQUAL(sec.dec(d[i]), m[i]);
+		CYBOZU_TEST_ASSERT(d[i] != c[i]);
+	}
+}
+
+template<class CT>
+void convertVecTest(const SecretKey& sec, const PublicKey& pub, size_t n)
+{
+	std::vector<int64_t> m(n);
+	for (size_t i = 0; i < n; i++) {
+		m[i] = int64_t(i % 11) - 5;
+	}
+	std::vector<CT> c(n);
+	pub.encVec(c.data(), m.data(), n);
+	if (n > 1) c[1].clear();
+	if (n > 2) pub.enc(c[2], m[2]); // not normalized
+	std::vector<CipherTextGT> ct1(n), ct2(n);
+	pub.convertVec(ct1.data(), c.data(), n);
+	for (size_t i = 0; i < n; i++) {
+		pub.convert(ct2[i], c[i]);
+		CYBOZU_TEST_EQUAL(ct1[i], ct2[i]);
+		CYBOZU_TEST_EQUAL(sec.dec(ct1[i]), sec.dec(c[i]));
+	}
+	pub.convertVecMT(ct1.data(), c.data(), n, 3);
+	CYBOZU_TEST_ASSERT(ct1 == ct2);
+}
+
+CYBOZU_TEST_AUTO(reRandConvertVec)
+{
+	const SecretKey& sec = g_sec;
+	PublicKey pub;
+	sec.getPublicKey(pub);
+	PrecomputedPublicKey ppub;
+	ppub.init(pub);
+	const size_t tbl[] = { 0, 1, 9, 130 };
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(tbl); i++) {
+		const size_t n = tbl[i];
+		reRandVecTest<PublicKey, CipherTextG1>(sec, pub, n);
+		reRandVecTest<PublicKey, CipherTextG2>(sec, pub, n);
+		reRandVecTest<PrecomputedPublicKey, CipherTextG1>(sec, ppub, n);
+		reRandVecTest<PrecomputedPublicKey, CipherTextG2>(sec, ppub, n);
+		convertVecTest<CipherTextG1>(sec, pub, n);
+		convertVecTest<CipherTextG2>(sec, pub, n);
+	}
+	reRandVecTest<PublicKey, CipherTextGT>(sec, pub, 9);
+	reRandVecTest<PrecomputedPublicKey, CipherTextGT>(sec, ppub, 9);
+#ifdef NDEBUG
+	const size_t N = 300;
+	const int C = 3;
+	std::vector<int64_t> m(N, 1);
+	std::vector<CipherTextG1> c1(N);
+	std::vector<CipherTextG2> c2(N);
+	std::vector<CipherTextGT> ct(N);
+	pub.encVec(c1.data(), m.data(), N);
+	pub.encVec(c2.data(), m.data(), N);
+	CYBOZU_BENCH_C("reRandG1 each", C, reRandEach, pub, c1.data(), N);
+	CYBOZU_BENCH_C("reRandG1Vec  ", C, pub.reRandVec, c1.data(), N);
+	CYBOZU_BENCH_C("reRandG2 each", C, reRandEach, pub, c2.data(), N);
+	CYBOZU_BENCH_C("reRandG2Vec  ", C, pub.reRandVec, c2.data(), N);
+	CYBOZU_BENCH_C("convG1 each  ", C, convertEach, pub, ct.data(), c1.data(), N);
+	CYBOZU_BENCH_C("convertG1Vec ", C, pub.convertVec, ct.data(), c1.data(), N);
+#endif
+}
+
 template<class T>
 T testIo(const T& x)
 {
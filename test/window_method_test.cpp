@@ -2,6 +2,7 @@
 #include <mcl/window_method.hpp>
 #include <mcl/ecparam.hpp>
 #include <mcl/g1_def.hpp>
+#include <vector>
 
 using namespace mcl;
 typedef G1 Ec;
@@ -51,3 +52,111 @@ CYBOZU_TEST_AUTO(int)
 	Ec::mul(R, P, r);
 	CYBOZU_TEST_EQUAL(Q, R);
 }
+
+CYBOZU_TEST_AUTO(signed)
+{
+	const struct mcl::EcParam& para = mcl::ecparam::secp192k1;
+	Fp::init(para.p);
+	Fr::init(para.n);
+	Ec::init(para.a, para.b);
+	const Fp x(para.gx);
+	const Fp y(para.gy);
+	const Ec P(x, y);
+
+	typedef mcl::fp::SignedWindowMethod<Ec> PW;
+	const size_t bitSize = 13;
+	Ec Q, R;
+
+	for (size_t winSize = 2; winSize <= bitSize + 1; winSize++) {
+		PW pw(P, bitSize, winSize);
+		for (int i = -(1 << bitSize) + 1; i < (1 << bitSize); i++) {
+			pw.mul(Q, i);
+			Ec::mul(R, P, i);
+			CYBOZU_TEST_EQUAL(Q, R);
+		}
+	}
+	for (size_t winSize = 4; winSize <= 10; winSize++) {
+		PW pw(P, para.bitSize, winSize);
+		Fr r;
+		// all ones in windows make carries
+		r = -1;
+		pw.mul(Q, r);
+		Ec::mul(R, P, r);
+		CYBOZU_TEST_EQUAL(Q, R);
+		for (int i = 0; i < 10; i++) {
+			r.setByCSPRNG();
+			pw.mul(Q, r);
+			Ec::mul(R, P, r);
+			CYBOZU_TEST_EQUAL(Q, R);
+			mpz_class t = -r.getMpz();
+			pw.mul(Q, t);
+			Ec::mul(R, P, t);
+			CYBOZU_TEST_EQUAL(Q, R);
+		}
+	}
+	// serialize
+	PW pw(P, para.bitSize, 6);
+	std::vector<uint8_t> buf(pw.tbl_.size() * sizeof(Fp) * 2 + 100);
+	size_t n = pw.serialize(&buf[0], buf.size());
+	CYBOZU_TEST_ASSERT(n > 0);
+	CYBOZU_TEST_EQUAL(pw.serialize(&buf[0], n - 1), 0);
+	PW pw2;
+	CYBOZU_TEST_EQUAL(pw2.deserialize(&buf[0], n, true), n);
+	CYBOZU_TEST_EQUAL(pw2.bitSize_, pw.bitSize_);
+	CYBOZU_TEST_EQUAL(pw2.winSize_, pw.winSize_);
+	Fr r;
+	r.setByCSPRNG();
+	pw.mul(Q, r);
+	pw2.mul(R, r);
+	CYBOZU_TEST_EQUAL(Q, R);
+	CYBOZU_TEST_EQUAL(pw2.deserialize(&buf[0], n - 1), 0);
+	buf[4]++; // winSize
+	CYBOZU_TEST_EQUAL(pw2.deserialize(&buf[0], n), 0);
+}
+
+CYBOZU_TEST_AUTO(signedCT)
+{
+	const struct mcl::EcParam& para = mcl::ecparam::secp192k1;
+	Fp::init(para.p);
+	Fr::init(para.n);
+	const Fp x(para.gx);
+	const Fp y(para.gy);
+
+	typedef mcl::fp::SignedWindowMethod<Ec> PW;
+	const int modeTbl[] = { mcl::ec::Jacobi, mcl::ec::Proj };
+	for (size_t m = 0; m < CYBOZU_NUM_OF_ARRAY(modeTbl); m++) {
+		Ec::init(para.a, para.b, modeTbl[m]);
+		const Ec P(x, y);
+		Ec Q, R;
+		for (size_t winSize = 2; winSize <= 7; winSize++) {
+			PW pw(P, para.bitSize, winSize);
+			for (int i = 0; i < 300; i++) {
+				pw.mulCT(Q, Fr(i));
+				Ec::mul(R, P, i);
+				CYBOZU_TEST_EQUAL(Q, R);
+			}
+			Fr r = -1;
+			pw.mulCT(Q, r);
+			Ec::mul(R, P, r);
+			CYBOZU_TEST_EQUAL(Q, R);
+			for (int i = 0; i < 30; i++) {
+				r.setByCSPRNG();
+				pw.mulCT(Q, r);
+				Ec::mul(R, P, r);
+				CYBOZU_TEST_EQUAL(Q, R);
+			}
+			// zero windows, also made by the carry of a negative digit
+			const mpz_class mask = (mpz_class(1) << winSize) - 1;
+			const mpz_class h = mpz_class(1) << (winSize - 1);
+			const mpz_class digitTbl[] = { 0, 1, 0, 0, mask, 0, h, h + 1, mask, mask - 1, 0 };
+			mpz_class v = 0;
+			for (size_t i = 0; (i + 1) * winSize < para.bitSize; i++) {
+				v = (v << winSize) + digitTbl[i % CYBOZU_NUM_OF_ARRAY(digitTbl)];
+				r.setMpz(v);
+				pw.mulCT(Q, r);
+				Ec::mul(R, P, v);
+				CYBOZU_TEST_EQUAL(Q, R);
+			}
+		}
+	}
+}